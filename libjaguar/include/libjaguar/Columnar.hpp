@@ -0,0 +1,118 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Index.hpp"
+#include "Reader.hpp"
+#include "StructuredTypeLayout.hpp"
+#include "TypeTags.hpp"
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief A single field of a list of structured objects, decoded into contiguous storage
+	 *
+	 * Fixed-size fields (numbers, booleans, vectors, and matrices) are stored back-to-back in @c data, one element every @c stride bytes, in native byte order.
+	 * Variable-size fields (strings and byte buffers) store their bytes back-to-back in @c data, with element @c i occupying the range <tt>[offsets[i], offsets[i + 1])</tt>.
+	 */
+	struct LJAPI Column {
+		std::string name;			   ///<Name of the field this column was decoded from
+		TypeTag type;				   ///<Type of the field
+		TypeTag elementType;		   ///<Type of contained elements (for vectors and matrices)
+		uint8_t width;				   ///<Number of components in a vector or columns in a matrix
+		uint8_t height;				   ///<Number of rows in a matrix
+		uint32_t stride;			   ///<Size in bytes of one element of a fixed-size column, or 0 for a variable-size column
+		std::vector<unsigned char> data;///<Element data
+		std::vector<uint64_t> offsets; ///<Element boundaries for a variable-size column (one more than the number of rows), empty otherwise
+
+		/**
+		 * @brief Check if the column stores variable-size elements
+		 *
+		 * @return @c true for string and byte buffer columns
+		 */
+		bool IsVariableSize() const {
+			return stride == 0;
+		}
+
+		/**
+		 * @brief Access a fixed-size column as a typed span
+		 *
+		 * @tparam T The element type, which must have the same size as the column's elements (e.g. @c float for a Float32 column, or <tt>Vector<float, 3></tt> for a vector column)
+		 *
+		 * @return The column values
+		 *
+		 * @throws std::runtime_error If the column is variable-size or @c T does not match the element size
+		 */
+		template<typename T>
+		std::span<const T> Values() const {
+			if(IsVariableSize() || sizeof(T) != stride) throw std::runtime_error("Column element type does not match the requested type!");
+			return std::span<const T>(reinterpret_cast<const T*>(data.data()), data.size() / stride);
+		}
+
+		/**
+		 * @brief Access an element of a variable-size column
+		 *
+		 * @param row The row to access
+		 *
+		 * @return A view of the element bytes (a UTF-8 string for string columns)
+		 *
+		 * @throws std::runtime_error If the column is fixed-size or the row is out of bounds
+		 */
+		std::string_view StringAt(std::size_t row) const {
+			if(!IsVariableSize()) throw std::runtime_error("Cannot access a fixed-size column as strings!");
+			if(row + 1 >= offsets.size()) throw std::runtime_error("Out of bounds column access");
+			return std::string_view(reinterpret_cast<const char*>(data.data()) + offsets[row], offsets[row + 1] - offsets[row]);
+		}
+	};
+
+	/**
+	 * @brief The full set of columns decoded from a list of structured objects
+	 */
+	struct LJAPI ColumnSet {
+		uint32_t rowCount;			///<Number of list elements decoded
+		std::vector<Column> columns;///<Decoded columns, in the same order as the fields of the type layout (fields that cannot be stored as a column are omitted)
+
+		/**
+		 * @brief Find a column by field name
+		 *
+		 * @param name The field name
+		 *
+		 * @return The column
+		 *
+		 * @throws std::runtime_error If no column exists for that field
+		 */
+		const Column& operator[](std::string_view name) const {
+			for(const Column& column : columns) {
+				if(column.name == name) return column;
+			}
+			throw std::runtime_error("No column exists for the requested field!");
+		}
+	};
+
+	/**
+	 * @brief Decode a list of structured objects directly into one column per field
+	 *
+	 * The list is read once, in batches of elements: the element boundaries of a batch are found as it is read, after which it is split into chunks that are decoded in
+	 * parallel. Only the current batch is kept in memory besides the columns.
+	 * Number, boolean, vector, matrix, string, and byte buffer fields become columns; fields of any other type are skipped.
+	 *
+	 * @param reader The reader for the stream containing the list (must be seekable and have no active ScopedView)
+	 * @param list The index entry of the list, as produced by the Decoder
+	 * @param layout The type layout of the list elements
+	 * @param threadCount The maximum number of threads to decode with, or 0 to use the hardware concurrency
+	 *
+	 * @return The decoded columns
+	 *
+	 * @note When this function returns, the stream is positioned at the end of the list.
+	 *
+	 * @throws std::runtime_error If the entry does not describe a list of structured objects with the layout's type ID
+	 * @throws std::runtime_error If an element does not conform to the type layout
+	 * @throws std::runtime_error If any errors occur while reading (see Reader)
+	 */
+	LJAPI ColumnSet DecodeColumns(Reader& reader, const ValueEntry& list, const StructuredTypeLayout& layout, unsigned int threadCount = 0);
+}
\ No newline at end of file
@@ -3,11 +3,49 @@
 #include "DllHelper.hpp"
 #include "Index.hpp"
 #include "Reader.hpp"
+#include "TypeRegistry.hpp"
+#include "ValueHeader.hpp"
 #include "libjaguar/Index.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace libjaguar {
+	class SpillStreambuf;
+
+	/**
+	 * @brief Limits on the work a Decoder does for a stream, for streams from untrusted sources
+	 *
+	 * Exceeding a limit makes parsing fail with a @c std::runtime_error, as soon as the offending header has been read. The defaults impose no limits beyond those of
+	 * the format.
+	 */
+	struct LJAPI DecodeLimits {
+		uint64_t maxEntries = UINT64_MAX;		   ///<Most value and scope entries the index may hold
+		uint64_t maxMaterializedBytes = UINT64_MAX;///<Most bytes of materialized values the index may hold
+		uint32_t maxStringSize = 0xFFFFFF;		   ///<Largest string value accepted, in bytes
+		bool checkRemainingInput = false;		   ///<Reject values whose size, list count, or field count cannot fit in the rest of the stream (requires a seekable stream that is not growing anymore)
+		std::chrono::milliseconds maxParseTime{0}; ///<Longest a single Parse() or ParseAvailable() call may take, or 0 for no limit (checked every few hundred entries)
+		bool spillIndex = false;				   ///<Move the index to a temporary file in chunks when it reaches maxEntries or maxMaterializedBytes, rather than failing (see Decoder::LoadSpilledChunk)
+	};
+
+	/**
+	 * @brief Settings for a Decoder
+	 */
+	struct LJAPI DecodeOptions {
+		bool materialize = false;						 ///<Whether to copy small value bodies into the index while parsing (see Index::values)
+		uint32_t maxMaterializedSize = 256;				 ///<Size limit for materialized strings and byte buffers, in bytes (numbers, booleans, vectors, and matrices are always materialized)
+		std::shared_ptr<const TypeRegistry> typeRegistry;///<Shared layouts that matching declarations refer to instead of being copied into the index (see TypeRegistry)
+		uint32_t listCheckpointInterval = 0;			 ///<Record the position of every n-th element of lists of strings, objects, or lists with more than n elements, or 0 to record none (see Index::FindListCheckpoint)
+		DecodeLimits limits;							 ///<Limits for untrusted streams
+	};
+
 	/**
 	 * @brief Stateful Jaguar stream interpreter and index builder
 	 *
@@ -17,6 +55,25 @@ namespace libjaguar {
 	 * @warning Because this class owns the Reader (and thus the stream), <b>do not let RAII destroy it</b> if you want to continue using the stream.
 	 * Be sure to call @c ReleaseReader first to get the Reader back.
 	 *
+	 * The index is allocated from a memory resource chosen at construction. A @c std::pmr::monotonic_buffer_resource makes building a short-lived index a matter of
+	 * bumping a pointer (and freeing it all at once), while a @c std::pmr::unsynchronized_pool_resource or @c std::pmr::synchronized_pool_resource suits an index that
+	 * is kept around and grown with ParseAvailable().
+	 *
+	 * With materialization enabled (see DecodeOptions), the bodies of all numbers, booleans, vectors, and matrices, as well as strings and byte buffers up to a size
+	 * limit, are copied into one compact buffer in the index as they are parsed. Each entry refers to its body by offset, so these values can then be read from the
+	 * index (see Index::Get) any number of times without seeking or reading. Lists, substreams, and larger buffers are still only indexed by position.
+	 *
+	 * Given a TypeRegistry (see DecodeOptions), type declarations that match a registered layout exactly are not copied into Index::types; the index refers to the
+	 * shared layout instead (see Index::sharedTypes and Index::FindType). Declarations that differ from the registry are stored in the index as usual.
+	 *
+	 * Reaching an element of a list of strings, objects, or lists means walking every element before it. With a list checkpoint interval n (see DecodeOptions), the
+	 * decoder walks such lists while parsing anyway and records the position of every n-th element, so that a ListView created with the index can jump to any
+	 * element by seeking to the closest checkpoint and skipping fewer than n elements (see Index::FindListCheckpoint).
+	 *
+	 * The work done for a stream can be bounded with DecodeLimits, so that a hostile stream fails early instead of growing the index or the parse time without bound.
+	 * With @c spillIndex set, reaching the entry or materialized byte limit moves all complete root-level entries of the index to a temporary file as one chunk,
+	 * which LoadSpilledChunk() reads back on demand; only a single root-level value that exceeds a limit on its own still fails.
+	 *
 	 * <b>This class is move-only!</b>
 	 */
 	class LJAPI Decoder {
@@ -25,8 +82,12 @@ namespace libjaguar {
 		 * @brief Create a decoder that will own and maintain a Reader
 		 *
 		 * @param reader The reader to use
+		 * @param resource The memory resource to allocate the index from (must outlive the index, including copies of it that use the same resource)
+		 * @param options Decoding settings
 		 */
-		explicit Decoder(Reader&& reader);
+		explicit Decoder(Reader&& reader, std::pmr::memory_resource* resource = std::pmr::get_default_resource(), const DecodeOptions& options = {});
+
+		~Decoder();
 
 		///@cond
 		Decoder(const Decoder&) = delete;
@@ -49,6 +110,26 @@ namespace libjaguar {
 		 */
 		Reader&& ReleaseReader() &&;
 
+		/**
+		 * @brief Start over with a new stream, as if the decoder had just been created for it
+		 *
+		 * The index is cleared rather than freed, so the capacity of its root scope, materialized values, and type table carries over to the next stream. The
+		 * settings and memory resource stay the same. References into the previous index become invalid.
+		 *
+		 * @param reader The reader for the new stream
+		 */
+		void Reset(Reader&& reader);
+
+		/**
+		 * @brief Start over with a new stream in memory, reusing the decoder's reader (see Reader::Reset)
+		 *
+		 * With the reader and the index both reused, decoding one small message after another with the same decoder only allocates for nested scopes and long
+		 * names, once the decoder has warmed up. See also DecoderPool.
+		 *
+		 * @param data The Jaguar data (must outlive the decoder's use of it)
+		 */
+		void Reset(std::span<const unsigned char> data);
+
 		/**
 		 * @brief Access the stream structure index
 		 *
@@ -65,11 +146,60 @@ namespace libjaguar {
 		/**
 		 * @brief Parse the Jaguar stream structure until EOF is reached or the decoder encounters invalid data
 		 *
-		 * @throws std::runtime_error If parsing errors occurred --- this will invalidate the decoder
-		 * @throws std::runtime_error If the stream has already been parsed
+		 * Parsing starts from the checkpoint, so this may also be called again after the stream has grown to index the new values.
+		 *
+		 * @throws std::runtime_error If parsing errors occurred (including a partial value at the end of the stream) --- this will invalidate the decoder
 		 */
 		void Parse();
 
+		/**
+		 * @brief Parse the complete root-level values that follow the checkpoint, for streams that are still being appended to
+		 *
+		 * Parsing stops at EOF. If the stream ends partway through a value, that value is left for a later call: the stream state is cleared and it is rewound to the
+		 * checkpoint (the end of the last complete root-level value). The call can then simply be repeated once more data is available (on a timer or a file change
+		 * notification, for example). Values already in the index are never parsed again.
+		 *
+		 * @return The number of root-level values (including type declarations) added to the index by this call
+		 *
+		 * @throws std::runtime_error If parsing errors occurred --- this will invalidate the decoder
+		 * @throws std::runtime_error If the stream is not seekable
+		 */
+		std::size_t ParseAvailable();
+
+		/**
+		 * @brief Get the position just after the last complete root-level value that has been indexed
+		 *
+		 * @return The stream position
+		 */
+		std::streampos GetCheckpoint() const {
+			return checkpoint;
+		}
+
+		/**
+		 * @brief Get the number of index chunks that were spilled to the temporary file (see DecodeLimits::spillIndex)
+		 *
+		 * @return The chunk count
+		 */
+		std::size_t GetSpilledChunkCount() const {
+			return spilledChunks.size();
+		}
+
+		/**
+		 * @brief Read a spilled index chunk back from the temporary file
+		 *
+		 * The chunk holds the root-level entries that were in the index when it was spilled, along with their materialized values and list checkpoints. Type
+		 * declarations are not part of any chunk; they stay in the index (see GetIndex), and the loaded chunk gets a copy of all of them, so that its structured
+		 * objects and lists can be resolved with Index::FindType.
+		 *
+		 * @param chunk The chunk number, in the order the chunks were spilled
+		 * @param resource The memory resource to allocate the chunk from
+		 *
+		 * @return The chunk, as an index of its own
+		 *
+		 * @throws std::runtime_error If there is no chunk with that number or the temporary file cannot be read
+		 */
+		Index LoadSpilledChunk(std::size_t chunk, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
 		/**
 		 * @brief Check if the decoder has encountered parsing errors
 		 *
@@ -80,11 +210,42 @@ namespace libjaguar {
 		}
 
 	  private:
+		friend class DecoderPool;
+
 		Reader reader;
+		std::pmr::memory_resource* resource;
+		DecodeOptions options;
 		std::optional<Index> index;
+		std::optional<Index> spareIndex;//Cleared index from before the last reset, kept for its capacity
 		bool readerValid = true;
 		bool failFlag = false;
+		std::streampos checkpoint = 0;
+		StructuredTypeLayout declaration;//Reused for every declaration that is read
+		std::vector<bool> sharedDeclared;//Which layouts of the registry the stream has declared
+
+		//Limit tracking
+		uint64_t entryCount = 0;		 //Entries in the index (spilled ones excluded)
+		uint64_t entryBase = 0;			 //Entries that do not count towards the limit (those of complete values, when spilling)
+		std::size_t materializedBase = 0;//Materialized bytes that do not count towards the limit
+		std::streamoff streamEnd = -1;	 //Size of the stream, if the remaining input is checked
+		std::chrono::steady_clock::time_point deadline;
+		uint32_t clockCountdown = 0;//Entries until the deadline is checked next
+		std::unique_ptr<SpillStreambuf> spill;
+		std::vector<std::pair<uint64_t, uint64_t>> spilledChunks;//Position and size of each chunk in the spill file
+
+		//An object scope that is being parsed
+		struct ScopeFrame {
+			ScopeEntry* scope;
+			std::size_t expectedFieldCount;
+			uint64_t pathHash;//Index ID of the scope's path, extended by each child name
+		};
 
-		void _ParseScopeInternal(ScopeEntry&, unsigned int expectedFieldCount, std::string scopePath);
+		void _ResetInternal();
+		void _CheckDeadlineInternal();
+		void _SpillIndexInternal();
+		const StructuredTypeLayout* _FindTypeInternal(const std::pmr::string& typeID) const;
+		std::size_t _ParseRootInternal(bool allowPartial);
+		void _ParseValueInternal(ValueHeader& header);
+		bool _ParseEntryInternal(const ScopeFrame& parent, const ValueHeader& header, uint8_t depth, ScopeFrame& child);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Decoder.hpp"
+#include "DllHelper.hpp"
+
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief A pool of reusable decoders for streams in memory
+	 *
+	 * Creating a decoder for every small message allocates its reader, stream, and index each time. Decoders acquired from a pool and released when done are reset
+	 * for the next message instead (see Decoder::Reset), so they keep their stream and index capacity.
+	 *
+	 * Acquiring and releasing are thread-safe, but the usual setup is one pool per thread: ForThread() returns such a pool, so that each thread reuses its own decoders
+	 * without contention. Pooled decoders allocate their indices from the default memory resource.
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI DecoderPool {
+	  public:
+		///@cond
+		DecoderPool() = default;
+		DecoderPool(const DecoderPool&) = delete;
+		DecoderPool& operator=(const DecoderPool&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Get the pool of the calling thread
+		 *
+		 * @return The pool, which lives until the thread exits
+		 */
+		static DecoderPool& ForThread();
+
+		/**
+		 * @brief Get a decoder for a stream in memory, reusing a released one if possible
+		 *
+		 * @param data The Jaguar data (must outlive the decoder's use of it)
+		 * @param options Decoding settings
+		 *
+		 * @return The decoder, ready to parse
+		 */
+		Decoder Acquire(std::span<const unsigned char> data, const DecodeOptions& options = {});
+
+		/**
+		 * @brief Return a decoder to the pool
+		 *
+		 * References to its index (see Decoder::GetIndex) become invalid, since the decoder and the index inside it are moved into the pool. Copy anything that is
+		 * still needed out of the index first.
+		 *
+		 * @param decoder The decoder
+		 */
+		void Release(Decoder&& decoder);
+
+	  private:
+		std::mutex mutex;
+		std::vector<Decoder> released;
+	};
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "DllHelper.hpp"
+#include "TypeRegistry.hpp"
 #include "Writer.hpp"
 
+#include <memory>
+
 namespace libjaguar {
 	/**
 	 * @brief Stateful and contextual Jaguar data writer
@@ -15,8 +18,9 @@ namespace libjaguar {
 		 * @brief Create a encoder that will own and maintain a Writer
 		 *
 		 * @param writer The writer to use
+		 * @param typeRegistry The shared type layouts to declare with WriteTypeDeclarations() (optional)
 		 */
-		Encoder(Writer&& writer);
+		Encoder(Writer&& writer, std::shared_ptr<const TypeRegistry> typeRegistry = nullptr);
 
 		///@cond
 		Encoder(const Encoder&) = delete;
@@ -34,8 +38,37 @@ namespace libjaguar {
 		 */
 		Writer& GetWriter();
 
+		/**
+		 * @brief Start over with a new stream, keeping the type registry
+		 *
+		 * @param ostream The new stream into which to write Jaguar data
+		 *
+		 * @return The previous stream, or @c nullptr if the encoder had none (see Writer::Reset)
+		 */
+		std::unique_ptr<std::ostream> Reset(std::unique_ptr<std::ostream>&& ostream);
+
+		/**
+		 * @brief Get the shared type layouts of the encoder
+		 *
+		 * @return The registry, or @c nullptr if the encoder has none
+		 */
+		const std::shared_ptr<const TypeRegistry>& GetTypeRegistry() const {
+			return typeRegistry;
+		}
+
+		/**
+		 * @brief Declare all types of the registry, writing their declarations in one go
+		 *
+		 * The declarations were encoded when the registry was created, so this costs a single write no matter how many types there are.
+		 *
+		 * @throws std::runtime_error If the writer object is invalid due to moving or has no backing stream
+		 * @throws std::runtime_error If the encoder has no type registry
+		 */
+		void WriteTypeDeclarations();
+
 	  private:
 		Writer writer;
+		std::shared_ptr<const TypeRegistry> typeRegistry;
 		bool writerValid = true;
 	};
 }
\ No newline at end of file
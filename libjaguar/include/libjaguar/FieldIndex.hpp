@@ -0,0 +1,231 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Index.hpp"
+#include "IndexID.hpp"
+#include "ListView.hpp"
+#include "Reader.hpp"
+#include "Traits.hpp"
+#include "TypeTags.hpp"
+#include "Writer.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief An element of a list found through a FieldIndex
+	 */
+	struct LJAPI FieldIndexMatch {
+		uint32_t element; ///<Index of the element in the list
+		uint64_t position;///<Stream position at which the element starts (see ListViewBase::SkipTo)
+	};
+
+	/**
+	 * @brief A sorted index from the values of one field to the elements of a list of structured objects
+	 *
+	 * Finding the elements of a large list by a key field would otherwise take a full scan. A field index is built in one pass over the list and maps every key to
+	 * the index and stream position of the elements that hold it, so that a lookup is a binary search followed by a single seek:
+	 * @code
+	 * ListView<StructView> view(reader, list);
+	 * for(const FieldIndexMatch& match : fieldIndex.Find(uint64_t(42))) {
+	 *     view.SkipTo(match.element, match.position);
+	 *     const StructView& element = *view.begin();
+	 * }
+	 * @endcode
+	 *
+	 * Number and string fields can be indexed. Number keys are ordered by value and string keys byte-wise; elements with the same key are ordered by their position
+	 * in the list. Matches for a key or a range of keys are therefore always one contiguous run. Floating-point keys treat -0.0 as equal to 0.0 and all NaNs as
+	 * equal to each other and greater than +inf, so that finding NaN finds every NaN and a range ending at +inf excludes them.
+	 *
+	 * Building reads the list on several threads if the decoder recorded checkpoints for it (see DecodeOptions). An index can be saved next to the stream, as a
+	 * Jaguar stream of its own, and loaded again as long as the list has not changed.
+	 */
+	class LJAPI FieldIndex {
+	  public:
+		/**
+		 * @brief Build an index over a field of the elements of a list
+		 *
+		 * @param openReader Function that opens a new reader for the stream containing the list (called once per thread, possibly concurrently)
+		 * @param index The index of the stream
+		 * @param list The index entry of the list, which must belong to @p index
+		 * @param field The name of the field to index
+		 * @param threadCount The maximum number of threads to read the list with, or 0 to use the hardware concurrency (lists without checkpoints are read on one)
+		 *
+		 * @return The field index
+		 *
+		 * @throws std::runtime_error If the entry is not a list of structured objects or its type is not declared
+		 * @throws std::runtime_error If the type has no field with that name, or the field is neither a number nor a string
+		 * @throws std::runtime_error If any errors occur while reading (see Reader)
+		 * @throws Any exception thrown by @p openReader
+		 */
+		static FieldIndex Build(const std::function<Reader()>& openReader, const Index& index, const ValueEntry& list, std::string_view field,
+								unsigned int threadCount = 0);
+
+		/**
+		 * @brief Load an index saved with Save()
+		 *
+		 * @param reader The reader positioned at the start of the saved index
+		 * @param list The index entry of the list that the index was built for
+		 *
+		 * @return The field index
+		 *
+		 * @throws std::runtime_error If the saved index is malformed or was built for a different list
+		 * @throws std::runtime_error If any errors occur while reading (see Reader)
+		 */
+		static FieldIndex Load(Reader& reader, const ValueEntry& list);
+
+		/**
+		 * @brief Save the index as Jaguar values, so that it can be loaded again without reading the list
+		 *
+		 * @param writer The writer to write the values to
+		 *
+		 * @throws std::runtime_error If the string keys take up more than 4 GiB
+		 * @throws std::runtime_error If any errors occur while writing (see Writer)
+		 */
+		void Save(Writer& writer) const;
+
+		/**
+		 * @brief Get the name of the indexed field
+		 *
+		 * @return The field name
+		 */
+		std::string_view GetFieldName() const {
+			return field;
+		}
+
+		/**
+		 * @brief Get the index ID of the path of the indexed field
+		 *
+		 * Fields of list elements have no entries in the Index, but they do have paths: the field @c pos of the elements of the list @c frames has the path
+		 * <tt>frames[].pos</tt>. The ID of that path identifies the field index, for example to find it among several with the @c _jid literal.
+		 *
+		 * @return The ID, equal to GenIndexID() of the path
+		 */
+		uint64_t GetID() const {
+			return ExtendIndexID(ExtendIndexIDArray(listID), field);
+		}
+
+		/**
+		 * @brief Get the type of the indexed field
+		 *
+		 * @return The TypeTag of the keys
+		 */
+		TypeTag GetKeyType() const {
+			return keyType;
+		}
+
+		/**
+		 * @brief Get the number of indexed elements
+		 *
+		 * @return The element count of the list
+		 */
+		std::size_t size() const {
+			return matches.size();
+		}
+
+		/**
+		 * @brief Find the elements whose field equals a number
+		 *
+		 * @tparam T The number type, which must match the field type exactly
+		 *
+		 * @param key The key
+		 *
+		 * @return The matching elements, in list order (valid until the index is destroyed)
+		 *
+		 * @throws std::runtime_error If the field has a different type
+		 */
+		template<number T>
+		std::span<const FieldIndexMatch> Find(T key) const {
+			return FindRange(key, key);
+		}
+
+		/**
+		 * @brief Find the elements whose field lies in a range of numbers
+		 *
+		 * @tparam T The number type, which must match the field type exactly
+		 *
+		 * @param first The smallest key to include
+		 * @param last The largest key to include
+		 *
+		 * @return The matching elements, ordered by key (valid until the index is destroyed)
+		 *
+		 * @throws std::runtime_error If the field has a different type
+		 */
+		template<number T>
+		std::span<const FieldIndexMatch> FindRange(T first, T last) const {
+			if(type_tag_v<T> != keyType) throw std::runtime_error("Key type does not match the type of the indexed field!");
+			return _FindRangeInternal(_OrderKeyInternal(first), _OrderKeyInternal(last));
+		}
+
+		/**
+		 * @brief Find the elements whose field equals a string
+		 *
+		 * @param key The key
+		 *
+		 * @return The matching elements, in list order (valid until the index is destroyed)
+		 *
+		 * @throws std::runtime_error If the field is not a string
+		 */
+		std::span<const FieldIndexMatch> Find(std::string_view key) const {
+			return FindRange(key, key);
+		}
+
+		/**
+		 * @brief Find the elements whose field lies in a range of strings, compared byte-wise
+		 *
+		 * @param first The smallest key to include
+		 * @param last The largest key to include
+		 *
+		 * @return The matching elements, ordered by key (valid until the index is destroyed)
+		 *
+		 * @throws std::runtime_error If the field is not a string
+		 */
+		std::span<const FieldIndexMatch> FindRange(std::string_view first, std::string_view last) const;
+
+	  private:
+		std::string field;
+		TypeTag keyType{};
+		uint64_t listID = 0;//Identity of the list (its ID and position), checked when loading
+		uint64_t listPosition = 0;
+		std::vector<FieldIndexMatch> matches;//Sorted by key, then by element
+		std::vector<uint64_t> keys;			 //Order-preserving encodings of number keys, one per match
+		std::vector<uint64_t> keyOffsets;	 //Start of the string key of each match in keyData, plus the end of the last one
+		std::string keyData;
+
+		FieldIndex() = default;
+
+		//Maps numbers to unsigned integers of the same order, so that all keys are compared alike
+		template<number T>
+		static uint64_t _OrderKeyInternal(T value) {
+			if constexpr(std::is_floating_point_v<T>) {
+				using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+				//-0.0 equals 0.0, and every NaN gets the one key above that of +inf
+				if(std::isnan(value)) return std::numeric_limits<Bits>::max();
+				if(value == 0) value = 0;
+				const Bits bits = std::bit_cast<Bits>(value);
+				const Bits sign = Bits(1) << (sizeof(T) * 8 - 1);
+				return ((bits & sign) ? Bits(~bits) : Bits(bits | sign));
+			} else if constexpr(std::is_signed_v<T>) {
+				return uint64_t(int64_t(value)) ^ (uint64_t(1) << 63);
+			} else {
+				return uint64_t(value);
+			}
+		}
+
+		static uint64_t _GetKeyInternal(const StructView& element, std::string_view field, TypeTag type);
+		std::string_view _GetStringKeyInternal(std::size_t match) const;
+		std::span<const FieldIndexMatch> _FindRangeInternal(uint64_t first, uint64_t last) const;
+	};
+}
\ No newline at end of file
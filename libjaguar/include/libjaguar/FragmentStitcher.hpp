@@ -0,0 +1,123 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Writer.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace libjaguar {
+	/**
+	 * @brief Stitches independently encoded fragments into a single stream, in a fixed order
+	 *
+	 * Since Jaguar streams can be concatenated and substreams are length-prefixed, a stream can be split into fragments that are encoded on separate threads. Each fragment is
+	 * either a run of root-level values or the body of a single substream value. Fragments are reserved in output order, then each one is encoded into its own memory buffer
+	 * through its own Writer. Completing a fragment writes it (and any completed fragments queued behind it) to the output, with substream headers and sizes filled in, and
+	 * releases its buffer.
+	 *
+	 * Reserving fragments must happen on one thread, but different fragments may be encoded and completed concurrently.
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI FragmentStitcher {
+	  public:
+		/**
+		 * @brief Create a stitcher that writes to the stream of a writer
+		 *
+		 * @param output The writer to write the stitched stream to (must outlive the stitcher and not be used by anything else until Finish() returns)
+		 */
+		explicit FragmentStitcher(Writer& output);
+		~FragmentStitcher();
+
+		///@cond
+		FragmentStitcher(const FragmentStitcher&) = delete;
+		FragmentStitcher& operator=(const FragmentStitcher&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Reserve the next fragment as a run of root-level values
+		 *
+		 * @return The fragment index
+		 */
+		std::size_t AddValues();
+
+		/**
+		 * @brief Reserve the next fragment as a substream value
+		 *
+		 * The fragment's writer receives the substream body; the substream header is written when the fragment is stitched.
+		 *
+		 * @param name The name of the substream value
+		 *
+		 * @return The fragment index
+		 *
+		 * @throws std::runtime_error If the name is invalid UTF-8 or has the wrong length
+		 */
+		std::size_t AddSubstream(const std::string& name);
+
+		/**
+		 * @brief Get the writer for a fragment
+		 *
+		 * @param fragment The fragment index
+		 *
+		 * @return The writer, backed by the fragment's memory buffer
+		 *
+		 * @throws std::runtime_error If the fragment has not been reserved or was already completed
+		 * @throws std::runtime_error If writing a fragment to the output failed earlier
+		 */
+		Writer& GetWriter(std::size_t fragment);
+
+		/**
+		 * @brief Mark a fragment as fully encoded
+		 *
+		 * If all fragments before it have also been completed, it is written to the output right away, along with any completed fragments after it.
+		 *
+		 * @param fragment The fragment index
+		 *
+		 * @throws std::runtime_error If the fragment has not been reserved or was already completed
+		 * @throws std::runtime_error If a substream fragment is larger than 4 GiB
+		 * @throws std::runtime_error If writing to the output fails, now or for an earlier fragment (the stitcher cannot be used any further after that)
+		 */
+		void Complete(std::size_t fragment);
+
+		/**
+		 * @brief Encode and complete every reserved fragment that is not yet complete, in parallel
+		 *
+		 * Workers take fragments in order, and wait before taking another one while more than @p threadCount fragments are queued behind the one at the front. So if one
+		 * fragment is slow to encode, only about as many fragments as there are threads are held in memory at once.
+		 *
+		 * @param encode Function that encodes a fragment through the given writer (called concurrently for different fragments)
+		 * @param threadCount The maximum number of threads to encode with, or 0 to use the hardware concurrency
+		 *
+		 * @throws Any exception thrown by @p encode (the first one, after all workers have stopped)
+		 * @throws std::runtime_error If stitching fails (see Complete())
+		 */
+		void EncodeAll(const std::function<void(std::size_t fragment, Writer& writer)>& encode, unsigned int threadCount = 0);
+
+		/**
+		 * @brief Check that every reserved fragment has been written to the output
+		 *
+		 * @throws std::runtime_error If some fragment has not been completed
+		 * @throws std::runtime_error If writing a fragment to the output failed earlier
+		 */
+		void Finish();
+
+	  private:
+		struct Slot;
+
+		Writer& output;
+		std::mutex slotsMutex; //Guards the slot queue
+		std::mutex outputMutex;//Held while writing to the output
+		std::deque<std::unique_ptr<Slot>> slots;
+		std::size_t firstSlot;//Index of the fragment at the front of the queue
+		bool failed;		  //Set once writing a fragment to the output has failed
+		std::condition_variable frontAdvanced;
+
+		Slot& _GetSlotInternal(std::size_t fragment);
+		void _WriteSlotInternal(Slot& slot);
+	};
+}
\ No newline at end of file
@@ -1,50 +1,286 @@
 #pragma once
 
 #include "DllHelper.hpp"
+#include "IndexID.hpp"
 #include "StructuredTypeLayout.hpp"
+#include "Traits.hpp"
+#include "TypeRegistry.hpp"
 #include "TypeTags.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <ios>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
-#include <string>
 
 namespace libjaguar {
 	/**
 	 * @brief A base entry in the Index
+	 *
+	 * Index structures allocate from a polymorphic memory resource (the default resource unless another allocator is given), and pass it on to everything they contain.
+	 * A whole index can therefore be built in a @c std::pmr::monotonic_buffer_resource and freed in one go, or kept in a pool resource if it is long-lived.
 	 */
 	struct LJAPI Entry {
-		std::string name;				   ///<Item name
-		uint64_t id;					   ///<Internal reference ID derived from path data
-		std::streampos streamBeginPosition;///<Location in the stream where the node begins
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
+		std::pmr::string name;					///<Item name
+		uint64_t id = 0;						///<ID derived from the path of the entry (see GenIndexID)
+		std::streampos streamBeginPosition = 0;///<Location in the stream where the node begins
+
+		///@cond
+		Entry() = default;
+		explicit Entry(const allocator_type& alloc) : name(alloc) {}
+		Entry(const Entry&) = default;
+		Entry(Entry&&) = default;
+		Entry(const Entry& other, const allocator_type& alloc) : name(other.name, alloc), id(other.id), streamBeginPosition(other.streamBeginPosition) {}
+		Entry(Entry&& other, const allocator_type& alloc) : name(std::move(other.name), alloc), id(other.id), streamBeginPosition(other.streamBeginPosition) {}
+		Entry& operator=(const Entry&) = default;
+		Entry& operator=(Entry&&) = default;
+
+		allocator_type get_allocator() const {
+			return name.get_allocator();
+		}
+		///@endcond
 	};
 
 	/**
 	 * @brief An index entry representing a value
 	 */
 	struct LJAPI ValueEntry : public Entry {
-		TypeTag type;		///<Type of value
-		TypeTag elementType;///<Type of contained elements (for vectors, matrices, and lists)
-		uint32_t size;		///<Size of a buffer object (string, byte buffer, substream); string size must be less than 24-bit integer limit
-		uint8_t width;		///<Number of components in a vector or columns in a matrix
-		uint8_t height;		///<Number of rows in a matrix
+		TypeTag type{};						   ///<Type of value
+		TypeTag elementType{};				   ///<Type of contained elements (for vectors, matrices, and lists)
+		uint32_t size = 0;					   ///<Number of elements in a list, or size of a buffer object (string, byte buffer, substream); string size must be less than 24-bit integer limit
+		uint8_t width = 0;					   ///<Number of components in a vector or columns in a matrix
+		uint8_t height = 0;					   ///<Number of rows in a matrix
+		std::pmr::string typeID;			   ///<Type ID of the elements of a list of structured objects
+		uint64_t valueOffset = UINT64_MAX;	   ///<Position of the body in Index::values, or @c UINT64_MAX if it was not materialized (see DecodeOptions)
+		uint64_t checkpointOffset = UINT64_MAX;///<Position of the list's element checkpoints in Index::listCheckpoints, or @c UINT64_MAX if none were recorded (see DecodeOptions)
+
+		///@cond
+		ValueEntry() = default;
+		explicit ValueEntry(const allocator_type& alloc) : Entry(alloc), typeID(alloc) {}
+		ValueEntry(const ValueEntry&) = default;
+		ValueEntry(ValueEntry&&) = default;
+		ValueEntry(const ValueEntry& other, const allocator_type& alloc)
+		  : Entry(other, alloc), type(other.type), elementType(other.elementType), size(other.size), width(other.width), height(other.height), typeID(other.typeID, alloc),
+			valueOffset(other.valueOffset), checkpointOffset(other.checkpointOffset) {}
+		ValueEntry(ValueEntry&& other, const allocator_type& alloc)
+		  : Entry(std::move(other), alloc), type(other.type), elementType(other.elementType), size(other.size), width(other.width), height(other.height),
+			typeID(std::move(other.typeID), alloc), valueOffset(other.valueOffset), checkpointOffset(other.checkpointOffset) {}
+		ValueEntry& operator=(const ValueEntry&) = default;
+		ValueEntry& operator=(ValueEntry&&) = default;
+		///@endcond
+
+		/**
+		 * @brief Check if the body of the value was materialized into the index while decoding
+		 *
+		 * @return @c true if the value can be read from the index without any I/O
+		 */
+		bool IsMaterialized() const {
+			return valueOffset != UINT64_MAX;
+		}
 	};
 
 	/**
 	 * @brief An index entry representing a new scope
 	 */
 	struct LJAPI ScopeEntry : public Entry {
-		bool list;						  ///<Determines if this scope represents a list or an object
-		std::string typeID;				  ///<Type ID for a structured object or list of structured objects (leave empty to denote unstructured)
-		std::vector<ScopeEntry> subscopes;///<Child scope list
-		std::vector<ValueEntry> subvalues;///<Child value list
+		bool list = false;					   ///<Determines if this scope represents a list or an object
+		std::pmr::string typeID;			   ///<Type ID for a structured object or list of structured objects (leave empty to denote unstructured)
+		std::pmr::vector<ScopeEntry> subscopes;///<Child scope list
+		std::pmr::vector<ValueEntry> subvalues;///<Child value list
+
+		///@cond
+		ScopeEntry() = default;
+		explicit ScopeEntry(const allocator_type& alloc) : Entry(alloc), typeID(alloc), subscopes(alloc), subvalues(alloc) {}
+		ScopeEntry(const ScopeEntry&) = default;
+		ScopeEntry(ScopeEntry&&) = default;
+		ScopeEntry(const ScopeEntry& other, const allocator_type& alloc)
+		  : Entry(other, alloc), list(other.list), typeID(other.typeID, alloc), subscopes(other.subscopes, alloc), subvalues(other.subvalues, alloc) {}
+		ScopeEntry(ScopeEntry&& other, const allocator_type& alloc)
+		  : Entry(std::move(other), alloc), list(other.list), typeID(std::move(other.typeID), alloc), subscopes(std::move(other.subscopes), alloc),
+			subvalues(std::move(other.subvalues), alloc) {}
+		ScopeEntry& operator=(const ScopeEntry&) = default;
+		ScopeEntry& operator=(ScopeEntry&&) = default;
+		///@endcond
+
+		/**
+		 * @brief Find a value in this scope or any of its subscopes by its ID
+		 *
+		 * @param valueID The ID of the value (see GenIndexID or the @c _jid literal)
+		 *
+		 * @return The value entry, or @c nullptr if there is none with that ID
+		 */
+		const ValueEntry* FindValue(uint64_t valueID) const {
+			for(const ValueEntry& value : subvalues) {
+				if(value.id == valueID) return &value;
+			}
+			for(const ScopeEntry& subscope : subscopes) {
+				if(const ValueEntry* found = subscope.FindValue(valueID)) return found;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Find this scope or any of its subscopes by its ID
+		 *
+		 * @param scopeID The ID of the scope (see GenIndexID or the @c _jid literal)
+		 *
+		 * @return The scope entry, or @c nullptr if there is none with that ID
+		 */
+		const ScopeEntry* FindScope(uint64_t scopeID) const {
+			if(id == scopeID) return this;
+			for(const ScopeEntry& subscope : subscopes) {
+				if(const ScopeEntry* found = subscope.FindScope(scopeID)) return found;
+			}
+			return nullptr;
+		}
 	};
 
 	/**
 	 * @brief An index describing the structure of the Jaguar stream
 	 */
 	struct LJAPI Index {
-		std::unordered_map<std::string, StructuredTypeLayout> types;///<List of recognized structured object types
-		ScopeEntry root;											///<Root scope entry
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
+		std::pmr::unordered_map<std::pmr::string, StructuredTypeLayout> types;///<List of recognized structured object types (except those in sharedTypes)
+		std::shared_ptr<const TypeRegistry> registry;						   ///<Registry that declarations were matched against, which owns the layouts in sharedTypes
+		std::pmr::vector<const StructuredTypeLayout*> sharedTypes;			   ///<Declared types whose layouts matched the registry, in declaration order
+		ScopeEntry root;													   ///<Root scope entry
+		std::pmr::vector<unsigned char> values;								   ///<Materialized value bodies, in stream (little-endian) byte order
+		std::pmr::vector<uint64_t> listCheckpoints;							   ///<Stream positions of every listCheckpointInterval-th element of lists with checkpoints (see ValueEntry::checkpointOffset)
+		uint32_t listCheckpointInterval = 0;								   ///<Number of elements between two checkpoints of a list, or 0 if none were recorded
+
+		///@cond
+		Index() = default;
+		explicit Index(const allocator_type& alloc) : types(alloc), sharedTypes(alloc), root(alloc), values(alloc), listCheckpoints(alloc) {}
+		Index(const Index&) = default;
+		Index(Index&&) = default;
+		Index(const Index& other, const allocator_type& alloc)
+		  : types(other.types, alloc), registry(other.registry), sharedTypes(other.sharedTypes, alloc), root(other.root, alloc), values(other.values, alloc),
+			listCheckpoints(other.listCheckpoints, alloc), listCheckpointInterval(other.listCheckpointInterval) {}
+		Index(Index&& other, const allocator_type& alloc)
+		  : types(std::move(other.types), alloc), registry(std::move(other.registry)), sharedTypes(std::move(other.sharedTypes), alloc), root(std::move(other.root), alloc),
+			values(std::move(other.values), alloc), listCheckpoints(std::move(other.listCheckpoints), alloc), listCheckpointInterval(other.listCheckpointInterval) {}
+		Index& operator=(const Index&) = default;
+		Index& operator=(Index&&) = default;
+
+		allocator_type get_allocator() const {
+			return root.get_allocator();
+		}
+		///@endcond
+
+		/**
+		 * @brief Find the layout of a declared type, whether it is stored in the index or shared with the registry
+		 *
+		 * @param typeID The type ID
+		 *
+		 * @return The layout, or @c nullptr if the stream did not declare a type with that ID
+		 */
+		const StructuredTypeLayout* FindType(const std::pmr::string& typeID) const {
+			auto it = types.find(typeID);
+			if(it != types.end()) return &it->second;
+			for(const StructuredTypeLayout* layout : sharedTypes) {
+				if(layout->typeID == typeID) return layout;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Get the materialized body of a value
+		 *
+		 * Vector and matrix components are in stream (little-endian) byte order.
+		 *
+		 * @param entry The value entry, which must belong to this index
+		 *
+		 * @return A view of the bytes, valid until the index is modified
+		 *
+		 * @throws std::runtime_error If the value was not materialized
+		 */
+		std::span<const unsigned char> GetBytes(const ValueEntry& entry) const {
+			if(!entry.IsMaterialized()) throw std::runtime_error("Value was not materialized!");
+			return std::span<const unsigned char>(values.data() + entry.valueOffset, _GetSizeInternal(entry));
+		}
+
+		/**
+		 * @brief Get the value of a materialized number
+		 *
+		 * @tparam T The number type, which must match the value type exactly
+		 *
+		 * @param entry The value entry, which must belong to this index
+		 *
+		 * @return The value
+		 *
+		 * @throws std::runtime_error If the value has a different type or was not materialized
+		 */
+		template<number T>
+		T Get(const ValueEntry& entry) const {
+			if(entry.type != type_tag_v<T>) throw std::runtime_error("Value type does not match the requested type!");
+			return LoadLittleEndian<T>(GetBytes(entry).data());
+		}
+
+		/**
+		 * @brief Get the value of a materialized boolean
+		 *
+		 * @param entry The value entry, which must belong to this index
+		 *
+		 * @return The value
+		 *
+		 * @throws std::runtime_error If the value is not a boolean or was not materialized
+		 */
+		bool GetBool(const ValueEntry& entry) const {
+			if(entry.type != TypeTag::Boolean) throw std::runtime_error("Value type does not match the requested type!");
+			return GetBytes(entry)[0] != 0;
+		}
+
+		/**
+		 * @brief Get the value of a materialized string
+		 *
+		 * @param entry The value entry, which must belong to this index
+		 *
+		 * @return A view of the string, valid until the index is modified
+		 *
+		 * @throws std::runtime_error If the value is not a string or was not materialized
+		 */
+		std::string_view GetString(const ValueEntry& entry) const {
+			if(entry.type != TypeTag::String) throw std::runtime_error("Value type does not match the requested type!");
+			std::span<const unsigned char> bytes = GetBytes(entry);
+			return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+
+		/**
+		 * @brief Find the closest element of a list at or before a given one whose stream position is known
+		 *
+		 * Lists of strings, objects, or other lists can only be walked element by element. Where checkpoints were recorded (see DecodeOptions), the returned position
+		 * is at most listCheckpointInterval - 1 elements before the wanted one; otherwise it is the start of the list.
+		 *
+		 * @param entry The list entry, which must belong to this index
+		 * @param element The index of the element
+		 *
+		 * @return The index of the element at the returned position, and the stream position at which that element starts
+		 */
+		std::pair<uint32_t, std::streampos> FindListCheckpoint(const ValueEntry& entry, uint32_t element) const {
+			if(entry.checkpointOffset == UINT64_MAX || element < listCheckpointInterval) return {0, entry.streamBeginPosition};
+			const uint32_t checkpoint = std::min<uint32_t>(element, entry.size - 1) / listCheckpointInterval;
+			return {checkpoint * listCheckpointInterval, std::streamoff(listCheckpoints[entry.checkpointOffset + checkpoint - 1])};
+		}
+
+	  private:
+		static uint64_t _GetSizeInternal(const ValueEntry& entry) {
+			switch(entry.type) {
+				case TypeTag::String:
+				case TypeTag::ByteBuffer: return entry.size;
+				case TypeTag::Vector: return uint64_t(GetTypeSize(entry.elementType)) * entry.width;
+				case TypeTag::Matrix: return uint64_t(GetTypeSize(entry.elementType)) * entry.width * entry.height;
+				default: return GetTypeSize(entry.type);
+			}
+		}
 	};
 }
\ No newline at end of file
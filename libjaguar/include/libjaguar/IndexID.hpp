@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace libjaguar {
+	/**
+	 * @brief Index ID state before any path components are added
+	 */
+	inline constexpr uint64_t indexIDSeed = 0xCBF29CE484222325ull;
+
+	///@cond
+	inline constexpr uint64_t indexIDPrime = 0x100000001B3ull;
+	inline constexpr uint64_t indexIDArrayMarker = 0x200;
+	///@endcond
+
+	/**
+	 * @brief Extend the index ID of a path by one named component
+	 *
+	 * IDs are 64-bit FNV-1a hashes over the bytes of every component, each followed by an end marker that includes its length. The end markers lie outside the byte
+	 * range, so different paths always hash different inputs, and two distinct paths only share an ID by chance: among @c n paths, the probability of any collision is
+	 * about <tt>n² / 2^65</tt> (roughly one in 37 million for a million paths). Collisions are not detected, so applications that cannot accept them should confirm
+	 * the name of a found entry.
+	 *
+	 * @param parent The ID of the parent path (@c indexIDSeed for values in the root scope)
+	 * @param component The name of the child
+	 *
+	 * @return The ID of the child path
+	 */
+	constexpr uint64_t ExtendIndexID(uint64_t parent, std::string_view component) {
+		uint64_t hash = parent;
+		for(char c : component) hash = (hash ^ static_cast<unsigned char>(c)) * indexIDPrime;
+		return (hash ^ (0x100 + component.size())) * indexIDPrime;
+	}
+
+	/**
+	 * @brief Extend the index ID of a list path by its elements (the @c [] in <tt>frames[].pos</tt>)
+	 *
+	 * The Decoder does not index list elements, so IDs of paths through them are not found in the Index. They identify field indexes instead (see FieldIndex::GetID).
+	 *
+	 * @param parent The ID of the list path
+	 *
+	 * @return The ID shared by all elements of the list
+	 */
+	constexpr uint64_t ExtendIndexIDArray(uint64_t parent) {
+		return (parent ^ indexIDArrayMarker) * indexIDPrime;
+	}
+
+	/**
+	 * @brief Compute the index ID of a full path
+	 *
+	 * Components are separated by @c . and list elements are denoted by @c [] (as in <tt>frames[].pos</tt>). An empty path is the root scope. For paths without
+	 * @c [], the result equals the ID the Decoder assigns to the entry at that path. A path with @c [] names a field of the elements of a list, whose ID is that of
+	 * a FieldIndex over the field (see FieldIndex::GetID). Names that contain @c . or @c [ cannot be written as a path; use ExtendIndexID() for them.
+	 *
+	 * @param path The path
+	 *
+	 * @return The ID
+	 *
+	 * @throws std::runtime_error If a component is empty, a @c [ is not directly followed by @c ], or a @c [] is followed by anything but @c . or another @c []
+	 * (at compile time, this fails to compile instead)
+	 */
+	constexpr uint64_t GenIndexID(std::string_view path) {
+		if(path.empty()) return ExtendIndexID(indexIDSeed, "");
+
+		uint64_t hash = indexIDSeed;
+		std::size_t pos = 0;
+		while(true) {
+			//Named component, up to the next separator
+			const std::size_t end = path.find_first_of(".[", pos);
+			const std::string_view component = path.substr(pos, end - pos);
+			if(component.empty()) throw std::runtime_error("Index path contains an empty component!");
+			hash = ExtendIndexID(hash, component);
+			pos = end;
+
+			//Any number of list element markers
+			while(pos < path.size() && path[pos] == '[') {
+				if(pos + 1 >= path.size() || path[pos + 1] != ']') throw std::runtime_error("Index path contains an unclosed list element marker!");
+				hash = ExtendIndexIDArray(hash);
+				pos += 2;
+			}
+			if(pos >= path.size()) return hash;
+			if(path[pos] != '.') throw std::runtime_error("Index path is missing a separator after a list element marker!");
+			++pos;
+		}
+	}
+
+	/**
+	 * @brief User-defined literals for Jaguar
+	 */
+	inline namespace literals {
+		/**
+		 * @brief Compute the index ID of a path at compile time (see GenIndexID)
+		 *
+		 * @code {.cpp}
+		 * using namespace libjaguar::literals;
+		 * const ValueEntry* width = index.root.FindValue("config.window.width"_jid);
+		 * @endcode
+		 *
+		 * @param path The path
+		 * @param length The length of the path
+		 *
+		 * @return The ID
+		 */
+		consteval uint64_t operator""_jid(const char* path, std::size_t length) {
+			return GenIndexID(std::string_view(path, length));
+		}
+	}
+}
\ No newline at end of file
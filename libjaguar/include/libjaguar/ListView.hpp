@@ -0,0 +1,444 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Index.hpp"
+#include "Reader.hpp"
+#include "Traits.hpp"
+#include "TypeTags.hpp"
+#include "ValueHeader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief A decoded element of a list of structured objects, as produced by a ListView
+	 *
+	 * Field bodies of numbers, booleans, vectors, matrices, strings, and byte buffers are kept and can be accessed by field name. Nested lists and objects are
+	 * skipped over; their headers are still available. Substreams are skipped over as well, but their position is kept so that they can be read separately.
+	 */
+	class LJAPI StructView {
+	  public:
+		/**
+		 * @brief Get the number of fields in the object
+		 *
+		 * @return The field count
+		 */
+		std::size_t GetFieldCount() const {
+			return fieldCount;
+		}
+
+		/**
+		 * @brief Get the header of a field
+		 *
+		 * @param index The index of the field, in stream order
+		 *
+		 * @return The field header
+		 *
+		 * @throws std::runtime_error If the index is out of bounds
+		 */
+		const ValueHeader& GetFieldHeader(std::size_t index) const;
+
+		/**
+		 * @brief Check if the object has a field
+		 *
+		 * @param name The field name
+		 *
+		 * @return @c true if a field with that name exists
+		 */
+		bool HasField(std::string_view name) const;
+
+		/**
+		 * @brief Get the value of a number field
+		 *
+		 * @tparam T The number type, which must match the field type exactly
+		 *
+		 * @param name The field name
+		 *
+		 * @return The value
+		 *
+		 * @throws std::runtime_error If no field with that name exists or it has a different type
+		 */
+		template<number T>
+		T Get(std::string_view name) const {
+			//Values are stored little-endian
+			return LoadLittleEndian<T>(_GetInternal(name, type_tag_v<T>).data());
+		}
+
+		/**
+		 * @brief Get the value of a boolean field
+		 *
+		 * @param name The field name
+		 *
+		 * @return The value
+		 *
+		 * @throws std::runtime_error If no field with that name exists or it is not a boolean
+		 */
+		bool GetBool(std::string_view name) const {
+			return _GetInternal(name, TypeTag::Boolean)[0] != 0;
+		}
+
+		/**
+		 * @brief Get the value of a string field
+		 *
+		 * @param name The field name
+		 *
+		 * @return A view of the string, valid until the next element is decoded
+		 *
+		 * @throws std::runtime_error If no field with that name exists or it is not a string
+		 */
+		std::string_view GetString(std::string_view name) const {
+			std::span<const unsigned char> bytes = _GetInternal(name, TypeTag::String);
+			return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+
+		/**
+		 * @brief Get the body of a byte buffer, vector, or matrix field
+		 *
+		 * Vector and matrix components are in stream (little-endian) byte order.
+		 *
+		 * @param name The field name
+		 *
+		 * @return A view of the bytes, valid until the next element is decoded
+		 *
+		 * @throws std::runtime_error If no field with that name exists or it is of another type
+		 */
+		std::span<const unsigned char> GetBytes(std::string_view name) const;
+
+		/**
+		 * @brief Get the position of the body of a substream field, whose size is in its header (see GetFieldHeader)
+		 *
+		 * @param name The field name
+		 *
+		 * @return The stream position at which the substream begins, or -1 if the stream does not report positions
+		 *
+		 * @throws std::runtime_error If no field with that name exists or it is not a substream
+		 */
+		std::streampos GetSubstreamPosition(std::string_view name) const;
+
+	  private:
+		template<typename T>
+		friend struct ListElement;
+
+		struct Field {
+			ValueHeader header;
+			uint64_t offset;		//Position of the body in data
+			uint64_t size;			//Size of the body in data
+			std::streampos position;//Stream position of the body
+			bool stored;			//Whether the body was kept
+		};
+
+		std::vector<Field> fields;//Reused between elements, so only the first fieldCount are valid
+		std::size_t fieldCount = 0;
+		std::vector<unsigned char> data;
+
+		void _ReadInternal(Reader& reader);
+		const Field* _FindInternal(std::string_view name) const;
+		std::span<const unsigned char> _GetInternal(std::string_view name, TypeTag type) const;
+	};
+
+	///@cond
+	template<typename T>
+	struct ListElement {};
+
+	template<typename T>
+		requires number<T> || std::is_same_v<T, bool>
+	struct ListElement<T> {
+		using reference = T;
+		static constexpr TypeTag type = type_tag_v<T>;
+
+		T value{};
+
+		void Decode(Reader& reader) {
+			value = reader.template Read<type>();
+		}
+
+		reference Get() const {
+			return value;
+		}
+	};
+
+	template<>
+	struct LJAPI ListElement<std::string_view> {
+		using reference = std::string_view;
+		static constexpr TypeTag type = TypeTag::String;
+
+		std::string value;
+
+		void Decode(Reader& reader);
+
+		reference Get() const {
+			return value;
+		}
+	};
+
+	template<>
+	struct ListElement<StructView> {
+		using reference = const StructView&;
+		static constexpr TypeTag type = TypeTag::StructuredObj;
+
+		StructView value;
+
+		void Decode(Reader& reader) {
+			value._ReadInternal(reader);
+		}
+
+		reference Get() const {
+			return value;
+		}
+	};
+	///@endcond
+
+	/**
+	 * @brief Type-independent part of a ListView, which tracks the position of the stream within the list
+	 *
+	 * <b>This class is move-only!</b>
+	 */
+	class LJAPI ListViewBase {
+	  public:
+		///@cond
+		ListViewBase(const ListViewBase&) = delete;
+		ListViewBase& operator=(const ListViewBase&) = delete;
+		ListViewBase(ListViewBase&&) = default;
+		ListViewBase& operator=(ListViewBase&&) = default;
+		///@endcond
+
+		/**
+		 * @brief Get the number of elements in the list
+		 *
+		 * @return The element count
+		 */
+		uint32_t size() const {
+			return count;
+		}
+
+		/**
+		 * @brief Get the type ID of the elements of a list of structured objects
+		 *
+		 * @return The type ID, or an empty string for other lists
+		 */
+		std::string_view GetTypeID() const {
+			return typeID;
+		}
+
+		/**
+		 * @brief Move the stream to the end of the list, skipping all elements that have not been read yet
+		 *
+		 * Call this after stopping early to continue reading whatever follows the list.
+		 *
+		 * @throws std::runtime_error If any errors occur while reading (see Reader)
+		 */
+		void SkipRemaining() {
+			_MoveToInternal(count);
+		}
+
+		/**
+		 * @brief Move the stream to an element, so that iteration continues from there
+		 *
+		 * Views created with an index can move to any element: they seek to the closest element whose position is known (see Index::FindListCheckpoint) and skip
+		 * the elements after it. Other views can only move forward, skipping every element in between.
+		 *
+		 * @param index The index of the element (the element count moves to the end of the list)
+		 *
+		 * @throws std::runtime_error If the index is out of bounds
+		 * @throws std::runtime_error If the element was already passed and the view was created without an index
+		 * @throws std::runtime_error If any errors occur while reading (see Reader)
+		 */
+		void SkipTo(uint32_t index) {
+			if(index > count) throw std::runtime_error("Out of bounds list element access!");
+			_MoveToInternal(index);
+		}
+
+		/**
+		 * @brief Move the stream to an element whose position is known (for example from a FieldIndex), so that iteration continues from there
+		 *
+		 * @param index The index of the element
+		 * @param position The stream position at which the element starts
+		 *
+		 * @throws std::runtime_error If the index is out of bounds
+		 * @throws std::runtime_error If the stream cannot seek to the element
+		 */
+		void SkipTo(uint32_t index, std::streampos position);
+
+	  protected:
+		Reader* reader;
+		TypeTag elementType;
+		uint32_t count;
+		std::string typeID;
+		uint32_t stride;	   //Size of each element if they all have the same fixed size, 0 otherwise
+		uint32_t streamIndex;  //Index of the element the stream is positioned at
+		uint32_t decodedIndex; //Index of the element that was decoded last
+		const Index* listIndex;//Index the list entry belongs to, if the view can seek
+		const ValueEntry* listEntry;
+
+		ListViewBase(Reader& reader, const ValueHeader& header, TypeTag expectedElementType);
+		ListViewBase(Reader& reader, const ValueEntry& entry, TypeTag expectedElementType);
+		ListViewBase(Reader& reader, const ValueEntry& entry, const Index& index, TypeTag expectedElementType);
+
+		void _MoveToInternal(uint32_t index);
+	};
+
+	/**
+	 * @brief A lazy, single-pass range over the elements of a list value
+	 *
+	 * Elements are only decoded when an iterator is dereferenced. Elements that are stepped over are skipped without being decoded; lists of numbers and booleans are
+	 * skipped in one go, since all elements have the same size. The view can be composed with the standard range adaptors (e.g. @c std::views::filter or
+	 * @c std::views::take), so that reading can stop as soon as the wanted elements have been found.
+	 *
+	 * The supported element types are:
+	 * - numbers and @c bool, for lists of the matching number type or booleans
+	 * - @c std::string_view, for lists of strings (each view is valid until the next element is decoded)
+	 * - StructView, for lists of structured objects (each StructView is valid until the next element is decoded)
+	 *
+	 * The view reads directly from the reader's stream, so the reader must not be used otherwise until the view is done. Once an iterator has been compared equal to
+	 * end() (which skips any elements that were stepped over but not decoded) or SkipRemaining() was called, the stream is positioned right after the list. Call
+	 * SkipRemaining() when stopping early, for example after @c std::views::take.
+	 *
+	 * A view created with the index that the list entry belongs to is not limited to a single pass: it seeks to reach elements it has passed or is far from (see
+	 * SkipTo). Fixed-size elements are seeked to directly. For other lists, recording checkpoints while decoding (see DecodeOptions) bounds the number of elements
+	 * skipped after each seek, so slices of a long list can be read on their own, for example in parallel with one view and reader per thread.
+	 *
+	 * <b>This class is move-only!</b> Moving it invalidates its iterators.
+	 *
+	 * @tparam T The element type
+	 */
+	template<typename T>
+		requires requires { ListElement<T>::type; }
+	class ListView : public ListViewBase {
+	  public:
+		/**
+		 * @brief Input iterator over the elements of a ListView
+		 */
+		class iterator {
+		  public:
+			using iterator_concept = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+			///@cond
+			iterator() = default;
+			///@endcond
+
+			/**
+			 * @brief Decode the current element (or return it again, if it was already decoded)
+			 *
+			 * @return The element
+			 *
+			 * @throws std::runtime_error If an element that was already passed is accessed and the view was created without an index
+			 * @throws std::runtime_error If any errors occur while reading (see Reader)
+			 */
+			typename ListElement<T>::reference operator*() const {
+				return view->_DecodeInternal(index);
+			}
+
+			///@cond
+			iterator& operator++() {
+				++index;
+				return *this;
+			}
+
+			void operator++(int) {
+				++index;
+			}
+
+			friend bool operator==(const iterator& it, std::default_sentinel_t) {
+				if(it.index < it.view->size()) return false;
+
+				//Elements that were stepped over without being decoded are still in the stream
+				it.view->SkipRemaining();
+				return true;
+			}
+			///@endcond
+
+			/**
+			 * @brief Get the position of the current element in the list
+			 *
+			 * @return The element index
+			 */
+			uint32_t GetIndex() const {
+				return index;
+			}
+
+		  private:
+			friend class ListView;
+
+			ListView* view = nullptr;
+			uint32_t index = 0;
+
+			iterator(ListView* view, uint32_t index) : view(view), index(index) {}
+		};
+
+		/**
+		 * @brief Create a view over a list whose header was just read
+		 *
+		 * @param reader The reader positioned at the start of the list body (must outlive the view)
+		 * @param header The header of the list
+		 *
+		 * @throws std::runtime_error If the header is not a list of the element type of the view
+		 */
+		ListView(Reader& reader, const ValueHeader& header) : ListViewBase(reader, header, ListElement<T>::type) {}
+
+		/**
+		 * @brief Create a view over a list found by the Decoder, seeking to its body
+		 *
+		 * @param reader The reader for the stream containing the list (must be seekable and outlive the view)
+		 * @param entry The index entry of the list
+		 *
+		 * @throws std::runtime_error If the entry is not a list of the element type of the view
+		 * @throws std::runtime_error If the stream cannot seek to the list
+		 */
+		ListView(Reader& reader, const ValueEntry& entry) : ListViewBase(reader, entry, ListElement<T>::type) {}
+
+		/**
+		 * @brief Create a view over a list found by the Decoder that can seek to any element
+		 *
+		 * @param reader The reader for the stream containing the list (must be seekable and outlive the view)
+		 * @param entry The index entry of the list
+		 * @param index The index the entry belongs to (must outlive the view and not be modified meanwhile)
+		 *
+		 * @throws std::runtime_error If the entry is not a list of the element type of the view
+		 * @throws std::runtime_error If the stream cannot seek to the list
+		 */
+		ListView(Reader& reader, const ValueEntry& entry, const Index& index) : ListViewBase(reader, entry, index, ListElement<T>::type) {}
+
+		/**
+		 * @brief Get an iterator at the first element that has not been passed yet
+		 *
+		 * @return The iterator
+		 */
+		iterator begin() {
+			return iterator(this, streamIndex);
+		}
+
+		/**
+		 * @brief Get the end of the list
+		 *
+		 * @return The sentinel
+		 */
+		std::default_sentinel_t end() const {
+			return std::default_sentinel;
+		}
+
+	  private:
+		ListElement<T> element;
+
+		typename ListElement<T>::reference _DecodeInternal(uint32_t index) {
+			if(index != decodedIndex) {
+				_MoveToInternal(index);
+				element.Decode(*reader);
+				streamIndex = index + 1;
+				decodedIndex = index;
+			}
+			return element.Get();
+		}
+	};
+}
\ No newline at end of file
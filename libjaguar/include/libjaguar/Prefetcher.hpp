@@ -0,0 +1,123 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Index.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief A byte range of a stream that is expected to be read
+	 */
+	struct LJAPI ReadRange {
+		uint64_t begin;///<Stream position of the first byte
+		uint64_t size; ///<Number of bytes, or 0 if only the start is known
+	};
+
+	/**
+	 * @brief Settings for a Prefetcher
+	 */
+	struct LJAPI PrefetchOptions {
+		uint64_t window = 16 * 1024 * 1024;		  ///<How far ahead of the consumer to prefetch, in bytes of planned ranges
+		uint64_t dropThreshold = 1024 * 1024;	  ///<Minimum size of a skipped range for its pages to be dropped
+		std::size_t readaheadBufferSize = 1024 * 1024;///<Size of the buffer used for background readahead (0 to only issue hints)
+	};
+
+	/**
+	 * @brief List the byte ranges of the values and subscopes of a scope, in stream order
+	 *
+	 * The ranges cover the bodies (index positions are just past the headers). Where the body size does not follow from the index entry, the range runs up to
+	 * the next entry in the scope, or has an unknown size for the last entry.
+	 *
+	 * @param scope The scope to plan for
+	 * @param fields The names of the entries that will be read (leave empty to plan for all of them)
+	 *
+	 * @return The ranges
+	 */
+	LJAPI std::vector<ReadRange> PlanReadRanges(const ScopeEntry& scope, std::span<const std::string_view> fields = {});
+
+	/**
+	 * @brief Issues page cache hints and reads ahead of a consumer that works through a planned set of byte ranges
+	 *
+	 * Readers work on plain streams, so the prefetcher opens the file on its own (the page cache is shared) or is given the memory the data lives in (for example, a
+	 * mapped file read through Reader::FromMemory). As the consumer reports its position with Advance(), the next ranges of the plan (up to the window size) are
+	 * announced with @c posix_fadvise or @c madvise, and a background thread reads them into a bounded scratch buffer so that they are in the page cache before they are
+	 * needed. Large ranges that the consumer skips can be dropped from the cache with Drop().
+	 *
+	 * All hints are advisory: on platforms without them, the prefetcher does nothing.
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI Prefetcher {
+	  public:
+		/**
+		 * @brief Create a prefetcher for a file
+		 *
+		 * @param path The path of the file being read
+		 * @param plan The ranges the consumer is going to read, in any order
+		 * @param options Prefetch settings
+		 *
+		 * @throws std::runtime_error If the file cannot be opened
+		 */
+		Prefetcher(const std::string& path, std::vector<ReadRange> plan, const PrefetchOptions& options = {});
+
+		/**
+		 * @brief Create a prefetcher for data in memory
+		 *
+		 * @param memory The memory holding the stream (usually a mapped file)
+		 * @param plan The ranges the consumer is going to read, in any order
+		 * @param options Prefetch settings
+		 */
+		Prefetcher(std::span<const unsigned char> memory, std::vector<ReadRange> plan, const PrefetchOptions& options = {});
+
+		~Prefetcher();
+
+		///@cond
+		Prefetcher(const Prefetcher&) = delete;
+		Prefetcher& operator=(const Prefetcher&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Report the position of the consumer, so that the ranges following it are prefetched
+		 *
+		 * @param position The stream position the consumer has reached
+		 */
+		void Advance(uint64_t position);
+
+		/**
+		 * @brief Report a range the consumer skipped, so that its pages can be dropped from the cache if it is large
+		 *
+		 * In memory, pages are only marked as good candidates for reclaiming (where supported), since the memory may not be backed by a file.
+		 *
+		 * @param range The skipped range
+		 */
+		void Drop(const ReadRange& range);
+
+	  private:
+		std::vector<ReadRange> plan;//Sorted by begin
+		PrefetchOptions options;
+		int fd;
+		const unsigned char* memory;
+		uint64_t memorySize;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		uint64_t consumerPosition;
+		std::size_t hintedRange;//Ranges before this have been hinted
+		std::size_t readRange;	//Ranges before this have been read ahead
+		uint64_t readPosition;	//Stream position up to which data has been read ahead
+		bool stopping;
+		std::thread worker;
+
+		void _StartInternal(std::vector<ReadRange>&& ranges);
+		void _HintInternal(const ReadRange& range, bool willNeed);
+		void _WorkerInternal();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "TypeTags.hpp"
+#include "ValueHeader.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace libjaguar {
+	/**
+	 * @brief A value header that has been validated and encoded once, so that it can be written any number of times with a single stream write
+	 *
+	 * Encoders tend to emit the same field names over and over. Preparing their headers up front (for example, once per field of each type an encoder handles) skips name
+	 * validation and per-field encoding on every write.
+	 *
+	 * Lists, strings, byte buffers, and substreams end their header in a size, which usually differs from value to value. The size in the prepared header is the one it was
+	 * created with, but Writer::WriteHeader(const PreparedHeader&, uint32_t) can substitute another one while writing.
+	 *
+	 * Prepared headers are plain values with no heap allocations and may be shared between threads for writing.
+	 */
+	class LJAPI PreparedHeader {
+	  public:
+		///Largest possible encoded header: tag, name, element tag, type ID, and size
+		static constexpr std::size_t maxEncodedSize = 1 + 1 + UINT8_MAX + 1 + 1 + UINT8_MAX + 4;
+
+		/**
+		 * @brief Validate and encode a header
+		 *
+		 * @param header The header to encode
+		 * @param noIdentifier Whether or not to omit the value identifier (not used in lists, for example)
+		 *
+		 * @throws std::runtime_error If the provided name string is invalid UTF-8 or has the wrong length
+		 * @throws std::runtime_error If the provided type ID string is invalid UTF-8 or has the wrong length (for types requiring that)
+		 */
+		explicit PreparedHeader(const ValueHeader& header, bool noIdentifier = false);
+
+		/**
+		 * @brief Get the encoded header bytes
+		 *
+		 * @return The bytes, exactly as they are written to the stream
+		 */
+		std::span<const char> GetBytes() const {
+			return std::span<const char>(bytes.data(), length);
+		}
+
+		/**
+		 * @brief Get the type of the encoded header
+		 *
+		 * @return The type tag
+		 */
+		TypeTag GetType() const {
+			return type;
+		}
+
+		/**
+		 * @brief Check if the header ends in a size that can be substituted while writing
+		 *
+		 * @return Whether the header is for a list, string, byte buffer, or substream
+		 */
+		bool HasSize() const {
+			return hasSize;
+		}
+
+	  private:
+		std::array<char, maxEncodedSize> bytes;
+		uint16_t length;
+		TypeTag type;
+		bool hasSize;
+	};
+}
\ No newline at end of file
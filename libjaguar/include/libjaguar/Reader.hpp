@@ -2,16 +2,27 @@
 
 #include "DllHelper.hpp"
 #include "ValueHeader.hpp"
+#include "StructuredTypeLayout.hpp"
 #include "Traits.hpp"
 #include "ScopedView.hpp"
 
 #include <bit>
 #include <istream>
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <memory>
+#include <span>
 
 namespace libjaguar {
+	/**
+	 * @brief Settings for a pipelined reader (see Reader::Pipelined)
+	 */
+	struct LJAPI PipelineOptions {
+		std::size_t blockSize = 1024 * 1024;///<Size of each block read ahead by the I/O thread
+		std::size_t depth = 4;				///<Number of blocks in the ring (the I/O thread waits while all of them are full)
+	};
+
 	/**
 	 * @brief Low-level stateless Jaguar stream reader
 	 *
@@ -57,6 +68,8 @@ namespace libjaguar {
 		/**
 		 * @brief Read a value header from the stream
 		 *
+		 * @param alloc The allocator for the strings of the header
+		 *
 		 * @return The read ValueHeader
 		 *
 		 * @throws std::runtime_error If the TypeTag found is invalid
@@ -64,7 +77,82 @@ namespace libjaguar {
 		 * @throws std::runtime_error If a element TypeTag is invalid (e.g. for a list)
 		 * @throws std::runtime_error If an IO error occurs while reading
 		 */
-		ValueHeader ReadHeader();
+		ValueHeader ReadHeader(const ValueHeader::allocator_type& alloc = {});
+
+		/**
+		 * @brief Read a value header from the stream into an existing header
+		 *
+		 * The strings of the header are reused, so reading many headers into the same one does not allocate once its strings have grown large enough.
+		 *
+		 * @param header The header to overwrite with the read header
+		 *
+		 * @throws std::runtime_error If the TypeTag found is invalid
+		 * @throws std::runtime_error If the value name string is empty or not valid UTF-8
+		 * @throws std::runtime_error If a element TypeTag is invalid (e.g. for a list)
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		void ReadHeader(ValueHeader& header);
+
+		/**
+		 * @brief Read the header of a list element from the stream
+		 *
+		 * List elements have no value identifier (type tag and name), so only the type-specific header data is read. Structured object elements have no header data at all
+		 * (their type ID is declared by the list), so nothing is read for them.
+		 *
+		 * @param elementType The element TypeTag declared by the list
+		 * @param alloc The allocator for the strings of the header
+		 *
+		 * @return The read ValueHeader (with an empty name)
+		 *
+		 * @throws std::runtime_error If the element TypeTag is not a valid list element type
+		 * @throws std::runtime_error If a nested element TypeTag is invalid (e.g. for a list of vectors)
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		ValueHeader ReadElementHeader(TypeTag elementType, const ValueHeader::allocator_type& alloc = {});
+
+		/**
+		 * @brief Skip over the body of a value whose header was just read
+		 *
+		 * Nested lists and objects are walked header by header until their end, while values with a known size are discarded directly.
+		 * Structured object type declarations are read and discarded.
+		 *
+		 * @param header The header of the value to skip
+		 *
+		 * @throws std::runtime_error If the size of a vector or matrix cannot be determined from its element type
+		 * @throws std::runtime_error If the maximum nesting depth is exceeded
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		void SkipBody(const ValueHeader& header);
+
+		/**
+		 * @brief Read the body of a structured object type declaration whose header was just read
+		 *
+		 * @param header The header of the declaration
+		 * @param alloc The allocator for the layout
+		 *
+		 * @return The declared type layout
+		 *
+		 * @throws std::runtime_error If the header is not a structured object type declaration
+		 * @throws std::runtime_error If a field TypeTag is invalid or a field name or type ID string is empty or not valid UTF-8
+		 * @throws std::runtime_error If the declaration does not end with a scope boundary after the declared number of fields
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		StructuredTypeLayout ReadTypeDeclaration(const ValueHeader& header, const StructuredTypeLayout::allocator_type& alloc = {});
+
+		/**
+		 * @brief Read the body of a structured object type declaration whose header was just read into an existing layout
+		 *
+		 * The fields and strings of the layout are reused, so reading many declarations into the same layout does not allocate once it has grown large enough.
+		 *
+		 * @param header The header of the declaration
+		 * @param layout The layout to overwrite with the declared type layout
+		 *
+		 * @throws std::runtime_error If the header is not a structured object type declaration
+		 * @throws std::runtime_error If a field TypeTag is invalid or a field name or type ID string is empty or not valid UTF-8
+		 * @throws std::runtime_error If the declaration does not end with a scope boundary after the declared number of fields
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		void ReadTypeDeclaration(const ValueHeader& header, StructuredTypeLayout& layout);
 
 		/**
 		 * @brief Read an integer value from the stream
@@ -109,6 +197,29 @@ namespace libjaguar {
 		 */
 		bool ReadBool();
 
+		/**
+		 * @brief Read a number or boolean value, with the type chosen at compile time from its TypeTag
+		 *
+		 * @tparam Tag The TypeTag of the value
+		 *
+		 * @return The read value, as the matching C++ type (e.g. @c uint16_t for TypeTag::UInt16)
+		 *
+		 * @throws std::runtime_error If a boolean value is not a possible boolean
+		 * @throws std::runtime_error If an IO error occurs while reading
+		 */
+		template<TypeTag Tag>
+			requires fixed_size_tag<Tag>
+		tag_type_t<Tag> Read() {
+			using T = tag_type_t<Tag>;
+			if constexpr(std::is_same_v<T, bool>) {
+				return ReadBool();
+			} else if constexpr(std::is_floating_point_v<T>) {
+				return ReadFloat<T>();
+			} else {
+				return ReadInteger<T>();
+			}
+		}
+
 		/**
 		 * @brief Read a string from the stream
 		 *
@@ -139,12 +250,94 @@ namespace libjaguar {
 		 */
 		SVHandle ReadBuffer(uint32_t length);
 
+		/**
+		 * @brief Create a reader over a block of memory, which is read in place
+		 *
+		 * Child readers opened from a memory reader (see OpenRegion) read the same memory in place too, so nothing is copied.
+		 *
+		 * @param data The Jaguar data (must outlive the reader and any child readers)
+		 *
+		 * @return The reader
+		 */
+		static Reader FromMemory(std::span<const unsigned char> data);
+
+		/**
+		 * @brief Create a reader whose stream is read ahead on a dedicated I/O thread
+		 *
+		 * The I/O thread reads large blocks from the stream into a ring, while the consumer (for example, a Decoder running Parse()) works through the blocks that
+		 * are already there, so reading and parsing overlap. The ring holds at most @c depth blocks; once it is full, the I/O thread waits for the consumer to catch up.
+		 *
+		 * Positions and seeking work as usual. Seeks within the data the ring is reading anyway keep the pipeline running, while other seeks restart it at the
+		 * target, so this is meant for mostly sequential reading, such as a full parse of a stream on slow or high-latency storage.
+		 *
+		 * @param istream The stream containing Jaguar data (only accessed from the I/O thread from now on)
+		 * @param options Pipeline settings
+		 *
+		 * @return The reader
+		 *
+		 * @throws std::runtime_error If the stream is null
+		 */
+		static Reader Pipelined(std::unique_ptr<std::istream>&& istream, const PipelineOptions& options = {});
+
+		/**
+		 * @brief Point the reader at a new block of memory, as if it had been created with FromMemory()
+		 *
+		 * A reader that already reads memory or a byte range (see FromMemory and OpenRegion) keeps its stream, so resetting it does not allocate anything. This makes
+		 * one reader enough for any number of small messages. Any active scoped read view is invalidated.
+		 *
+		 * @param data The Jaguar data (must outlive the reader and any child readers)
+		 */
+		void Reset(std::span<const unsigned char> data);
+
+		/**
+		 * @brief Replace the stream of the reader, invalidating any active scoped read view
+		 *
+		 * @param istream The new stream containing Jaguar data
+		 */
+		void Reset(std::unique_ptr<std::istream>&& istream);
+
+		/**
+		 * @brief Open a child reader over a byte range of this reader's stream
+		 *
+		 * The child sees the range as a stream of its own, starting at position 0, so it can be given to a Decoder to parse a substream in place. For a memory
+		 * reader, the child reads the same memory. Otherwise, the child reads directly from this reader's stream buffer at the range's position and then restores the
+		 * previous position, so this reader is unaffected and the two can be used alternately (but not from different threads at once).
+		 *
+		 * @param begin The position of the range in this reader's stream
+		 * @param size The size of the range in bytes
+		 *
+		 * @return The child reader (must not outlive this reader)
+		 *
+		 * @throws std::runtime_error If the reader has no stream or a ScopedView is active
+		 */
+		Reader OpenRegion(std::streampos begin, uint64_t size);
+
+		/**
+		 * @brief Open a child reader over the body of a substream whose header was just read, and move this reader past the body
+		 *
+		 * @param header The header of the substream
+		 *
+		 * @return The child reader (see OpenRegion)
+		 *
+		 * @throws std::runtime_error If the header is not a substream header
+		 * @throws std::runtime_error If the stream is not seekable or ends before the substream does
+		 */
+		Reader OpenSubstream(const ValueHeader& header);
+
 	  private:
+		friend class ReaderPool;
+
 		std::unique_ptr<std::istream> stream;
 		std::unique_ptr<ScopedView> view;
 		std::shared_ptr<bool> viewState;
 
 		uint64_t _ReadIntegerInternal(uint8_t bits);
+		void _ReadHeaderDataInternal(ValueHeader& header);
+		void _SkipBodyInternal(const ValueHeader& header, uint8_t depth);
+		void _DiscardInternal(uint64_t byteCount);
+		void _SeekPastInternal(std::streampos begin, uint64_t size);
+		void _ReadShortStringInternal(std::pmr::string& out, const char* what);
+		void _InvalidateViewInternal();
 		void VerifyOk();
 	};
 }
\ No newline at end of file
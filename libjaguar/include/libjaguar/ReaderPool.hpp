@@ -0,0 +1,75 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Reader.hpp"
+#include "ValueHeader.hpp"
+
+#include <cstdint>
+#include <ios>
+#include <mutex>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief A pool of reusable child readers over byte ranges of a parent reader
+	 *
+	 * Opening a child reader (see Reader::OpenRegion) allocates its stream and read buffer. Archives with many substreams can instead acquire children from a pool and
+	 * release them when done, after which their streams are pointed at the next range without allocating anything.
+	 *
+	 * Acquiring and releasing are thread-safe. Children of a memory reader may also be read from on different threads at once; children of any other reader share
+	 * the parent's stream buffer and must not be used concurrently with each other or the parent.
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI ReaderPool {
+	  public:
+		/**
+		 * @brief Create a pool of child readers for a parent reader
+		 *
+		 * @param parent The parent reader (must outlive the pool and every child acquired from it)
+		 */
+		explicit ReaderPool(Reader& parent);
+
+		///@cond
+		ReaderPool(const ReaderPool&) = delete;
+		ReaderPool& operator=(const ReaderPool&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Get a child reader over a byte range of the parent, reusing a released one if possible
+		 *
+		 * @param begin The position of the range in the parent's stream
+		 * @param size The size of the range in bytes
+		 *
+		 * @return The child reader
+		 *
+		 * @throws std::runtime_error If the range cannot be opened (see Reader::OpenRegion)
+		 */
+		Reader Acquire(std::streampos begin, uint64_t size);
+
+		/**
+		 * @brief Get a child reader over the body of a substream whose header was just read from the parent, and move the parent past the body
+		 *
+		 * @param header The header of the substream
+		 *
+		 * @return The child reader
+		 *
+		 * @throws std::runtime_error If the substream cannot be opened (see Reader::OpenSubstream)
+		 */
+		Reader AcquireSubstream(const ValueHeader& header);
+
+		/**
+		 * @brief Return a child reader to the pool
+		 *
+		 * Readers that were not acquired from a pool (or were moved from) are simply destroyed.
+		 *
+		 * @param child The child reader
+		 */
+		void Release(Reader&& child);
+
+	  private:
+		Reader& parent;
+		std::mutex mutex;
+		std::vector<Reader> released;
+	};
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "DllHelper.hpp"
 #include "Traits.hpp"
 
+#include <cstdint>
 #include <span>
 #include <istream>
 #include <memory>
@@ -71,6 +72,7 @@ namespace libjaguar {
 		}
 
 		///@cond
+		~ScopedView();
 		ScopedView(const ScopedView&) = delete;
 		ScopedView& operator=(const ScopedView&) = delete;
 		ScopedView(ScopedView&&) = delete;
@@ -86,6 +88,7 @@ namespace libjaguar {
 		std::streampos end;
 		bool valid;
 		bool eof;
+		uint64_t traceStart = 0;//Start of the view's trace span, or 0 if it is not traced
 
 		void _ReadInternal(std::span<unsigned char>& out, uint32_t byteCount);
 	};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "PreparedHeader.hpp"
+#include "StructuredTypeLayout.hpp"
+#include "TypeTags.hpp"
+#include "Writer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libjaguar {
+	/**
+	 * @brief Describes where the value of one field of a structured object type lives in a user struct
+	 *
+	 * Exactly one way of getting at the value is used, depending on the field type:
+	 * - Number, boolean, vector, and matrix fields are copied from @c offset (typically obtained with @c offsetof), in native byte order. Vectors and matrices are
+	 *   laid out like the math types (e.g. <tt>Vector<float, 3></tt>), and booleans must be a @c bool.
+	 * - String and byte buffer fields are read through @c bytes.
+	 * - Any field may instead be written by @c encode, which must write the complete field (header included) through the writer. Fields of other types (lists,
+	 *   objects, and substreams) require this.
+	 */
+	struct LJAPI FieldBinding {
+		std::string name;												///<Name of the field in the type layout
+		std::size_t offset = 0;											///<Byte offset of a fixed-size value within the struct
+		std::function<std::string_view(const void* element)> bytes;	///<Returns the contents of a string or byte buffer field
+		std::function<void(Writer& writer, const void* element)> encode;///<Writes the whole field for an element (overrides the other members)
+	};
+
+	/**
+	 * @brief Encoder for lists of structured objects that are stored as an array of user structs
+	 *
+	 * Every element of such a list repeats the same field headers, so the encoder precompiles the complete byte image of an element once. For each element, the image
+	 * is copied into an output buffer and the field values are patched into it from the struct. Only variable-size fields and fields with an @c encode function step
+	 * outside of that, and the buffer is written to the stream in large blocks.
+	 *
+	 * A prepared encoder is immutable and may be used from multiple threads (with different writers) at once.
+	 */
+	class LJAPI StructuredListEncoder {
+	  public:
+		/**
+		 * @brief Precompile the element template for a type layout and a set of field bindings
+		 *
+		 * @param layout The type layout of the list elements (must be valid)
+		 * @param bindings One binding per field of the layout, in any order
+		 * @param elementSize The size of one user struct (the distance between elements)
+		 *
+		 * @throws std::runtime_error If the layout is invalid (see ValidateTypeLayout)
+		 * @throws std::runtime_error If a field of the layout is not bound, or a binding does not name a field of the layout or names it more than once
+		 * @throws std::runtime_error If a binding cannot provide a value for its field (e.g. a fixed-size value that extends past the end of the struct)
+		 */
+		StructuredListEncoder(const StructuredTypeLayout& layout, std::span<const FieldBinding> bindings, std::size_t elementSize);
+
+		/**
+		 * @brief Write a complete list value (header and elements)
+		 *
+		 * @param writer The writer to write to
+		 * @param name The name of the list value
+		 * @param elements Pointer to the first struct
+		 * @param count The number of structs
+		 *
+		 * @throws std::runtime_error If the list name is invalid UTF-8 or has the wrong length
+		 * @throws std::runtime_error If a string field is invalid UTF-8 or longer than the 24-bit integer limit
+		 * @throws Any exception thrown by a binding
+		 */
+		void WriteList(Writer& writer, std::string_view name, const void* elements, uint32_t count) const;
+
+		/**
+		 * @brief Write a complete list value from a span of structs
+		 *
+		 * @tparam T The user struct type (its size must match the element size the encoder was created with)
+		 *
+		 * @param writer The writer to write to
+		 * @param name The name of the list value
+		 * @param elements The structs to write
+		 *
+		 * @throws std::runtime_error If @c T has the wrong size or there are more than 2^32 - 1 elements
+		 * @throws std::runtime_error If writing fails (see the untyped overload)
+		 */
+		template<typename T>
+		void WriteList(Writer& writer, std::string_view name, std::span<const T> elements) const {
+			if(sizeof(T) != elementSize) throw std::runtime_error("Struct type does not match the element size of the encoder!");
+			if(elements.size() > UINT32_MAX) throw std::runtime_error("Too many elements for a single list!");
+			WriteList(writer, name, elements.data(), static_cast<uint32_t>(elements.size()));
+		}
+
+		/**
+		 * @brief Write only list elements, without a header
+		 *
+		 * This allows a list to be written in batches after its header has been written separately (with the total element count).
+		 *
+		 * @param writer The writer to write to
+		 * @param elements Pointer to the first struct
+		 * @param count The number of structs
+		 *
+		 * @throws std::runtime_error If a string field is invalid UTF-8 or longer than the 24-bit integer limit
+		 * @throws Any exception thrown by a binding
+		 */
+		void WriteElements(Writer& writer, const void* elements, uint32_t count) const;
+
+		/**
+		 * @brief Get the type ID of the list elements
+		 *
+		 * @return The type ID
+		 */
+		const std::string& GetTypeID() const {
+			return typeID;
+		}
+
+	  private:
+		//A value copied from the struct into the element image
+		struct Patch {
+			std::size_t imageOffset;
+			std::size_t structOffset;
+			uint32_t size;
+			uint32_t componentSize;//For byte order correction
+		};
+
+		//A field that is written separately from the element image
+		struct VariableField {
+			TypeTag type;
+			FieldBinding binding;
+			std::optional<PreparedHeader> header;//Absent for fields with an encode function; the size is substituted per element
+		};
+
+		//A run of the element image, followed by a variable field (unless this is the last run)
+		struct Segment {
+			std::size_t imageBegin;
+			std::size_t imageEnd;
+			std::size_t firstPatch;
+			std::size_t lastPatch;
+			int variableField;//Index into variableFields, or -1 for the last segment
+		};
+
+		std::string typeID;
+		std::size_t elementSize;
+		std::vector<char> image;//Byte image of one element, with placeholders for fixed-size values
+		std::vector<Patch> patches;
+		std::vector<VariableField> variableFields;
+		std::vector<Segment> segments;
+	};
+}
\ No newline at end of file
@@ -3,41 +3,88 @@
 #include "DllHelper.hpp"
 #include "TypeTags.hpp"
 
+#include <cstdint>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
 namespace libjaguar {
 	/**
 	 * @brief Layout description of a structured object type
+	 *
+	 * Like the Index, layouts allocate from a polymorphic memory resource (the default resource unless another allocator is given).
 	 */
 	struct LJAPI StructuredTypeLayout {
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
 		/**
 		 * @brief Description of a field in a type layout
 		 */
 		struct LJAPI Field {
+			using allocator_type = std::pmr::polymorphic_allocator<>;
+
 			///@name Generic properties for all fields
 			///@{
-			TypeTag type;	 ///<The type of the value (may not be scope boundary or type declaration)
-			std::string name;///<UTF-8 encoded field name
+			TypeTag type{};		  ///<The type of the value (may not be scope boundary or type declaration)
+			std::pmr::string name;///<UTF-8 encoded field name
 
 			///@}
 
 			///@name Type-specific properties
 			///@{
-			TypeTag elementType;	  ///<Type of contained element (for vectors, matrices, and lists)
-			std::string elementTypeID;///<Type ID for a structured object or a list containing structured objects
-			uint8_t width;			  ///<Number of components in a vector or columns in a matrix
-			uint8_t height;			  ///<Number of rows in a matrix
+			TypeTag elementType{};		   ///<Type of contained element (for vectors, matrices, and lists)
+			std::pmr::string elementTypeID;///<Type ID for a structured object or a list containing structured objects
+			uint8_t width = 0;			   ///<Number of components in a vector or columns in a matrix
+			uint8_t height = 0;			   ///<Number of rows in a matrix
 
 			///@}
+
+			///@cond
+			Field() = default;
+			explicit Field(const allocator_type& alloc) : name(alloc), elementTypeID(alloc) {}
+			Field(const Field&) = default;
+			Field(Field&&) = default;
+			Field(const Field& other, const allocator_type& alloc)
+			  : type(other.type), name(other.name, alloc), elementType(other.elementType), elementTypeID(other.elementTypeID, alloc), width(other.width), height(other.height) {}
+			Field(Field&& other, const allocator_type& alloc)
+			  : type(other.type), name(std::move(other.name), alloc), elementType(other.elementType), elementTypeID(std::move(other.elementTypeID), alloc), width(other.width),
+				height(other.height) {}
+			Field& operator=(const Field&) = default;
+			Field& operator=(Field&&) = default;
+
+			allocator_type get_allocator() const {
+				return name.get_allocator();
+			}
+			///@endcond
 		};
 
-		std::string typeID;		  ///<Type name (UTF-8 encoded)
-		std::vector<Field> fields;///<List of fields
+		std::pmr::string typeID;		///<Type name (UTF-8 encoded)
+		std::pmr::vector<Field> fields;///<List of fields
+
+		///@cond
+		StructuredTypeLayout() = default;
+		explicit StructuredTypeLayout(const allocator_type& alloc) : typeID(alloc), fields(alloc) {}
+		StructuredTypeLayout(const StructuredTypeLayout&) = default;
+		StructuredTypeLayout(StructuredTypeLayout&&) = default;
+		StructuredTypeLayout(const StructuredTypeLayout& other, const allocator_type& alloc) : typeID(other.typeID, alloc), fields(other.fields, alloc) {}
+		StructuredTypeLayout(StructuredTypeLayout&& other, const allocator_type& alloc) : typeID(std::move(other.typeID), alloc), fields(std::move(other.fields), alloc) {}
+		StructuredTypeLayout& operator=(const StructuredTypeLayout&) = default;
+		StructuredTypeLayout& operator=(StructuredTypeLayout&&) = default;
+
+		allocator_type get_allocator() const {
+			return typeID.get_allocator();
+		}
+		///@endcond
 	};
 
 	/**
 	 * @brief Check if the provided type layout is valid
+	 *
+	 * A valid layout has a non-empty UTF-8 type ID and at most 65535 uniquely-named fields, each of which has a legal type and (for generic types) a legal element type and shape.
+	 *
+	 * @param layout The layout to check
+	 *
+	 * @return Whether the layout is valid
 	 */
-	bool ValidateTypeLayout(const StructuredTypeLayout& layout);
+	LJAPI bool ValidateTypeLayout(const StructuredTypeLayout& layout);
 }
\ No newline at end of file
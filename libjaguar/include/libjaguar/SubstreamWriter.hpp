@@ -0,0 +1,90 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "Writer.hpp"
+
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace libjaguar {
+	class SpillStreambuf;
+
+	/**
+	 * @brief Writes a substream value by streaming its body, without holding the whole body in memory
+	 *
+	 * A substream header contains the size of its body, which is usually unknown until the body has been written. If the parent stream is seekable, the header is written
+	 * right away with a placeholder size, the body is written straight to the parent stream, and Finish() goes back to fill in the size. Otherwise, the body is collected
+	 * in memory up to a limit, and moved to a temporary file once it grows beyond that; Finish() then writes the header and copies the body over.
+	 *
+	 * Substreams may not contain other substreams, so the writer of a substream writer cannot be the parent of another one.
+	 *
+	 * @warning The parent writer must not be used until Finish() has returned. If Finish() is never called, the parent stream is left with an incomplete value.
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI SubstreamWriter {
+	  public:
+		///Default amount of body data kept in memory for a non-seekable parent before moving it to a temporary file
+		static constexpr std::size_t defaultMemoryLimit = 4 * 1024 * 1024;//4 MiB (one MiB is 1024 KiB)
+
+		/**
+		 * @brief Begin a substream value
+		 *
+		 * @param parent The writer to write the substream value to
+		 * @param name The name of the substream value
+		 * @param memoryLimit The maximum number of body bytes to keep in memory if the parent stream is not seekable
+		 *
+		 * @throws std::runtime_error If the parent writer has no backing stream
+		 * @throws std::runtime_error If the parent writer is the writer of another substream writer
+		 * @throws std::runtime_error If the name is invalid UTF-8 or has the wrong length
+		 * @throws std::runtime_error If writing the placeholder header fails
+		 */
+		SubstreamWriter(Writer& parent, std::string_view name, std::size_t memoryLimit = defaultMemoryLimit);
+		~SubstreamWriter();
+
+		///@cond
+		SubstreamWriter(const SubstreamWriter&) = delete;
+		SubstreamWriter& operator=(const SubstreamWriter&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Get the writer for the substream body
+		 *
+		 * @return The writer
+		 */
+		Writer& GetWriter() {
+			return writer;
+		}
+
+		/**
+		 * @brief Check if the body is written straight to the parent stream (and the size backpatched)
+		 *
+		 * @return @c true for a seekable parent stream, @c false if the body is collected first
+		 */
+		bool IsBackpatching() const {
+			return !spill;
+		}
+
+		/**
+		 * @brief Complete the substream value by filling in its size (and copying the collected body, for a non-seekable parent)
+		 *
+		 * @throws std::runtime_error If the substream was already finished
+		 * @throws std::runtime_error If the body is larger than 4 GiB
+		 * @throws std::runtime_error If an IO error occurred while writing the body or the parent stream
+		 */
+		void Finish();
+
+	  private:
+		Writer& parent;
+		std::string name;
+		std::unique_ptr<SpillStreambuf> spill;
+		Writer writer;
+		std::streampos bodyPosition;
+		bool finished;
+
+		void _RegisterInternal();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DllHelper.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace libjaguar {
+	/**
+	 * @brief A span of work recorded while tracing (see StartTracing)
+	 *
+	 * The views are only valid during the callback that receives the event.
+	 */
+	struct LJAPI TraceEvent {
+		std::string_view name;	  ///<What was done: @c Parse, @c ParseAvailable, @c Scope, @c ReadHeader, @c OpenSubstream, @c View, or @c Flush
+		std::string_view category;///<The component that did it: @c decoder, @c reader, or @c writer
+		std::string_view detail;  ///<The name of the scope, for @c Scope events (empty otherwise)
+		uint64_t timestamp;		  ///<When the span started, in nanoseconds since tracing started
+		uint64_t duration;		  ///<How long the span took, in nanoseconds
+		uint32_t threadID;		  ///<Small number identifying the thread that did the work, counted from 1
+	};
+
+	/**
+	 * @brief Settings for tracing
+	 */
+	struct LJAPI TraceOptions {
+		uint32_t sampleInterval = 1;///<Record only every n-th @c ReadHeader and @c Scope span of each thread, so that tracing a full parse stays cheap (other spans are always recorded)
+	};
+
+	/**
+	 * @brief Receives trace events as they are recorded
+	 *
+	 * Calls are serialized, but may come from any thread that uses libjaguar (including the flush threads of asynchronous writers). The callback must not use libjaguar
+	 * itself; exceptions it throws are ignored.
+	 */
+	using TraceCallback = std::function<void(const TraceEvent& event)>;
+
+	/**
+	 * @brief Check if libjaguar was built with tracing support
+	 *
+	 * Tracing is only compiled in if the library is built with the @c tracing option; otherwise it costs nothing. Compiled in but not started, each traced spot costs
+	 * one atomic load.
+	 *
+	 * @return @c true if StartTracing() can be used
+	 */
+	LJAPI bool IsTracingAvailable();
+
+	/**
+	 * @brief Start passing trace events of all readers, decoders, and writers to a callback
+	 *
+	 * Tracing is process-wide; starting it again replaces the previous destination (a previous trace file is finished first).
+	 *
+	 * @param callback The callback
+	 * @param options Tracing settings
+	 *
+	 * @throws std::runtime_error If libjaguar was built without tracing support
+	 */
+	LJAPI void StartTracing(TraceCallback callback, const TraceOptions& options = {});
+
+	/**
+	 * @brief Start writing trace events of all readers, decoders, and writers to a file
+	 *
+	 * The file uses the JSON format of Chrome's trace viewer, which Perfetto and @c chrome://tracing can open. It is complete once StopTracing() is called.
+	 *
+	 * @param path The path of the file, which is overwritten
+	 * @param options Tracing settings
+	 *
+	 * @throws std::runtime_error If libjaguar was built without tracing support
+	 * @throws std::runtime_error If the file cannot be opened
+	 */
+	LJAPI void StartTracing(const std::string& path, const TraceOptions& options = {});
+
+	/**
+	 * @brief Stop tracing, finishing the trace file if there is one
+	 *
+	 * Spans that are still open are not recorded. Does nothing if tracing was not started.
+	 *
+	 * @throws std::runtime_error If the trace file cannot be written
+	 */
+	LJAPI void StopTracing();
+}
\ No newline at end of file
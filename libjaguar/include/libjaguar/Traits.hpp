@@ -1,5 +1,8 @@
 #pragma once
 
+#include "TypeTags.hpp"
+
+#include <bit>
 #include <cstdint>
 #include <ranges>
 #include <type_traits>
@@ -92,5 +95,101 @@ namespace libjaguar {
 
 	template<typename T>
 	concept byte_range = std::ranges::range<T> && is_byte_range_v<T>;
+
+	template<typename T>
+	struct type_tag {};
+
+	template<>
+	struct type_tag<bool> : public std::integral_constant<TypeTag, TypeTag::Boolean> {};
+	template<>
+	struct type_tag<int8_t> : public std::integral_constant<TypeTag, TypeTag::SInt8> {};
+	template<>
+	struct type_tag<int16_t> : public std::integral_constant<TypeTag, TypeTag::SInt16> {};
+	template<>
+	struct type_tag<int32_t> : public std::integral_constant<TypeTag, TypeTag::SInt32> {};
+	template<>
+	struct type_tag<int64_t> : public std::integral_constant<TypeTag, TypeTag::SInt64> {};
+	template<>
+	struct type_tag<uint8_t> : public std::integral_constant<TypeTag, TypeTag::UInt8> {};
+	template<>
+	struct type_tag<uint16_t> : public std::integral_constant<TypeTag, TypeTag::UInt16> {};
+	template<>
+	struct type_tag<uint32_t> : public std::integral_constant<TypeTag, TypeTag::UInt32> {};
+	template<>
+	struct type_tag<uint64_t> : public std::integral_constant<TypeTag, TypeTag::UInt64> {};
+	template<>
+	struct type_tag<float> : public std::integral_constant<TypeTag, TypeTag::Float32> {};
+	template<>
+	struct type_tag<double> : public std::integral_constant<TypeTag, TypeTag::Float64> {};
+
+	template<typename T>
+	inline constexpr TypeTag type_tag_v = type_tag<T>::value;
+
+	template<TypeTag Tag>
+	struct tag_type {};
+
+	template<>
+	struct tag_type<TypeTag::Boolean> {
+		using type = bool;
+	};
+	template<>
+	struct tag_type<TypeTag::SInt8> {
+		using type = int8_t;
+	};
+	template<>
+	struct tag_type<TypeTag::SInt16> {
+		using type = int16_t;
+	};
+	template<>
+	struct tag_type<TypeTag::SInt32> {
+		using type = int32_t;
+	};
+	template<>
+	struct tag_type<TypeTag::SInt64> {
+		using type = int64_t;
+	};
+	template<>
+	struct tag_type<TypeTag::UInt8> {
+		using type = uint8_t;
+	};
+	template<>
+	struct tag_type<TypeTag::UInt16> {
+		using type = uint16_t;
+	};
+	template<>
+	struct tag_type<TypeTag::UInt32> {
+		using type = uint32_t;
+	};
+	template<>
+	struct tag_type<TypeTag::UInt64> {
+		using type = uint64_t;
+	};
+	template<>
+	struct tag_type<TypeTag::Float32> {
+		using type = float;
+	};
+	template<>
+	struct tag_type<TypeTag::Float64> {
+		using type = double;
+	};
+
+	template<TypeTag Tag>
+	using tag_type_t = typename tag_type<Tag>::type;
+
+	template<TypeTag Tag>
+	concept fixed_size_tag = requires { typename tag_type<Tag>::type; };
+
+	template<number T>
+	T LoadLittleEndian(const unsigned char* bytes) {
+		uint64_t work = 0;
+		for(uint8_t i = 0; i < sizeof(T); ++i) work |= (uint64_t(bytes[i]) << (i * 8));
+		if constexpr(std::is_same_v<T, float>) {
+			return std::bit_cast<float, uint32_t>(static_cast<uint32_t>(work));
+		} else if constexpr(std::is_same_v<T, double>) {
+			return std::bit_cast<double, uint64_t>(work);
+		} else {
+			return static_cast<T>(work);
+		}
+	}
 	///@endcond
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "DllHelper.hpp"
+#include "StructuredTypeLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace libjaguar {
+	struct Index;
+
+	/**
+	 * @brief Compute a hash over everything that makes up a type layout
+	 *
+	 * Two layouts with the same type ID, fields, and field order have the same hash, regardless of their allocators.
+	 *
+	 * @param layout The layout
+	 *
+	 * @return The hash
+	 */
+	LJAPI uint64_t HashTypeLayout(const StructuredTypeLayout& layout);
+
+	/**
+	 * @brief An immutable set of structured type layouts that many decoders and encoders can share
+	 *
+	 * Protocols that send one small stream per message usually start every stream with the same type declarations. A registry holds those layouts once, so that a
+	 * Decoder given the registry (see DecodeOptions) does not store its own copy of every declaration that matches a registered layout, and an Encoder can write all
+	 * declarations at once from bytes that were encoded in advance.
+	 *
+	 * Registries are only handed out as @c std::shared_ptr<const TypeRegistry>. Since they never change after creation, any number of threads may use one at the same
+	 * time, and the last decoder, encoder, or index referring to it frees it. A registry can be set up from known layouts with Create(), or learned from the index
+	 * of a first stream with FromIndex().
+	 *
+	 * <b>This class is neither copyable nor movable!</b>
+	 */
+	class LJAPI TypeRegistry {
+	  public:
+		/**
+		 * @brief Create a registry from a set of layouts
+		 *
+		 * @param layouts The layouts, in the order in which their declarations are written
+		 *
+		 * @return The registry
+		 *
+		 * @throws std::runtime_error If a layout is invalid (see ValidateTypeLayout)
+		 * @throws std::runtime_error If two layouts have the same type ID
+		 */
+		static std::shared_ptr<const TypeRegistry> Create(std::span<const StructuredTypeLayout> layouts);
+
+		/**
+		 * @brief Create a registry holding all types declared in a parsed stream
+		 *
+		 * Layouts are ordered by type ID, so that streams with the same declarations produce the same registry.
+		 *
+		 * @param index The index of the stream
+		 *
+		 * @return The registry
+		 *
+		 * @throws std::runtime_error If a layout is invalid (see ValidateTypeLayout)
+		 */
+		static std::shared_ptr<const TypeRegistry> FromIndex(const Index& index);
+
+		///@cond
+		TypeRegistry(const TypeRegistry&) = delete;
+		TypeRegistry& operator=(const TypeRegistry&) = delete;
+		///@endcond
+
+		/**
+		 * @brief Get all registered layouts
+		 *
+		 * @return The layouts, in the order given at creation
+		 */
+		std::span<const StructuredTypeLayout> GetLayouts() const {
+			return layouts;
+		}
+
+		/**
+		 * @brief Find a layout by its type ID
+		 *
+		 * @param typeID The type ID
+		 *
+		 * @return The layout, or @c nullptr if no layout with that type ID is registered
+		 */
+		const StructuredTypeLayout* Find(std::string_view typeID) const;
+
+		/**
+		 * @brief Find the registered layout that is identical to a given one
+		 *
+		 * Candidates are compared by hash (see HashTypeLayout) first, and only a hash match is compared field by field.
+		 *
+		 * @param layout The layout to look for
+		 *
+		 * @return The registered layout, or @c nullptr if none has the same type ID and fields
+		 */
+		const StructuredTypeLayout* FindMatching(const StructuredTypeLayout& layout) const;
+
+		/**
+		 * @brief Get the declarations of all registered layouts, as they are written to a stream
+		 *
+		 * @return The encoded declarations, in layout order
+		 */
+		std::span<const unsigned char> GetEncodedDeclarations() const {
+			return encodedDeclarations;
+		}
+
+	  private:
+		std::vector<StructuredTypeLayout> layouts;
+		std::vector<uint64_t> hashes;
+		std::unordered_map<std::string_view, std::size_t> byTypeID;//Views into the type IDs of the layouts
+		std::vector<unsigned char> encodedDeclarations;
+
+		explicit TypeRegistry(std::vector<StructuredTypeLayout>&& layouts);
+	};
+}
\ No newline at end of file
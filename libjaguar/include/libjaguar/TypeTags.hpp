@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 namespace libjaguar {
@@ -30,15 +31,125 @@ namespace libjaguar {
 		Matrix = 0x4B				 ///<Matrix of numbers, size from 2x2 to 4x4
 	};
 
+	/**
+	 * @brief Broad classes of TypeTags
+	 */
+	enum class TypeCategory : uint8_t {
+		Invalid,		///<Not a valid TypeTag
+		Buffer,			///<String, byte buffer, or substream (sized body)
+		Boolean,		///<Boolean
+		FloatingPoint,	///<32 or 64-bit floating-point number
+		SignedInteger,	///<Signed integer
+		UnsignedInteger,///<Unsigned integer
+		Container,		///<List, vector, or matrix (elements described by the header)
+		Object,			///<Unstructured or structured object
+		Declaration,	///<Structured object type declaration
+		Boundary		///<Scope boundary
+	};
+
+	/**
+	 * @brief Flags for the type-specific header fields that follow a value identifier, in the order in which they appear in the stream
+	 */
+	namespace HeaderField {
+		inline constexpr uint8_t ElementType = 1 << 0;  ///<Element TypeTag (lists, vectors, and matrices)
+		inline constexpr uint8_t ElementTypeID = 1 << 1;///<Element type ID, only present if the element type is a structured object (lists)
+		inline constexpr uint8_t TypeID = 1 << 2;		///<Type ID (structured objects and type declarations)
+		inline constexpr uint8_t Width = 1 << 3;		///<Width (vectors and matrices)
+		inline constexpr uint8_t Height = 1 << 4;		///<Height (matrices)
+		inline constexpr uint8_t FieldCount = 1 << 5;	///<16-bit field count (unstructured objects and type declarations)
+		inline constexpr uint8_t Size = 1 << 6;			///<32-bit element count or body size (lists and buffers)
+	}
+
+	/**
+	 * @brief Static properties of a TypeTag
+	 */
+	struct TypeTagInfo {
+		bool valid;			  ///<Whether the tag is a valid TypeTag
+		TypeCategory category;///<The class of the tag
+		uint8_t size;		  ///<Size of the body in bytes if it is always the same (numbers and booleans), 0 otherwise
+		bool scope;			  ///<Whether the tag opens or closes an object scope (objects, type declarations, and scope boundaries)
+		uint8_t headerFields; ///<The type-specific header fields (see HeaderField)
+	};
+
+	///@cond
+	constexpr std::array<TypeTagInfo, 256> MakeTypeTagTable() {
+		std::array<TypeTagInfo, 256> table = {};
+		auto set = [&](TypeTag tag, TypeCategory category, uint8_t size, uint8_t headerFields) {
+			const bool scope = (category == TypeCategory::Object || category == TypeCategory::Declaration || category == TypeCategory::Boundary);
+			table[static_cast<uint8_t>(tag)] = {true, category, size, scope, headerFields};
+		};
+		set(TypeTag::String, TypeCategory::Buffer, 0, HeaderField::Size);
+		set(TypeTag::ByteBuffer, TypeCategory::Buffer, 0, HeaderField::Size);
+		set(TypeTag::Substream, TypeCategory::Buffer, 0, HeaderField::Size);
+		set(TypeTag::Boolean, TypeCategory::Boolean, 1, 0);
+		set(TypeTag::Float32, TypeCategory::FloatingPoint, 4, 0);
+		set(TypeTag::Float64, TypeCategory::FloatingPoint, 8, 0);
+		set(TypeTag::SInt8, TypeCategory::SignedInteger, 1, 0);
+		set(TypeTag::SInt16, TypeCategory::SignedInteger, 2, 0);
+		set(TypeTag::SInt32, TypeCategory::SignedInteger, 4, 0);
+		set(TypeTag::SInt64, TypeCategory::SignedInteger, 8, 0);
+		set(TypeTag::UInt8, TypeCategory::UnsignedInteger, 1, 0);
+		set(TypeTag::UInt16, TypeCategory::UnsignedInteger, 2, 0);
+		set(TypeTag::UInt32, TypeCategory::UnsignedInteger, 4, 0);
+		set(TypeTag::UInt64, TypeCategory::UnsignedInteger, 8, 0);
+		set(TypeTag::List, TypeCategory::Container, 0, HeaderField::ElementType | HeaderField::ElementTypeID | HeaderField::Size);
+		set(TypeTag::UnstructuredObj, TypeCategory::Object, 0, HeaderField::FieldCount);
+		set(TypeTag::StructuredObj, TypeCategory::Object, 0, HeaderField::TypeID);
+		set(TypeTag::StructuredObjTypeDecl, TypeCategory::Declaration, 0, HeaderField::TypeID | HeaderField::FieldCount);
+		set(TypeTag::ScopeBoundary, TypeCategory::Boundary, 0, 0);
+		set(TypeTag::Vector, TypeCategory::Container, 0, HeaderField::ElementType | HeaderField::Width);
+		set(TypeTag::Matrix, TypeCategory::Container, 0, HeaderField::ElementType | HeaderField::Width | HeaderField::Height);
+		return table;
+	}
+	///@endcond
+
+	/**
+	 * @brief Properties of every possible tag byte, indexed by the byte
+	 */
+	inline constexpr std::array<TypeTagInfo, 256> typeTagTable = MakeTypeTagTable();
+
+	/**
+	 * @brief Look up the properties of a TypeTag
+	 *
+	 * @param tag The tag (which may be any byte read from a stream)
+	 *
+	 * @return The properties
+	 */
+	constexpr const TypeTagInfo& GetTypeTagInfo(TypeTag tag) {
+		return typeTagTable[static_cast<uint8_t>(tag)];
+	}
+
+	/**
+	 * @brief Check if a byte is a valid TypeTag
+	 *
+	 * @param tagByte The byte to check
+	 *
+	 * @return @c true if the byte is one of the TypeTag values
+	 */
+	constexpr bool IsValidTypeTag(uint8_t tagByte) {
+		return typeTagTable[tagByte].valid;
+	}
+
+	/**
+	 * @brief Get the size of the body of a value that always has the same size
+	 *
+	 * @param type The type of the value
+	 *
+	 * @return The size in bytes for numbers and booleans, 0 for all other types
+	 */
+	constexpr uint32_t GetTypeSize(TypeTag type) {
+		return typeTagTable[static_cast<uint8_t>(type)].size;
+	}
+
 	/**
 	 * @brief Check if a given TypeTag represents a value or a scope
 	 *
-	 * @param tag The tag to checl
+	 * @param tag The tag to check
 	 *
-	 * @return @c true if the TypeTag is a value, @c false if it's a scope
+	 * @return @c true if the TypeTag is a value (including lists), @c false if it opens or closes an object scope or is not a valid TypeTag
 	 */
-	inline bool IsValue(TypeTag tag) {
-		uint8_t asUint = static_cast<uint8_t>(tag);
-		return ((asUint >> 4) == 0x3) && ((asUint & 0xF) != 0xE);
+	constexpr bool IsValue(TypeTag tag) {
+		const TypeTagInfo& info = GetTypeTagInfo(tag);
+		return info.valid && !info.scope;
 	}
 }
\ No newline at end of file
@@ -3,29 +3,59 @@
 #include "DllHelper.hpp"
 #include "TypeTags.hpp"
 
+#include <cstdint>
+#include <memory_resource>
 #include <string>
 
 namespace libjaguar {
 	/**
 	 * @brief Header for a Jaguar value, declaring metadata needed to read the contents
+	 *
+	 * Strings are allocated from a polymorphic memory resource (the default resource unless another allocator is given), so headers can be read into an arena.
 	 */
 	struct LJAPI ValueHeader {
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
 		///@name Generic data for all headers (the "value identifier")
 		///@{
-		TypeTag type;	 ///<The type of the value
-		std::string name;///<UTF-8 encoded field name
+		TypeTag type{};		  ///<The type of the value
+		std::pmr::string name;///<UTF-8 encoded field name
 
 		///@}
 
 		///@name Type-specific data
 		///@{
-		TypeTag elementType;///<Type of contained element (for vectors, matrices, and lists)
-		uint32_t size;		///<Number of elements in a list, or size of a buffer object (string, byte buffer, substream); string size must be less than 24-bit integer limit
-		uint8_t width;		///<Number of components in a vector or columns in a matrix
-		uint8_t height;		///<Number of rows in a matrix
-		uint16_t fieldCount;///<Number of fields in an unstructured object or a structured object type declaration
-		std::string typeID; ///<Structured object type ID (for freestanding structured object or list with a structured object element type)
+		TypeTag elementType{};	 ///<Type of contained element (for vectors, matrices, and lists)
+		uint32_t size = 0;		 ///<Number of elements in a list, or size of a buffer object (string, byte buffer, substream); string size must be less than 24-bit integer limit
+		uint8_t width = 0;		 ///<Number of components in a vector or columns in a matrix
+		uint8_t height = 0;		 ///<Number of rows in a matrix
+		uint16_t fieldCount = 0; ///<Number of fields in an unstructured object or a structured object type declaration
+		std::pmr::string typeID; ///<Structured object type ID (for freestanding structured object or list with a structured object element type)
 
 		///@}
+
+		///@cond
+		ValueHeader() = default;
+		explicit ValueHeader(const allocator_type& alloc) : name(alloc), typeID(alloc) {}
+		ValueHeader(const ValueHeader&) = default;
+		ValueHeader(ValueHeader&&) = default;
+		ValueHeader(const ValueHeader& other, const allocator_type& alloc)
+		  : type(other.type), name(other.name, alloc), elementType(other.elementType), size(other.size), width(other.width), height(other.height), fieldCount(other.fieldCount),
+			typeID(other.typeID, alloc) {}
+		ValueHeader(ValueHeader&& other, const allocator_type& alloc)
+		  : type(other.type), name(std::move(other.name), alloc), elementType(other.elementType), size(other.size), width(other.width), height(other.height),
+			fieldCount(other.fieldCount), typeID(std::move(other.typeID), alloc) {}
+		ValueHeader& operator=(const ValueHeader&) = default;
+		ValueHeader& operator=(ValueHeader&&) = default;
+		///@endcond
+
+		/**
+		 * @brief Get the allocator used for the strings of this header
+		 *
+		 * @return The allocator
+		 */
+		allocator_type get_allocator() const {
+			return name.get_allocator();
+		}
 	};
 }
\ No newline at end of file
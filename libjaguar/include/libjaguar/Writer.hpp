@@ -1,18 +1,30 @@
 #pragma once
 
 #include "DllHelper.hpp"
+#include "PreparedHeader.hpp"
 #include "ValueHeader.hpp"
+#include "StructuredTypeLayout.hpp"
 #include "Traits.hpp"
 
 #include <bit>
+#include <cstddef>
 #include <ostream>
 #include <cstdint>
 #include <ranges>
 #include <type_traits>
 #include <span>
 #include <memory>
+#include <string_view>
 
 namespace libjaguar {
+	/**
+	 * @brief Settings for an asynchronous writer (see Writer::Async)
+	 */
+	struct LJAPI AsyncWriteOptions {
+		std::size_t bufferSize = 1024 * 1024;///<Size of each buffer handed to the flush thread
+		std::size_t bufferCount = 2;		 ///<Number of buffers (writing only waits while all of them are in flight)
+	};
+
 	/**
 	 * @brief Low-level stateless Jaguar stream writer
 	 *
@@ -37,6 +49,24 @@ namespace libjaguar {
 		Writer& operator=(Writer&&);
 		///@endcond
 
+		/**
+		 * @brief Create a writer whose output is written to the stream on a dedicated flush thread
+		 *
+		 * Data is collected in one buffer at a time. Once a buffer is full, it is handed to the flush thread, which writes it to the stream while writing continues
+		 * into the next buffer, so encoding and I/O overlap. Writing only waits while all @c bufferCount buffers are in flight.
+		 *
+		 * Errors of the stream surface later than usual: once writing a buffer has failed, all further data is dropped and the next Flush() or Close() throws. If the
+		 * stream can seek, the writer can too (e.g. for a SubstreamWriter), but every seek waits for all buffered data to be written first.
+		 *
+		 * @param ostream The stream into which to write Jaguar data (only accessed from the flush thread from now on, except while seeking)
+		 * @param options Buffer settings
+		 *
+		 * @return The writer
+		 *
+		 * @throws std::runtime_error If the stream is null
+		 */
+		static Writer Async(std::unique_ptr<std::ostream>&& ostream, const AsyncWriteOptions& options = {});
+
 		/**
 		 * @brief Access the underlying stream to perform operations outside of the writer
 		 *
@@ -66,6 +96,23 @@ namespace libjaguar {
 		 */
 		void WriteHeader(const ValueHeader& header, bool noIdentifier = false);
 
+		/**
+		 * @brief Write a prepared value header to the stream
+		 *
+		 * @param header The prepared header to write (as it was encoded)
+		 */
+		void WriteHeader(const PreparedHeader& header);
+
+		/**
+		 * @brief Write a prepared value header to the stream, substituting the size it ends in
+		 *
+		 * @param header The prepared header to write
+		 * @param size The element count or buffer size to write in place of the prepared one
+		 *
+		 * @throws std::runtime_error If the header has no size (see PreparedHeader::HasSize)
+		 */
+		void WriteHeader(const PreparedHeader& header, uint32_t size);
+
 		/**
 		 * @brief Write an integer value to the stream
 		 *
@@ -104,6 +151,26 @@ namespace libjaguar {
 		 */
 		void WriteBool(bool value);
 
+		/**
+		 * @brief Write a number or boolean value, with the type chosen at compile time from its TypeTag
+		 *
+		 * @tparam Tag The TypeTag of the value
+		 *
+		 * @param value The value, as the matching C++ type (e.g. @c uint16_t for TypeTag::UInt16)
+		 */
+		template<TypeTag Tag>
+			requires fixed_size_tag<Tag>
+		void Write(tag_type_t<Tag> value) {
+			using T = tag_type_t<Tag>;
+			if constexpr(std::is_same_v<T, bool>) {
+				WriteBool(value);
+			} else if constexpr(std::is_floating_point_v<T>) {
+				WriteFloat<T>(value);
+			} else {
+				WriteInteger<T>(value);
+			}
+		}
+
 		/**
 		 * @brief Write a string to the stream
 		 *
@@ -112,7 +179,7 @@ namespace libjaguar {
 		 * @throws std::runtime_error If the string is not valid UTF-8
 		 * @throws std::runtime_error If the string is longer than the 24-bit integer limit for string legnths
 		 */
-		void WriteString(const std::string& value);
+		void WriteString(std::string_view value);
 
 		/**
 		 * @brief Write a buffer to the stream
@@ -122,8 +189,9 @@ namespace libjaguar {
 		 * @param value The buffer to write
 		 */
 		template<byte_range R>
+			requires std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
 		void WriteBuffer(const R& value) {
-			std::span<unsigned char> span(value.begin(), value.end());
+			std::span<const unsigned char> span(reinterpret_cast<const unsigned char*>(std::ranges::data(value)), std::ranges::size(value));
 			_WriteBufferInternal(span);
 		}
 
@@ -138,10 +206,53 @@ namespace libjaguar {
 		 */
 		void WriteBufferFromStream(std::istream* istream, std::size_t length);
 
+		/**
+		 * @brief Write a complete structured object type declaration to the stream
+		 *
+		 * This writes the declaration header (using the type ID as the value name), one identifier per field (plus the header data of lists, vectors, matrices, and structured objects), and the closing scope boundary.
+		 *
+		 * @param layout The type layout to declare
+		 *
+		 * @throws std::runtime_error If the layout is invalid (see ValidateTypeLayout)
+		 */
+		void WriteTypeDeclaration(const StructuredTypeLayout& layout);
+
+		/**
+		 * @brief Write out all buffered data and flush the stream
+		 *
+		 * For an asynchronous writer, this waits until the flush thread has written everything, and reports any error it ran into since the last flush.
+		 *
+		 * @throws std::runtime_error If the writer has no backing stream
+		 * @throws std::runtime_error If writing any of the data failed
+		 */
+		void Flush();
+
+		/**
+		 * @brief Flush and release the stream, after which the writer cannot be used anymore
+		 *
+		 * The stream is released even if flushing fails. Unlike destroying the writer, this reports errors of data that was still being written.
+		 *
+		 * @throws std::runtime_error If the writer has no backing stream
+		 * @throws std::runtime_error If writing any of the data failed
+		 */
+		void Close();
+
+		/**
+		 * @brief Replace the stream of the writer, handing back the previous one
+		 *
+		 * This lets one writer produce any number of small messages: the previous stream (with its buffer) can be read out, emptied, and passed back in for the next
+		 * message.
+		 *
+		 * @param ostream The new stream into which to write Jaguar data
+		 *
+		 * @return The previous stream, or @c nullptr if the writer had none
+		 */
+		std::unique_ptr<std::ostream> Reset(std::unique_ptr<std::ostream>&& ostream);
+
 	  private:
 		std::unique_ptr<std::ostream> stream;
 
 		void _WriteIntegerInternal(uint64_t value, uint8_t bits);
-		void _WriteBufferInternal(std::span<unsigned char>& value);
+		void _WriteBufferInternal(std::span<const unsigned char>& value);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "libjaguar/Columnar.hpp"
+#include "libjaguar/ValueHeader.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace libjaguar {
+	//Don't bother splitting lists into chunks smaller than this
+	constexpr inline uint32_t minRowsPerChunk = 1024;
+
+	//Decoding plan for a single field of the layout
+	struct ColumnPlan {
+		int column;				//Index of the destination column, or -1 if the field is skipped
+		uint32_t componentSize; //Size of a single number within a fixed-size element (for byte order correction)
+	};
+
+	//Per-chunk storage for variable-size columns
+	struct ChunkOutput {
+		std::vector<std::vector<unsigned char>> variableData;
+		std::exception_ptr error;
+	};
+
+	static bool IsFixedColumnType(TypeTag type) {
+		return GetTypeSize(type) > 0 || type == TypeTag::Vector || type == TypeTag::Matrix;
+	}
+
+	static void CheckFieldHeader(const ValueHeader& header, const StructuredTypeLayout::Field& field) {
+		if(header.type != field.type) throw std::runtime_error("Structured object field type does not match the type layout!");
+		if(header.type == TypeTag::Vector || header.type == TypeTag::Matrix) {
+			if(header.elementType != field.elementType || header.width != field.width) throw std::runtime_error("Structured object field shape does not match the type layout!");
+			if(header.type == TypeTag::Matrix && header.height != field.height) throw std::runtime_error("Structured object field shape does not match the type layout!");
+		}
+	}
+
+	//Decodes the rows [firstRow, lastRow) of a batch, whose elements start at the given offsets of the batch body and whose first row is batchRow
+	static void DecodeChunk(const char* body, const std::vector<uint64_t>& elementOffsets, uint32_t batchRow, uint32_t firstRow, uint32_t lastRow, const StructuredTypeLayout& layout,
+		const std::unordered_map<std::string_view, std::size_t>& fieldLookup, const std::vector<ColumnPlan>& plans, std::vector<Column>& columns, ChunkOutput& out) {
+		//Create a reader over just this chunk's bytes
+		const uint64_t chunkBegin = elementOffsets[firstRow];
+		Reader reader(std::make_unique<MemoryIstream>(body + chunkBegin, elementOffsets[lastRow] - chunkBegin));
+
+		std::vector<bool> seen(layout.fields.size());
+		for(uint32_t batchIdx = firstRow; batchIdx < lastRow; ++batchIdx) {
+			const uint64_t row = uint64_t(batchRow) + batchIdx;
+			std::fill(seen.begin(), seen.end(), false);
+			for(std::size_t f = 0; f < layout.fields.size(); ++f) {
+				ValueHeader header = reader.ReadHeader();
+				if(header.type == TypeTag::ScopeBoundary) throw std::runtime_error("Structured object is missing fields declared by its type layout!");
+
+				//Fields are almost always in declaration order, so try that before looking the name up
+				std::size_t fieldIdx = f;
+				if(layout.fields[f].name != header.name) {
+					auto it = fieldLookup.find(header.name);
+					if(it == fieldLookup.end()) throw std::runtime_error("Structured object contains a field not declared by its type layout!");
+					fieldIdx = it->second;
+				}
+				if(seen[fieldIdx]) throw std::runtime_error("Structured object contains a duplicate field!");
+				seen[fieldIdx] = true;
+				CheckFieldHeader(header, layout.fields[fieldIdx]);
+
+				//Skip fields that don't map to a column
+				const ColumnPlan& plan = plans[fieldIdx];
+				if(plan.column < 0) {
+					reader.SkipBody(header);
+					continue;
+				}
+				Column& column = columns[plan.column];
+
+				if(!column.IsVariableSize()) {
+					//Copy the value straight into its slot
+					unsigned char* dest = column.data.data() + row * column.stride;
+					reader->read(reinterpret_cast<char*>(dest), column.stride);
+					if(!reader->good()) throw std::runtime_error("Unexpected EOF in stream!");
+					if(column.type == TypeTag::Boolean && dest[0] > 1) throw std::runtime_error("Read byte is not a possible boolean value!");
+
+					//Values are stored little-endian, so flip each component on big-endian hosts
+					if constexpr(std::endian::native == std::endian::big) {
+						for(uint32_t c = 0; c < column.stride; c += plan.componentSize) std::reverse(dest + c, dest + c + plan.componentSize);
+					}
+				} else {
+					//Append the bytes to this chunk's buffer and record the length
+					std::vector<unsigned char>& data = out.variableData[plan.column];
+					const std::size_t start = data.size();
+					data.resize(start + header.size);
+					reader->read(reinterpret_cast<char*>(data.data() + start), header.size);
+					if(!reader->good()) throw std::runtime_error("Unexpected EOF in stream!");
+					if(column.type == TypeTag::String && !CheckUTF8(std::string_view(reinterpret_cast<const char*>(data.data() + start), header.size))) throw std::runtime_error("Read string is not valid UTF-8!");
+					column.offsets[row + 1] = header.size;
+				}
+			}
+
+			//The element must end here
+			if(reader.ReadHeader().type != TypeTag::ScopeBoundary) throw std::runtime_error("Structured object contains more fields than declared by its type layout!");
+		}
+	}
+
+	ColumnSet DecodeColumns(Reader& reader, const ValueEntry& list, const StructuredTypeLayout& layout, unsigned int threadCount) {
+		if(list.type != TypeTag::List || list.elementType != TypeTag::StructuredObj) throw std::runtime_error("Columnar decoding requires a list of structured objects!");
+		if(list.typeID != layout.typeID) throw std::runtime_error("List element type ID does not match the type layout!");
+		if(!*reader) throw std::runtime_error("Cannot decode columns without an accessible stream!");
+
+		//Set up columns and the per-field plan
+		ColumnSet result;
+		result.rowCount = list.size;
+		std::vector<ColumnPlan> plans;
+		std::unordered_map<std::string_view, std::size_t> fieldLookup;
+		for(std::size_t f = 0; f < layout.fields.size(); ++f) {
+			const StructuredTypeLayout::Field& field = layout.fields[f];
+			fieldLookup.emplace(field.name, f);
+
+			ColumnPlan plan = {-1, 0};
+			if(IsFixedColumnType(field.type) || field.type == TypeTag::String || field.type == TypeTag::ByteBuffer) {
+				Column column = {};
+				column.name = field.name;
+				column.type = field.type;
+				if(field.type == TypeTag::Vector || field.type == TypeTag::Matrix) {
+					column.elementType = field.elementType;
+					column.width = field.width;
+					column.height = (field.type == TypeTag::Matrix ? field.height : 1);
+					plan.componentSize = GetTypeSize(field.elementType);
+					if(plan.componentSize == 0 || field.elementType == TypeTag::Boolean) throw std::runtime_error("Vector or matrix field has a non-numeric element type!");
+					column.stride = plan.componentSize * column.width * column.height;
+					column.data.resize(uint64_t(column.stride) * list.size);
+				} else if(IsFixedColumnType(field.type)) {
+					plan.componentSize = GetTypeSize(field.type);
+					column.stride = plan.componentSize;
+					column.data.resize(uint64_t(column.stride) * list.size);
+				} else {
+					column.stride = 0;
+					column.offsets.resize(uint64_t(list.size) + 1, 0);
+				}
+				plan.column = static_cast<int>(result.columns.size());
+				result.columns.push_back(std::move(column));
+			}
+			plans.push_back(plan);
+		}
+
+		//Read the list in a single pass, in batches: each batch is walked to find its element boundaries and then decoded in chunks on several threads
+		//Only the current batch is kept in memory, so lists of any size can be decoded
+		if(threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+		const uint32_t batchSize = minRowsPerChunk * threadCount;
+		reader->seekg(list.streamBeginPosition);
+		if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+		auto windowStream = std::make_unique<WindowIstream>(reader->rdbuf());
+		WindowStreambuf& window = windowStream->GetBuffer();
+		Reader walker(std::move(windowStream));
+		ValueHeader elementHeader = {};
+		elementHeader.type = TypeTag::StructuredObj;
+		std::vector<uint64_t> elementOffsets;
+		elementOffsets.reserve(uint64_t(batchSize) + 1);
+		uint64_t batchBegin = 0;
+		for(uint32_t batchRow = 0; batchRow < list.size; batchRow += batchSize) {
+			const uint32_t batchRows = std::min(batchSize, list.size - batchRow);
+			window.Release(batchBegin);
+			elementOffsets.clear();
+			for(uint32_t i = 0; i < batchRows; ++i) {
+				elementOffsets.push_back(static_cast<uint64_t>(std::streamoff(walker->tellg())) - batchBegin);
+				walker.SkipBody(elementHeader);
+			}
+			elementOffsets.push_back(static_cast<uint64_t>(std::streamoff(walker->tellg())) - batchBegin);
+
+			//Split into chunks
+			const uint32_t chunkCount = std::clamp<uint32_t>(batchRows / minRowsPerChunk, 1, threadCount);
+			const uint32_t rowsPerChunk = (batchRows + chunkCount - 1) / chunkCount;
+			std::vector<ChunkOutput> chunkOutputs(chunkCount);
+			for(ChunkOutput& out : chunkOutputs) out.variableData.resize(result.columns.size());
+
+			//Decode all chunks, using the calling thread for the first one
+			auto runChunk = [&](uint32_t chunk) {
+				try {
+					const uint32_t first = std::min(chunk * rowsPerChunk, batchRows);
+					const uint32_t last = std::min(first + rowsPerChunk, batchRows);
+					if(first < last) DecodeChunk(window.GetData(), elementOffsets, batchRow, first, last, layout, fieldLookup, plans, result.columns, chunkOutputs[chunk]);
+				} catch(...) {
+					chunkOutputs[chunk].error = std::current_exception();
+				}
+			};
+			std::vector<std::thread> workers;
+			for(uint32_t chunk = 1; chunk < chunkCount; ++chunk) workers.emplace_back(runChunk, chunk);
+			runChunk(0);
+			for(std::thread& worker : workers) worker.join();
+			for(ChunkOutput& out : chunkOutputs) {
+				if(out.error) std::rethrow_exception(out.error);
+			}
+
+			//Append the variable-size data of the chunks in order
+			for(std::size_t c = 0; c < result.columns.size(); ++c) {
+				Column& column = result.columns[c];
+				if(!column.IsVariableSize()) continue;
+				for(ChunkOutput& out : chunkOutputs) column.data.insert(column.data.end(), out.variableData[c].begin(), out.variableData[c].end());
+			}
+			batchBegin += elementOffsets.back();
+		}
+
+		//Turn the lengths of variable-size elements into offsets
+		for(Column& column : result.columns) {
+			if(!column.IsVariableSize()) continue;
+			for(uint32_t row = 0; row < list.size; ++row) column.offsets[row + 1] += column.offsets[row];
+		}
+
+		//The window reads ahead, so the stream is moved back to the end of the list
+		const std::streampos listEnd = list.streamBeginPosition + std::streamoff(batchBegin);
+		//Leave the stream after the list
+		reader->seekg(listEnd);
+		return result;
+	}
+}
\ No newline at end of file
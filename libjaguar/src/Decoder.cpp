@@ -1,24 +1,58 @@
 #include "libjaguar/Decoder.hpp"
 #include "Utilities.hpp"
 #include "libjaguar/Index.hpp"
+#include "libjaguar/IndexID.hpp"
 #include "libjaguar/TypeTags.hpp"
 #include "libjaguar/ValueHeader.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <exception>
 #include <stdexcept>
+#include <string>
 
 namespace libjaguar {
-	Decoder::Decoder(Reader&& reader) : reader(std::move(reader)), readerValid(true), failFlag(false) {}
+	//Entries parsed between two checks of the parse deadline
+	static constexpr uint32_t deadlineCheckInterval = 256;
 
-	Decoder::Decoder(Decoder&& other) : reader(std::move(other.reader)), readerValid(true), failFlag(false) {
+	Decoder::Decoder(Reader&& reader, std::pmr::memory_resource* resource, const DecodeOptions& options)
+	  : reader(std::move(reader)), resource(resource), options(options), readerValid(true), failFlag(false), checkpoint(0), declaration(resource) {
+		if(resource == nullptr) throw std::runtime_error("Decoder memory resource must not be null!");
+	}
+
+	Decoder::~Decoder() = default;
+
+	Decoder::Decoder(Decoder&& other)
+	  : reader(std::move(other.reader)), resource(other.resource), options(other.options), index(std::move(other.index)), spareIndex(std::move(other.spareIndex)),
+		readerValid(other.readerValid), failFlag(other.failFlag), checkpoint(other.checkpoint), declaration(std::move(other.declaration)),
+		sharedDeclared(std::move(other.sharedDeclared)), entryCount(other.entryCount), entryBase(other.entryBase), materializedBase(other.materializedBase),
+		streamEnd(other.streamEnd), deadline(other.deadline), clockCountdown(other.clockCountdown), spill(std::move(other.spill)), spilledChunks(std::move(other.spilledChunks)) {
 		other.readerValid = false;
 	}
 
 	Decoder& Decoder::operator=(Decoder&& other) {
 		if(this != &other) {
 			reader = std::move(other.reader);
-			readerValid = true;
-			failFlag = false;
+			resource = other.resource;
+			options = other.options;
+			index.reset();
+			if(other.index.has_value()) index.emplace(std::move(*other.index));
+			spareIndex.reset();
+			if(other.spareIndex.has_value()) spareIndex.emplace(std::move(*other.spareIndex));
+			readerValid = other.readerValid;
+			failFlag = other.failFlag;
+			checkpoint = other.checkpoint;
+			declaration = std::move(other.declaration);
+			sharedDeclared = std::move(other.sharedDeclared);
+			entryCount = other.entryCount;
+			entryBase = other.entryBase;
+			materializedBase = other.materializedBase;
+			streamEnd = other.streamEnd;
+			deadline = other.deadline;
+			clockCountdown = other.clockCountdown;
+			spill = std::move(other.spill);
+			spilledChunks = std::move(other.spilledChunks);
 			other.readerValid = false;
 		}
 		return *this;
@@ -29,84 +63,461 @@ namespace libjaguar {
 		return std::move(reader);
 	}
 
-	void Decoder::_ParseScopeInternal(ScopeEntry& scope, unsigned int expectedFieldCount, std::string scopePath) {
-		//Continuously read the next header
+	void Decoder::Reset(Reader&& newReader) {
+		reader = std::move(newReader);
+		_ResetInternal();
+	}
+
+	void Decoder::Reset(std::span<const unsigned char> data) {
+		reader.Reset(data);
+		_ResetInternal();
+	}
+
+	void Decoder::_ResetInternal() {
+		readerValid = true;
+		failFlag = false;
+		checkpoint = 0;
+		entryCount = 0;
+		spill.reset();
+		spilledChunks.clear();
+
+		//Clearing keeps the capacity of the vectors and the buckets of the type table; the next parse picks the index up again
+		if(index.has_value()) {
+			index->types.clear();
+			index->registry.reset();
+			index->sharedTypes.clear();
+			index->root.subscopes.clear();
+			index->root.subvalues.clear();
+			index->values.clear();
+			index->listCheckpoints.clear();
+			spareIndex.emplace(std::move(*index));
+			index.reset();
+		}
+	}
+
+	bool Decoder::_ParseEntryInternal(const ScopeFrame& parent, const ValueHeader& header, uint8_t depth, ScopeFrame& child) {
+		//Type declarations are only allowed in the root scope
+		if(header.type == TypeTag::StructuredObjTypeDecl) {
+			if(depth > 0) throw std::runtime_error("Type declarations are only allowed in the root scope!");
+			reader.ReadTypeDeclaration(header, declaration);
+			if(_FindTypeInternal(declaration.typeID)) throw std::runtime_error("Duplicate type declaration!");
+
+			//A declaration that matches the registry refers to the shared layout rather than being stored
+			const TypeRegistry* registry = options.typeRegistry.get();
+			if(const StructuredTypeLayout* shared = (registry ? registry->FindMatching(declaration) : nullptr)) {
+				sharedDeclared[shared - registry->GetLayouts().data()] = true;
+				index->sharedTypes.push_back(shared);
+				return false;
+			}
+			index->types.try_emplace(declaration.typeID, std::move(declaration));
+			return false;
+		}
+
+		//Limits are checked as entries are added, so that a hostile stream fails before it costs much
+		const DecodeLimits& limits = options.limits;
+		if(++entryCount - entryBase > limits.maxEntries) throw std::runtime_error("Index entry limit exceeded!");
+		if(clockCountdown > 0 && --clockCountdown == 0) _CheckDeadlineInternal();
+		if(streamEnd >= 0) {
+			//Every field takes at least a tag and a name length, every list element at least one byte
+			uint64_t claimed = 0;
+			switch(header.type) {
+				case TypeTag::String:
+				case TypeTag::ByteBuffer:
+				case TypeTag::Substream: claimed = header.size; break;
+				case TypeTag::List: claimed = uint64_t(header.size) * std::max<uint32_t>(GetTypeSize(header.elementType), 1); break;
+				case TypeTag::UnstructuredObj: claimed = uint64_t(header.fieldCount) * 2; break;
+				default: break;
+			}
+			if(claimed > 0 && claimed > uint64_t(streamEnd - std::streamoff(reader->tellg()))) throw std::runtime_error("Value claims more data than the rest of the stream holds!");
+		}
+
+		//IDs are derived from the parent's, so paths never have to be built
+		const uint64_t id = ExtendIndexID(parent.pathHash, header.name);
+
+		//Objects get their own scope, which the caller parses next
+		if(header.type == TypeTag::UnstructuredObj || header.type == TypeTag::StructuredObj) {
+			if(depth >= maxScopeDepth) throw std::runtime_error("Maximum nesting depth exceeded!");
+			std::size_t fieldCount = header.fieldCount;
+			if(header.type == TypeTag::StructuredObj) {
+				const StructuredTypeLayout* layout = _FindTypeInternal(header.typeID);
+				if(!layout) throw std::runtime_error("Structured object uses an undeclared type!");
+				fieldCount = layout->fields.size();
+			}
+
+			//The parent is suspended until this scope is done, so the entry stays put
+			ScopeEntry& subscope = parent.scope->subscopes.emplace_back();
+			subscope.name = header.name;
+			subscope.id = id;
+			subscope.streamBeginPosition = reader->tellg();
+			subscope.list = false;
+			subscope.typeID = header.typeID;
+			child = {&subscope, fieldCount, id};
+			return true;
+		}
+		if(!IsValue(header.type)) throw std::runtime_error("Encountered an invalid type tag!");
+
+		//Basics
+		ValueEntry& entry = parent.scope->subvalues.emplace_back();
+		entry.type = header.type;
+		entry.name = header.name;
+		entry.id = id;
+		entry.streamBeginPosition = reader->tellg();
+
+		//Vector/matrix handling
+		if(header.type == TypeTag::Vector || header.type == TypeTag::Matrix) {
+			entry.elementType = header.elementType;
+			entry.width = header.width;
+			if(header.type == TypeTag::Matrix) {
+				entry.height = header.height;
+			}
+		}
+
+		//List handling
+		if(header.type == TypeTag::List) {
+			entry.elementType = header.elementType;
+			entry.size = header.size;
+			entry.typeID = header.typeID;
+
+			//Elements without a fixed size can only be reached by walking the list, so long lists get checkpoints along the way
+			const uint32_t interval = options.listCheckpointInterval;
+			if(interval > 0 && header.size > interval && GetTypeSize(header.elementType) == 0) {
+				std::pmr::vector<uint64_t>& checkpoints = index->listCheckpoints;
+				entry.checkpointOffset = checkpoints.size();
+				for(uint32_t i = 0; i < header.size; ++i) {
+					if(i > 0 && i % interval == 0) checkpoints.push_back(uint64_t(std::streamoff(reader->tellg())));
+					reader.SkipBody(reader.ReadElementHeader(header.elementType));
+				}
+				return false;
+			}
+		}
+
+		//Buffer objects and size checks
+		if(static_cast<uint8_t>(header.type) <= 0xC) entry.size = header.size;
+		if(header.type == TypeTag::String && header.size >= std::pow(2, 24)) throw std::runtime_error("Encountered a string that is too long (> 24-bit integer limit!)");
+		if(header.type == TypeTag::String && header.size > limits.maxStringSize) throw std::runtime_error("String size limit exceeded!");
+
+		//Small bodies are copied into the index, so that they can be read later without any I/O
+		if(options.materialize) {
+			uint64_t size = GetTypeSize(header.type);
+			switch(header.type) {
+				case TypeTag::String:
+				case TypeTag::ByteBuffer: size = (header.size <= options.maxMaterializedSize ? header.size : 0); break;
+				case TypeTag::Vector: size = uint64_t(GetTypeSize(header.elementType)) * header.width; break;
+				case TypeTag::Matrix: size = uint64_t(GetTypeSize(header.elementType)) * header.width * header.height; break;
+				default: break;
+			}
+
+			//Vectors and matrices of booleans are invalid whether or not they are materialized, so they are left for SkipBody to reject
+			if((header.type == TypeTag::Vector || header.type == TypeTag::Matrix) && header.elementType == TypeTag::Boolean) size = 0;
+
+			//Empty strings and buffers are materialized too, since their body is known, while larger ones than the limit are skipped below
+			if(size > 0 || ((header.type == TypeTag::String || header.type == TypeTag::ByteBuffer) && header.size == 0)) {
+				std::pmr::vector<unsigned char>& values = index->values;
+				if(values.size() + size - materializedBase > limits.maxMaterializedBytes) throw std::runtime_error("Materialized value limit exceeded!");
+				entry.valueOffset = values.size();
+				values.resize(values.size() + size);
+				reader->read(reinterpret_cast<char*>(values.data() + entry.valueOffset), std::streamsize(size));
+				if(reader->eof()) throw std::runtime_error("Unexpected EOF in stream!");
+				if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+				if(header.type == TypeTag::String && !CheckUTF8(std::string_view(reinterpret_cast<const char*>(values.data() + entry.valueOffset), size)))
+					throw std::runtime_error("Read string is not valid UTF-8!");
+				return false;
+			}
+		}
+
+		//Skip over the body so that the next header can be read
+		reader.SkipBody(header);
+		return false;
+	}
+
+	const StructuredTypeLayout* Decoder::_FindTypeInternal(const std::pmr::string& typeID) const {
+		auto it = index->types.find(typeID);
+		if(it != index->types.end()) return &it->second;
+
+		//Registered layouts only count once the stream has declared them
+		const TypeRegistry* registry = options.typeRegistry.get();
+		const StructuredTypeLayout* shared = (registry ? registry->Find(typeID) : nullptr);
+		return (shared && sharedDeclared[shared - registry->GetLayouts().data()] ? shared : nullptr);
+	}
+
+	void Decoder::_ParseValueInternal(ValueHeader& header) {
+		//The root scope sits at the bottom of the stack, with one frame per open object above it
+		std::array<ScopeFrame, maxScopeDepth + 1> stack;
+		stack[0] = {&index->root, 0, indexIDSeed};
+		uint8_t depth = 0;
+#ifdef LJTRACING
+		std::array<uint64_t, maxScopeDepth + 1> scopeTraceStarts;//Start of each open scope's trace span, or 0 if it is not traced
+#endif
+
 		while(true) {
-			//Get next header
-			ValueHeader header = reader.ReadHeader();
-			std::size_t encounteredFields = scope.subscopes.size() + scope.subvalues.size();
+			ScopeFrame& frame = stack[depth];
+			std::size_t encounteredFields = frame.scope->subscopes.size() + frame.scope->subvalues.size();
 
-			//If we see a scope boundary, check position
+			//If we see a scope boundary, check position (the root scope has none, which the caller checks)
 			if(header.type == TypeTag::ScopeBoundary) {
-				//Is this root (expected field count is UINT16_MAX + 1, since that's above the allowed number of object fields)
-				if(expectedFieldCount > UINT16_MAX) throw std::runtime_error("Unexpected scope boundary in root scope!");
-
 				//Have we seen the expected number of values yet?
-				//Return if so because the scope is done
-				if(encounteredFields == expectedFieldCount) return;
+				//Pop the frame if so because the scope is done
+				if(encounteredFields == frame.expectedFieldCount) {
+#ifdef LJTRACING
+					if(scopeTraceStarts[depth] != 0) EmitTraceSpan("Scope", "decoder", frame.scope->name, scopeTraceStarts[depth]);
+#endif
+					if(--depth == 0) return;
+				}
 
 				//If we're less, this is simply a case of early scope termination
 				//We still do an if-check to throw the appropriate exception in case we passed the expected field count without a boundary
-				else if(encounteredFields < expectedFieldCount)
+				else if(encounteredFields < frame.expectedFieldCount)
 					throw std::runtime_error("Early scope boundary detected!");
 				else
 					//This really shouldn't happen because we try to anticipate excess fields early
 					throw std::runtime_error("Late scope boundary detected!");
-			}
+			} else {
+				//Check expected field count to make sure we're not over
+				if(depth > 0 && encounteredFields >= frame.expectedFieldCount) throw std::runtime_error("Excess number of fields detected in scope!");
 
-			//Check expected field count to make sure we're not over
-			if(encounteredFields > expectedFieldCount) throw std::runtime_error("Excess number of fields detected in scope!");
-
-			//If this is a value, this makes things easy
-			//If it's a scope, this gets more complicated
-			if(IsValue(header.type)) {
-				//Basics
-				ValueEntry entry = {};
-				entry.type = header.type;
-				entry.name = header.name;
-				entry.streamBeginPosition = reader->tellg();
-
-				//Vector/matrix handling
-				if(header.type == TypeTag::Vector || header.type == TypeTag::Matrix) {
-					entry.elementType = header.elementType;
-					entry.width = header.width;
-					if(header.type == TypeTag::Matrix) {
-						entry.height = header.height;
-					}
+				//Objects push a frame; anything else at the root is a complete value
+				if(_ParseEntryInternal(frame, header, depth, stack[depth + 1])) {
+					++depth;
+#ifdef LJTRACING
+					scopeTraceStarts[depth] = BeginTraceSpan(true);
+#endif
+				} else if(depth == 0) {
+					return;
 				}
+			}
+
+			//Get next header
+			header = reader.ReadHeader();
+		}
+	}
+
+	std::size_t Decoder::_ParseRootInternal(bool allowPartial) {
+		if(!readerValid) throw std::runtime_error("Decoder has no valid reader!");
+		if(failFlag) throw std::runtime_error("Cannot continue parsing; parsing errors occurred!");
+		TRACE_SPAN(allowPartial ? "ParseAvailable" : "Parse", "decoder");
+
+		//Configure root node on first use
+		if(!index.has_value()) {
+			if(spareIndex.has_value()) {
+				index.emplace(std::move(*spareIndex));
+				spareIndex.reset();
+			} else {
+				index.emplace(resource);
+			}
+			index->root.name = "";
+			index->root.id = ExtendIndexID(indexIDSeed, "");
+			index->root.streamBeginPosition = 0;
+			index->root.typeID = "";
+			index->listCheckpointInterval = options.listCheckpointInterval;
+			index->registry = options.typeRegistry;
+			sharedDeclared.assign(options.typeRegistry ? options.typeRegistry->GetLayouts().size() : 0, false);
+			checkpoint = reader->tellg();
+			if(checkpoint == std::streampos(-1)) checkpoint = 0;
+		}
+
+		//Resume from the checkpoint (a previous call may have stopped at EOF)
+		reader->clear();
+		if(allowPartial) {
+			reader->seekg(checkpoint);
+			if(!reader->good()) throw std::runtime_error("Resumable parsing requires a seekable stream!");
+		}
+
+		//Time and input size limits apply per call
+		const DecodeLimits& limits = options.limits;
+		deadline = std::chrono::steady_clock::now() + limits.maxParseTime;
+		clockCountdown = (limits.maxParseTime.count() > 0 ? deadlineCheckInterval : 0);
+		streamEnd = -1;
+		if(limits.checkRemainingInput) {
+			const std::streampos position = reader->tellg();
+			reader->seekg(0, std::ios_base::end);
+			const std::streampos end = reader->tellg();
+			reader->seekg(position);
+			if(position == std::streampos(-1) || end == std::streampos(-1) || !reader->good()) throw std::runtime_error("Checking the remaining input requires a seekable stream!");
+			streamEnd = end;
+		}
+
+		//Parse root-level values one at a time, moving the checkpoint past each complete one
+		std::size_t added = 0;
+		while(true) {
+			//The root scope has no boundary, so a clean EOF between values ends it
+			if(reader->peek() == std::char_traits<char>::eof()) {
+				reader->clear();
+				break;
+			}
 
-				//Buffer objects and size checks
-				if(static_cast<uint8_t>(header.type) <= 0xC) header.size = entry.size;
-				if(header.type == TypeTag::String && header.size >= std::pow(2, 24)) throw std::runtime_error("Encountered a string that is too long (> 24-bit integer limit!)");
+			const std::size_t rootScopes = index->root.subscopes.size();
+			const std::size_t rootValues = index->root.subvalues.size();
+			const std::size_t materializedSize = index->values.size();
+			const std::size_t checkpointCount = index->listCheckpoints.size();
+			const uint64_t entriesBefore = entryCount;
 
-				//ID generation
-				std::string entryPath = scopePath + (scopePath.empty() ? "" : ".") + entry.name;
-				entry.id = GenIndexID(entryPath);
+			//When spilling, only the entries of the current value count towards the limits, since the others can be moved out of the index
+			entryBase = (limits.spillIndex ? entryCount : 0);
+			materializedBase = (limits.spillIndex ? materializedSize : 0);
+			try {
+				ValueHeader header = reader.ReadHeader();
+				if(header.type == TypeTag::ScopeBoundary) throw std::runtime_error("Unexpected scope boundary in root scope!");
+				_ParseValueInternal(header);
+			} catch(...) {
+				//A value cut off by EOF is just not complete yet, so whatever of it was added to the index is removed again
+				if(allowPartial && reader->eof()) {
+					index->root.subscopes.erase(index->root.subscopes.begin() + rootScopes, index->root.subscopes.end());
+					index->root.subvalues.erase(index->root.subvalues.begin() + rootValues, index->root.subvalues.end());
+					index->values.resize(materializedSize);
+					index->listCheckpoints.resize(checkpointCount);
+					entryCount = entriesBefore;
+					reader->clear();
+					reader->seekg(checkpoint);
+					break;
+				}
 
-				//Add entry
-				scope.subvalues.push_back(std::move(entry));
+				//Intercept exception to set fail flag and then rethrow
+				failFlag = true;
+				std::rethrow_exception(std::current_exception());
 			}
+			checkpoint = reader->tellg();
+			++added;
+			if(limits.spillIndex && (entryCount >= limits.maxEntries || index->values.size() >= limits.maxMaterializedBytes)) _SpillIndexInternal();
 		}
+		return added;
 	}
 
-	void Decoder::Parse() {
-		if(!readerValid) throw std::runtime_error("Decoder has no valid reader!");
-		if(index.has_value()) throw std::runtime_error("Stream has already been parsed!");
-
-		//Configure root node
-		index.emplace();
-		index->root.name = "";
-		index->root.id = GenIndexID("");
-		index->root.streamBeginPosition = 0;
-		index->root.typeID = "";
-
-		//Start decoding the root scope
-		try {
-			_ParseScopeInternal(index->root, UINT16_MAX + 1, "");
-		} catch(...) {
-			//Intercept exception to set fail flag and then rethrow
-			failFlag = true;
-			std::rethrow_exception(std::current_exception());
+	void Decoder::_CheckDeadlineInternal() {
+		clockCountdown = deadlineCheckInterval;
+		if(std::chrono::steady_clock::now() > deadline) throw std::runtime_error("Parse time limit exceeded!");
+	}
+
+	//Spilled chunks are only ever read back by the same process, so numbers are stored as they are in memory
+	template<typename T>
+	static void PutRaw(std::string& out, T value) {
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static void PutString(std::string& out, std::string_view string) {
+		PutRaw<uint32_t>(out, static_cast<uint32_t>(string.size()));
+		out.append(string);
+	}
+
+	static void PutScope(std::string& out, const ScopeEntry& scope) {
+		PutString(out, scope.name);
+		PutRaw(out, scope.id);
+		PutRaw<int64_t>(out, std::streamoff(scope.streamBeginPosition));
+		PutRaw<uint8_t>(out, scope.list);
+		PutString(out, scope.typeID);
+		PutRaw<uint64_t>(out, scope.subvalues.size());
+		for(const ValueEntry& value : scope.subvalues) {
+			PutString(out, value.name);
+			PutRaw(out, value.id);
+			PutRaw<int64_t>(out, std::streamoff(value.streamBeginPosition));
+			PutRaw(out, value.type);
+			PutRaw(out, value.elementType);
+			PutRaw(out, value.size);
+			PutRaw(out, value.width);
+			PutRaw(out, value.height);
+			PutString(out, value.typeID);
+			PutRaw(out, value.valueOffset);
+			PutRaw(out, value.checkpointOffset);
+		}
+		PutRaw<uint64_t>(out, scope.subscopes.size());
+		for(const ScopeEntry& subscope : scope.subscopes) PutScope(out, subscope);
+	}
+
+	struct ChunkCursor {
+		const char* at;
+		const char* end;
+
+		template<typename T>
+		T Take() {
+			if(std::size_t(end - at) < sizeof(T)) throw std::runtime_error("Spilled index chunk is corrupted!");
+			T value;
+			std::memcpy(&value, at, sizeof(T));
+			at += sizeof(T);
+			return value;
+		}
+
+		void TakeString(std::pmr::string& out) {
+			const uint32_t size = Take<uint32_t>();
+			if(std::size_t(end - at) < size) throw std::runtime_error("Spilled index chunk is corrupted!");
+			out.assign(at, size);
+			at += size;
 		}
+	};
+
+	static void TakeScope(ChunkCursor& cursor, ScopeEntry& scope) {
+		cursor.TakeString(scope.name);
+		scope.id = cursor.Take<uint64_t>();
+		scope.streamBeginPosition = cursor.Take<int64_t>();
+		scope.list = cursor.Take<uint8_t>() != 0;
+		cursor.TakeString(scope.typeID);
+		scope.subvalues.resize(cursor.Take<uint64_t>());
+		for(ValueEntry& value : scope.subvalues) {
+			cursor.TakeString(value.name);
+			value.id = cursor.Take<uint64_t>();
+			value.streamBeginPosition = cursor.Take<int64_t>();
+			value.type = cursor.Take<TypeTag>();
+			value.elementType = cursor.Take<TypeTag>();
+			value.size = cursor.Take<uint32_t>();
+			value.width = cursor.Take<uint8_t>();
+			value.height = cursor.Take<uint8_t>();
+			cursor.TakeString(value.typeID);
+			value.valueOffset = cursor.Take<uint64_t>();
+			value.checkpointOffset = cursor.Take<uint64_t>();
+		}
+		scope.subscopes.resize(cursor.Take<uint64_t>());
+		for(ScopeEntry& subscope : scope.subscopes) TakeScope(cursor, subscope);
+	}
+
+	void Decoder::_SpillIndexInternal() {
+		//The index only holds complete root-level values here, so all of them (and their materialized values) go into the chunk
+		std::string chunk;
+		PutScope(chunk, index->root);
+		PutRaw<uint64_t>(chunk, index->values.size());
+		chunk.append(reinterpret_cast<const char*>(index->values.data()), index->values.size());
+		PutRaw<uint64_t>(chunk, index->listCheckpoints.size());
+		chunk.append(reinterpret_cast<const char*>(index->listCheckpoints.data()), index->listCheckpoints.size() * sizeof(uint64_t));
+
+		if(!spill) spill = std::make_unique<SpillStreambuf>(0);
+		const uint64_t position = spill->GetSize();
+		if(spill->sputn(chunk.data(), std::streamsize(chunk.size())) != std::streamsize(chunk.size())) throw std::runtime_error("Cannot write to the temporary spill file!");
+		spilledChunks.emplace_back(position, chunk.size());
+
+		index->root.subscopes.clear();
+		index->root.subvalues.clear();
+		index->values.clear();
+		index->listCheckpoints.clear();
+		entryCount = 0;
+	}
+
+	Index Decoder::LoadSpilledChunk(std::size_t chunk, std::pmr::memory_resource* resource) {
+		if(chunk >= spilledChunks.size()) throw std::runtime_error("No spilled index chunk with that number exists!");
+		std::string bytes(spilledChunks[chunk].second, '\0');
+		spill->ReadBack(spilledChunks[chunk].first, bytes.data(), bytes.size());
+
+		Index loaded(resource);
+		ChunkCursor cursor = {bytes.data(), bytes.data() + bytes.size()};
+		TakeScope(cursor, loaded.root);
+		const uint64_t valueSize = cursor.Take<uint64_t>();
+		if(uint64_t(cursor.end - cursor.at) < valueSize) throw std::runtime_error("Spilled index chunk is corrupted!");
+		loaded.values.assign(cursor.at, cursor.at + valueSize);
+		cursor.at += valueSize;
+		const uint64_t checkpointCount = cursor.Take<uint64_t>();
+		if(uint64_t(cursor.end - cursor.at) != checkpointCount * sizeof(uint64_t)) throw std::runtime_error("Spilled index chunk is corrupted!");
+		loaded.listCheckpoints.resize(checkpointCount);
+		if(checkpointCount > 0) std::memcpy(loaded.listCheckpoints.data(), cursor.at, checkpointCount * sizeof(uint64_t));
+		loaded.listCheckpointInterval = index->listCheckpointInterval;
+
+		//Declarations stay in the index, but the chunk needs them to resolve its structured objects and lists
+		loaded.types = index->types;
+		loaded.registry = index->registry;
+		loaded.sharedTypes = index->sharedTypes;
+		return loaded;
+	}
+
+	void Decoder::Parse() {
+		_ParseRootInternal(false);
+	}
+
+	std::size_t Decoder::ParseAvailable() {
+		return _ParseRootInternal(true);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "libjaguar/DecoderPool.hpp"
+
+namespace libjaguar {
+	DecoderPool& DecoderPool::ForThread() {
+		thread_local DecoderPool pool;
+		return pool;
+	}
+
+	Decoder DecoderPool::Acquire(std::span<const unsigned char> data, const DecodeOptions& options) {
+		std::unique_lock lock(mutex);
+		if(released.empty()) {
+			lock.unlock();
+			return Decoder(Reader::FromMemory(data), std::pmr::get_default_resource(), options);
+		}
+		Decoder decoder = std::move(released.back());
+		released.pop_back();
+		lock.unlock();
+
+		//Settings may differ from message to message, but everything else is reused
+		decoder.options = options;
+		decoder.Reset(data);
+		return decoder;
+	}
+
+	void DecoderPool::Release(Decoder&& decoder) {
+		std::lock_guard lock(mutex);
+		released.push_back(std::move(decoder));
+	}
+}
\ No newline at end of file
@@ -1,15 +1,18 @@
 #include "libjaguar/Encoder.hpp"
 
+#include <stdexcept>
+
 namespace libjaguar {
-	Encoder::Encoder(Writer&& writer) : writer(std::move(writer)), writerValid(true) {}
+	Encoder::Encoder(Writer&& writer, std::shared_ptr<const TypeRegistry> typeRegistry) : writer(std::move(writer)), typeRegistry(std::move(typeRegistry)), writerValid(true) {}
 
-	Encoder::Encoder(Encoder&& other) : writer(std::move(other.writer)), writerValid(true) {
+	Encoder::Encoder(Encoder&& other) : writer(std::move(other.writer)), typeRegistry(std::move(other.typeRegistry)), writerValid(true) {
 		other.writerValid = false;
 	}
 
 	Encoder& Encoder::operator=(Encoder&& other) {
 		if(this != &other) {
 			writer = std::move(other.writer);
+			typeRegistry = std::move(other.typeRegistry);
 			writerValid = true;
 			other.writerValid = false;
 		}
@@ -20,4 +23,17 @@ namespace libjaguar {
 		if(!writerValid) throw std::runtime_error("Encoder has no valid writer!");
 		return writer;
 	}
+
+	std::unique_ptr<std::ostream> Encoder::Reset(std::unique_ptr<std::ostream>&& ostream) {
+		writerValid = true;
+		return writer.Reset(std::move(ostream));
+	}
+
+	void Encoder::WriteTypeDeclarations() {
+		if(!typeRegistry) throw std::runtime_error("Encoder has no type registry!");
+		std::ostream* stream = *GetWriter();
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		std::span<const unsigned char> declarations = typeRegistry->GetEncodedDeclarations();
+		stream->write(reinterpret_cast<const char*>(declarations.data()), std::streamsize(declarations.size()));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "libjaguar/FieldIndex.hpp"
+#include "libjaguar/ValueHeader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+namespace libjaguar {
+	uint64_t FieldIndex::_GetKeyInternal(const StructView& element, std::string_view field, TypeTag type) {
+		switch(type) {
+			case TypeTag::UInt8: return _OrderKeyInternal(element.Get<uint8_t>(field));
+			case TypeTag::UInt16: return _OrderKeyInternal(element.Get<uint16_t>(field));
+			case TypeTag::UInt32: return _OrderKeyInternal(element.Get<uint32_t>(field));
+			case TypeTag::UInt64: return _OrderKeyInternal(element.Get<uint64_t>(field));
+			case TypeTag::SInt8: return _OrderKeyInternal(element.Get<int8_t>(field));
+			case TypeTag::SInt16: return _OrderKeyInternal(element.Get<int16_t>(field));
+			case TypeTag::SInt32: return _OrderKeyInternal(element.Get<int32_t>(field));
+			case TypeTag::SInt64: return _OrderKeyInternal(element.Get<int64_t>(field));
+			case TypeTag::Float32: return _OrderKeyInternal(element.Get<float>(field));
+			case TypeTag::Float64: return _OrderKeyInternal(element.Get<double>(field));
+			default: throw std::runtime_error("Only number and string fields can be indexed!");
+		}
+	}
+
+	FieldIndex FieldIndex::Build(const std::function<Reader()>& openReader, const Index& index, const ValueEntry& list, std::string_view field, unsigned int threadCount) {
+		if(list.type != TypeTag::List || list.elementType != TypeTag::StructuredObj) throw std::runtime_error("Only lists of structured objects can be indexed!");
+		const StructuredTypeLayout* layout = index.FindType(list.typeID);
+		if(!layout) throw std::runtime_error("Structured object uses an undeclared type!");
+		auto it = std::find_if(layout->fields.begin(), layout->fields.end(), [&](const StructuredTypeLayout::Field& f) { return f.name == field; });
+		if(it == layout->fields.end()) throw std::runtime_error("No field exists with the requested name!");
+		const TypeTag type = it->type;
+		const bool strings = (type == TypeTag::String);
+		if(!strings) {
+			const TypeCategory category = GetTypeTagInfo(type).category;
+			if(category != TypeCategory::UnsignedInteger && category != TypeCategory::SignedInteger && category != TypeCategory::FloatingPoint)
+				throw std::runtime_error("Only number and string fields can be indexed!");
+		}
+
+		//Without checkpoints, every thread would have to walk the list from the start to reach its part
+		if(threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+		if(list.checkpointOffset == UINT64_MAX) threadCount = 1;
+		const std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(list.size, threadCount == 1 ? 1 : std::size_t(threadCount) * 4));
+
+		//Each chunk collects the keys of a run of elements, in list order
+		struct Chunk {
+			std::vector<FieldIndexMatch> matches;
+			std::vector<uint64_t> keys;//Number keys, or the end of each string key in keyData
+			std::string keyData;
+		};
+		std::vector<Chunk> chunks(chunkCount);
+		std::atomic<std::size_t> nextChunk = 0;
+		std::atomic<bool> failed = false;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+		auto worker = [&]() {
+			try {
+				std::optional<Reader> reader;
+				std::optional<ListView<StructView>> view;
+				for(std::size_t c = nextChunk++; c < chunkCount && !failed; c = nextChunk++) {
+					//Readers are opened lazily, so that threads without work do not open any
+					if(!reader) {
+						reader.emplace(openReader());
+						view.emplace(*reader, list, index);
+					}
+					const uint32_t begin = static_cast<uint32_t>(uint64_t(list.size) * c / chunkCount);
+					const uint32_t end = static_cast<uint32_t>(uint64_t(list.size) * (c + 1) / chunkCount);
+					Chunk& chunk = chunks[c];
+					chunk.matches.reserve(end - begin);
+					chunk.keys.reserve(end - begin);
+					view->SkipTo(begin);
+					for(uint32_t i = begin; i < end; ++i) {
+						const uint64_t position = static_cast<uint64_t>(std::streamoff((*reader)->tellg()));
+						const StructView& element = *view->begin();
+						chunk.matches.push_back({i, position});
+						if(strings) {
+							chunk.keyData += element.GetString(field);
+							chunk.keys.push_back(chunk.keyData.size());
+						} else {
+							chunk.keys.push_back(_GetKeyInternal(element, field, type));
+						}
+					}
+				}
+			} catch(...) {
+				std::lock_guard lock(errorMutex);
+				if(!error) error = std::current_exception();
+				failed = true;
+			}
+		};
+
+		//Use the calling thread as one of the workers
+		std::vector<std::thread> workers;
+		for(std::size_t t = 1; t < std::min<std::size_t>(threadCount, chunkCount); ++t) workers.emplace_back(worker);
+		worker();
+		for(std::thread& t : workers) t.join();
+		if(error) std::rethrow_exception(error);
+
+		//Join the chunks in list order, so that a stable sort keeps elements with the same key in list order
+		std::vector<FieldIndexMatch> unsorted;
+		std::vector<uint64_t> unsortedKeys;
+		std::vector<uint64_t> unsortedOffsets;
+		std::string unsortedData;
+		unsorted.reserve(list.size);
+		for(Chunk& chunk : chunks) {
+			unsorted.insert(unsorted.end(), chunk.matches.begin(), chunk.matches.end());
+			if(strings) {
+				uint64_t begin = unsortedData.size();
+				for(uint64_t end : chunk.keys) {
+					unsortedOffsets.push_back(begin);
+					begin = unsortedData.size() + end;
+				}
+				unsortedData += chunk.keyData;
+			} else {
+				unsortedKeys.insert(unsortedKeys.end(), chunk.keys.begin(), chunk.keys.end());
+			}
+			chunk = {};
+		}
+		unsortedOffsets.push_back(unsortedData.size());
+
+		std::vector<std::size_t> order(unsorted.size());
+		std::iota(order.begin(), order.end(), std::size_t(0));
+		auto stringKey = [&](std::size_t i) { return std::string_view(unsortedData).substr(unsortedOffsets[i], unsortedOffsets[i + 1] - unsortedOffsets[i]); };
+		if(strings) {
+			std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return stringKey(a) < stringKey(b); });
+		} else {
+			std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return unsortedKeys[a] < unsortedKeys[b]; });
+		}
+
+		FieldIndex result;
+		result.field = field;
+		result.keyType = type;
+		result.listID = list.id;
+		result.listPosition = static_cast<uint64_t>(std::streamoff(list.streamBeginPosition));
+		result.matches.reserve(order.size());
+		for(std::size_t i : order) result.matches.push_back(unsorted[i]);
+		if(strings) {
+			result.keyOffsets.reserve(order.size() + 1);
+			result.keyData.reserve(unsortedData.size());
+			for(std::size_t i : order) {
+				result.keyOffsets.push_back(result.keyData.size());
+				result.keyData += stringKey(i);
+			}
+			result.keyOffsets.push_back(result.keyData.size());
+		} else {
+			result.keys.reserve(order.size());
+			for(std::size_t i : order) result.keys.push_back(unsortedKeys[i]);
+		}
+		return result;
+	}
+
+	std::string_view FieldIndex::_GetStringKeyInternal(std::size_t match) const {
+		return std::string_view(keyData).substr(keyOffsets[match], keyOffsets[match + 1] - keyOffsets[match]);
+	}
+
+	std::span<const FieldIndexMatch> FieldIndex::_FindRangeInternal(uint64_t first, uint64_t last) const {
+		if(first > last) return {};
+		const std::size_t begin = std::lower_bound(keys.begin(), keys.end(), first) - keys.begin();
+		const std::size_t end = std::upper_bound(keys.begin() + begin, keys.end(), last) - keys.begin();
+		return std::span<const FieldIndexMatch>(matches).subspan(begin, end - begin);
+	}
+
+	std::span<const FieldIndexMatch> FieldIndex::FindRange(std::string_view first, std::string_view last) const {
+		if(keyType != TypeTag::String) throw std::runtime_error("Key type does not match the type of the indexed field!");
+		if(first > last) return {};
+
+		//Matches are sorted by key, so both ends are found by binary search
+		auto bound = [&](std::string_view key, bool upper) {
+			std::size_t low = 0;
+			std::size_t high = matches.size();
+			while(low < high) {
+				const std::size_t middle = low + (high - low) / 2;
+				const std::string_view current = _GetStringKeyInternal(middle);
+				if(upper ? current <= key : current < key) {
+					low = middle + 1;
+				} else {
+					high = middle;
+				}
+			}
+			return low;
+		};
+		const std::size_t begin = bound(first, false);
+		const std::size_t end = bound(last, true);
+		return std::span<const FieldIndexMatch>(matches).subspan(begin, end - begin);
+	}
+
+	//Saved indices are a sequence of root-level values with these names, in this order
+	static void WriteListHeader(Writer& writer, std::string_view name, TypeTag elementType, std::size_t size) {
+		ValueHeader header = {};
+		header.type = TypeTag::List;
+		header.name = name;
+		header.elementType = elementType;
+		header.size = static_cast<uint32_t>(size);
+		writer.WriteHeader(header);
+	}
+
+	void FieldIndex::Save(Writer& writer) const {
+		if(keyData.size() > UINT32_MAX) throw std::runtime_error("Field index keys are too large to save!");
+
+		ValueHeader header = {};
+		header.type = TypeTag::String;
+		header.name = "field";
+		header.size = static_cast<uint32_t>(field.size());
+		writer.WriteHeader(header);
+		writer.WriteString(field);
+		header = {};
+		header.type = TypeTag::UInt8;
+		header.name = "keyType";
+		writer.WriteHeader(header);
+		writer.WriteInteger(static_cast<uint8_t>(keyType));
+		header.type = TypeTag::UInt64;
+		header.name = "list";
+		writer.WriteHeader(header);
+		writer.WriteInteger(listID);
+		header.name = "listPosition";
+		writer.WriteHeader(header);
+		writer.WriteInteger(listPosition);
+
+		WriteListHeader(writer, "elements", TypeTag::UInt32, matches.size());
+		for(const FieldIndexMatch& match : matches) writer.WriteInteger(match.element);
+		WriteListHeader(writer, "positions", TypeTag::UInt64, matches.size());
+		for(const FieldIndexMatch& match : matches) writer.WriteInteger(match.position);
+		if(keyType == TypeTag::String) {
+			WriteListHeader(writer, "keyOffsets", TypeTag::UInt64, keyOffsets.size());
+			for(uint64_t offset : keyOffsets) writer.WriteInteger(offset);
+			header = {};
+			header.type = TypeTag::ByteBuffer;
+			header.name = "keyData";
+			header.size = static_cast<uint32_t>(keyData.size());
+			writer.WriteHeader(header);
+			writer.WriteBuffer(std::span<const unsigned char>(reinterpret_cast<const unsigned char*>(keyData.data()), keyData.size()));
+		} else {
+			WriteListHeader(writer, "keys", TypeTag::UInt64, keys.size());
+			for(uint64_t key : keys) writer.WriteInteger(key);
+		}
+		if(!writer->good()) throw std::runtime_error("Unexpected stream IO error!");
+	}
+
+	static ValueHeader ReadSavedHeader(Reader& reader, std::string_view name, TypeTag type, TypeTag elementType = {}) {
+		ValueHeader header = reader.ReadHeader();
+		if(header.name != name || header.type != type || (type == TypeTag::List && header.elementType != elementType)) throw std::runtime_error("Saved field index is malformed!");
+		return header;
+	}
+
+	FieldIndex FieldIndex::Load(Reader& reader, const ValueEntry& list) {
+		FieldIndex result;
+		ValueHeader header = ReadSavedHeader(reader, "field", TypeTag::String);
+		result.field = reader.ReadString(header.size);
+		ReadSavedHeader(reader, "keyType", TypeTag::UInt8);
+		result.keyType = static_cast<TypeTag>(reader.Read<TypeTag::UInt8>());
+		ReadSavedHeader(reader, "list", TypeTag::UInt64);
+		result.listID = reader.Read<TypeTag::UInt64>();
+		ReadSavedHeader(reader, "listPosition", TypeTag::UInt64);
+		result.listPosition = reader.Read<TypeTag::UInt64>();
+		if(result.listID != list.id || result.listPosition != static_cast<uint64_t>(std::streamoff(list.streamBeginPosition)))
+			throw std::runtime_error("Saved field index was built for a different list!");
+
+		header = ReadSavedHeader(reader, "elements", TypeTag::List, TypeTag::UInt32);
+		if(header.size != list.size) throw std::runtime_error("Saved field index was built for a different list!");
+		result.matches.resize(header.size);
+		for(FieldIndexMatch& match : result.matches) match.element = reader.Read<TypeTag::UInt32>();
+		header = ReadSavedHeader(reader, "positions", TypeTag::List, TypeTag::UInt64);
+		if(header.size != result.matches.size()) throw std::runtime_error("Saved field index is malformed!");
+		for(FieldIndexMatch& match : result.matches) match.position = reader.Read<TypeTag::UInt64>();
+
+		if(result.keyType == TypeTag::String) {
+			header = ReadSavedHeader(reader, "keyOffsets", TypeTag::List, TypeTag::UInt64);
+			if(header.size != result.matches.size() + 1) throw std::runtime_error("Saved field index is malformed!");
+			result.keyOffsets.resize(header.size);
+			for(uint64_t& offset : result.keyOffsets) offset = reader.Read<TypeTag::UInt64>();
+			header = ReadSavedHeader(reader, "keyData", TypeTag::ByteBuffer);
+			result.keyData.resize(header.size);
+			reader->read(result.keyData.data(), header.size);
+			if(reader->eof()) throw std::runtime_error("Unexpected EOF in stream!");
+			if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+
+			//Offsets are used to slice the key data, so they must stay within it
+			if(!std::is_sorted(result.keyOffsets.begin(), result.keyOffsets.end()) || result.keyOffsets.front() != 0 || result.keyOffsets.back() != result.keyData.size())
+				throw std::runtime_error("Saved field index is malformed!");
+		} else {
+			const TypeCategory category = GetTypeTagInfo(result.keyType).category;
+			if(category != TypeCategory::UnsignedInteger && category != TypeCategory::SignedInteger && category != TypeCategory::FloatingPoint)
+				throw std::runtime_error("Saved field index is malformed!");
+			header = ReadSavedHeader(reader, "keys", TypeTag::List, TypeTag::UInt64);
+			if(header.size != result.matches.size()) throw std::runtime_error("Saved field index is malformed!");
+			result.keys.resize(header.size);
+			for(uint64_t& key : result.keys) key = reader.Read<TypeTag::UInt64>();
+		}
+		return result;
+	}
+}
\ No newline at end of file
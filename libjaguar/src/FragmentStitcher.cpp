@@ -0,0 +1,163 @@
+#include "libjaguar/FragmentStitcher.hpp"
+#include "libjaguar/TypeTags.hpp"
+#include "libjaguar/ValueHeader.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace libjaguar {
+	struct FragmentStitcher::Slot {
+		bool substream;
+		std::string name;
+		std::ostringstream* buffer;//Owned by the writer
+		Writer writer;
+		bool complete;
+
+		Slot(bool substream, std::string name, std::unique_ptr<std::ostringstream>&& stream)
+		  : substream(substream), name(std::move(name)), buffer(stream.get()), writer(std::move(stream)), complete(false) {}
+	};
+
+	FragmentStitcher::FragmentStitcher(Writer& output) : output(output), firstSlot(0), failed(false) {}
+
+	FragmentStitcher::~FragmentStitcher() = default;
+
+	std::size_t FragmentStitcher::AddValues() {
+		std::lock_guard lock(slotsMutex);
+		slots.push_back(std::make_unique<Slot>(false, std::string(), std::make_unique<std::ostringstream>(std::ios::binary)));
+		return firstSlot + slots.size() - 1;
+	}
+
+	std::size_t FragmentStitcher::AddSubstream(const std::string& name) {
+		if(name.size() < 1 || name.size() > UINT8_MAX) throw std::runtime_error("Header name string is invalid length!");
+		if(!CheckUTF8(name)) throw std::runtime_error("Header name string is not valid UTF-8!");
+
+		std::lock_guard lock(slotsMutex);
+		slots.push_back(std::make_unique<Slot>(true, name, std::make_unique<std::ostringstream>(std::ios::binary)));
+		return firstSlot + slots.size() - 1;
+	}
+
+	FragmentStitcher::Slot& FragmentStitcher::_GetSlotInternal(std::size_t fragment) {
+		//Callers hold slotsMutex
+		if(failed) throw std::runtime_error("Writing a fragment to the output failed earlier!");
+		if(fragment < firstSlot || fragment - firstSlot >= slots.size()) throw std::runtime_error("Fragment has not been reserved or was already written!");
+		Slot& slot = *slots[fragment - firstSlot];
+		if(slot.complete) throw std::runtime_error("Fragment was already completed!");
+		return slot;
+	}
+
+	Writer& FragmentStitcher::GetWriter(std::size_t fragment) {
+		std::lock_guard lock(slotsMutex);
+		return _GetSlotInternal(fragment).writer;
+	}
+
+	void FragmentStitcher::_WriteSlotInternal(Slot& slot) {
+		std::string_view data = slot.buffer->view();
+		if(slot.substream) {
+			if(data.size() > UINT32_MAX) throw std::runtime_error("Substream fragment is larger than 4 GiB!");
+			ValueHeader header = {};
+			header.type = TypeTag::Substream;
+			header.name = slot.name;
+			header.size = static_cast<uint32_t>(data.size());
+			output.WriteHeader(header);
+		}
+		if(!data.empty()) output->write(data.data(), data.size());
+		if(!output->good()) throw std::runtime_error("Unexpected stream IO error!");
+	}
+
+	void FragmentStitcher::Complete(std::size_t fragment) {
+		{
+			std::lock_guard lock(slotsMutex);
+			_GetSlotInternal(fragment).complete = true;
+		}
+
+		//Write out whatever run of completed fragments is now at the front (if another thread is already doing so, it picks this one up)
+		std::lock_guard outputLock(outputMutex);
+		if(!*output) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		while(true) {
+			Slot* next;
+			{
+				std::lock_guard lock(slotsMutex);
+				if(failed) throw std::runtime_error("Writing a fragment to the output failed earlier!");
+				if(slots.empty() || !slots.front()->complete) break;
+				next = slots.front().get();
+			}
+
+			//A fragment leaves the queue only once it is fully written, and a failed write leaves a hole in the output, so nothing may be written after it
+			try {
+				_WriteSlotInternal(*next);
+			} catch(...) {
+				std::lock_guard lock(slotsMutex);
+				failed = true;
+				frontAdvanced.notify_all();
+				throw;
+			}
+			std::lock_guard lock(slotsMutex);
+			slots.pop_front();
+			++firstSlot;
+			frontAdvanced.notify_all();
+		}
+	}
+
+	void FragmentStitcher::EncodeAll(const std::function<void(std::size_t fragment, Writer& writer)>& encode, unsigned int threadCount) {
+		//Collect the fragments still waiting to be encoded
+		std::vector<std::size_t> fragments;
+		{
+			std::lock_guard lock(slotsMutex);
+			if(failed) throw std::runtime_error("Writing a fragment to the output failed earlier!");
+			for(std::size_t i = 0; i < slots.size(); ++i) {
+				if(!slots[i]->complete) fragments.push_back(firstSlot + i);
+			}
+		}
+		if(fragments.empty()) return;
+
+		//Hand fragments out in order so that completed ones can be stitched and released early
+		if(threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+		threadCount = static_cast<unsigned int>(std::min<std::size_t>(threadCount, fragments.size()));
+		std::atomic<std::size_t> nextFragment = 0;
+		std::atomic<bool> stopped = false;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+		auto worker = [&]() {
+			for(std::size_t idx = nextFragment++; idx < fragments.size() && !stopped; idx = nextFragment++) {
+				try {
+					//Wait while too many fragments are done but stuck behind a slow one at the front; the front fragment is always being encoded, since it was handed out first
+					{
+						std::unique_lock lock(slotsMutex);
+						frontAdvanced.wait(lock, [&]() { return stopped || failed || fragments[idx] - firstSlot <= threadCount; });
+					}
+					if(stopped || failed) break;
+					encode(fragments[idx], GetWriter(fragments[idx]));
+					Complete(fragments[idx]);
+				} catch(...) {
+					std::lock_guard lock(errorMutex);
+					if(!error) error = std::current_exception();
+					stopped = true;
+
+					//Wake the waiting workers so that they stop
+					std::lock_guard slotsLock(slotsMutex);
+					frontAdvanced.notify_all();
+				}
+			}
+		};
+
+		//Use the calling thread as one of the workers
+		std::vector<std::thread> workers;
+		for(unsigned int t = 1; t < threadCount; ++t) workers.emplace_back(worker);
+		worker();
+		for(std::thread& t : workers) t.join();
+		if(error) std::rethrow_exception(error);
+	}
+
+	void FragmentStitcher::Finish() {
+		std::lock_guard lock(slotsMutex);
+		if(failed) throw std::runtime_error("Writing a fragment to the output failed earlier!");
+		if(!slots.empty()) throw std::runtime_error("Not all fragments have been completed!");
+		if(*output) output->flush();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "libjaguar/ListView.hpp"
+#include "Utilities.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace libjaguar {
+	ListViewBase::ListViewBase(Reader& reader, const ValueHeader& header, TypeTag expectedElementType)
+	  : reader(&reader), elementType(header.elementType), count(header.size), typeID(header.typeID), stride(0), streamIndex(0), decodedIndex(UINT32_MAX),
+		listIndex(nullptr), listEntry(nullptr) {
+		if(header.type != TypeTag::List) throw std::runtime_error("Header is not a list header!");
+		if(header.elementType != expectedElementType) throw std::runtime_error("List element type does not match the element type of the view!");
+
+		//Only numbers and booleans have a fixed size
+		stride = GetTypeSize(elementType);
+	}
+
+	static ValueHeader ListHeaderFromEntry(const ValueEntry& entry) {
+		ValueHeader header = {};
+		header.type = entry.type;
+		header.elementType = entry.elementType;
+		header.size = entry.size;
+		header.typeID = entry.typeID;
+		return header;
+	}
+
+	ListViewBase::ListViewBase(Reader& reader, const ValueEntry& entry, TypeTag expectedElementType) : ListViewBase(reader, ListHeaderFromEntry(entry), expectedElementType) {
+		if(!*reader) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		reader->seekg(entry.streamBeginPosition);
+		if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+	}
+
+	ListViewBase::ListViewBase(Reader& reader, const ValueEntry& entry, const Index& index, TypeTag expectedElementType) : ListViewBase(reader, entry, expectedElementType) {
+		listIndex = &index;
+		listEntry = &entry;
+	}
+
+	void ListViewBase::_MoveToInternal(uint32_t index) {
+		if(index == streamIndex) return;
+
+		//With the index, backward and far moves seek to the closest known position first
+		if(listIndex) {
+			std::pair<uint32_t, std::streampos> known(index, listEntry->streamBeginPosition + std::streamoff(uint64_t(index) * stride));
+			if(stride == 0) known = listIndex->FindListCheckpoint(*listEntry, index);
+			if(index < streamIndex || known.first > streamIndex) {
+				std::istream* stream = **reader;
+				if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+				stream->seekg(known.second);
+				if(!stream->good()) throw std::runtime_error("Unexpected stream IO error!");
+				streamIndex = known.first;
+				if(index == streamIndex) return;
+			}
+		}
+		if(index < streamIndex) throw std::runtime_error("List view elements can only be read in order!");
+
+		if(stride > 0) {
+			//Skip all fixed-size elements at once
+			std::istream* stream = **reader;
+			if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+			stream->ignore(std::streamsize(uint64_t(index - streamIndex) * stride));
+			if(stream->eof()) throw std::runtime_error("Unexpected EOF in stream!");
+			if(!stream->good()) throw std::runtime_error("Unexpected stream IO error!");
+		} else {
+			//Everything else has to be walked element by element
+			for(uint32_t i = streamIndex; i < index; ++i) {
+				ValueHeader header = reader->ReadElementHeader(elementType);
+				reader->SkipBody(header);
+			}
+		}
+		streamIndex = index;
+	}
+
+	void ListViewBase::SkipTo(uint32_t index, std::streampos position) {
+		if(index >= count) throw std::runtime_error("Out of bounds list element access!");
+		std::istream* stream = **reader;
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		stream->seekg(position);
+		if(!stream->good()) throw std::runtime_error("Unexpected stream IO error!");
+		streamIndex = index;
+	}
+
+	void ListElement<std::string_view>::Decode(Reader& reader) {
+		ValueHeader header = reader.ReadElementHeader(TypeTag::String);
+		if(header.size >= (1u << 24)) throw std::runtime_error("String is longer than maximum legal size!");
+
+		//Reuse the buffer of the previous element
+		value.resize(header.size);
+		reader->read(value.data(), header.size);
+		if(reader->eof()) throw std::runtime_error("Unexpected EOF in stream!");
+		if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+		if(!CheckUTF8(value)) throw std::runtime_error("Read string is not valid UTF-8!");
+	}
+
+	void StructView::_ReadInternal(Reader& reader) {
+		fieldCount = 0;
+		data.clear();
+		while(true) {
+			//Reuse field entries (and their string buffers) from the previous element
+			if(fieldCount == fields.size()) fields.emplace_back();
+			Field& field = fields[fieldCount];
+			reader.ReadHeader(field.header);
+			if(field.header.type == TypeTag::ScopeBoundary) break;
+			++fieldCount;
+
+			//Work out the size of the body, if it is worth keeping
+			uint64_t size = GetTypeSize(field.header.type);
+			switch(field.header.type) {
+				case TypeTag::String:
+				case TypeTag::ByteBuffer: size = field.header.size; break;
+				case TypeTag::Vector:
+				case TypeTag::Matrix:
+					size = uint64_t(GetTypeSize(field.header.elementType)) * field.header.width * (field.header.type == TypeTag::Matrix ? field.header.height : 1);
+					if(field.header.elementType == TypeTag::Boolean) throw std::runtime_error("Cannot skip a vector or matrix with a non-numeric element type!");
+					break;
+				default: break;
+			}
+
+			//Nested lists and objects are not kept, and neither are substreams, which may be arbitrarily large
+			if(field.header.type == TypeTag::Substream) field.position = reader->tellg();
+			field.stored = (size > 0 || field.header.type == TypeTag::String || field.header.type == TypeTag::ByteBuffer);
+			if(!field.stored) {
+				reader.SkipBody(field.header);
+				continue;
+			}
+			field.offset = data.size();
+			field.size = size;
+			data.resize(data.size() + size);
+			reader->read(reinterpret_cast<char*>(data.data() + field.offset), size);
+			if(reader->eof()) throw std::runtime_error("Unexpected EOF in stream!");
+			if(!reader->good()) throw std::runtime_error("Unexpected stream IO error!");
+			if(field.header.type == TypeTag::String && !CheckUTF8(std::string_view(reinterpret_cast<const char*>(data.data() + field.offset), size))) throw std::runtime_error("Read string is not valid UTF-8!");
+			if(field.header.type == TypeTag::Boolean && data[field.offset] > 1) throw std::runtime_error("Read byte is not a possible boolean value!");
+		}
+	}
+
+	const ValueHeader& StructView::GetFieldHeader(std::size_t index) const {
+		if(index >= fieldCount) throw std::runtime_error("Out of bounds field access");
+		return fields[index].header;
+	}
+
+	const StructView::Field* StructView::_FindInternal(std::string_view name) const {
+		for(std::size_t i = 0; i < fieldCount; ++i) {
+			if(fields[i].header.name == name) return &fields[i];
+		}
+		return nullptr;
+	}
+
+	bool StructView::HasField(std::string_view name) const {
+		return _FindInternal(name) != nullptr;
+	}
+
+	std::span<const unsigned char> StructView::_GetInternal(std::string_view name, TypeTag type) const {
+		const Field* field = _FindInternal(name);
+		if(!field) throw std::runtime_error("No field exists with the requested name!");
+		if(field->header.type != type) throw std::runtime_error("Field type does not match the requested type!");
+		return std::span<const unsigned char>(data.data() + field->offset, field->size);
+	}
+
+	std::streampos StructView::GetSubstreamPosition(std::string_view name) const {
+		const Field* field = _FindInternal(name);
+		if(!field) throw std::runtime_error("No field exists with the requested name!");
+		if(field->header.type != TypeTag::Substream) throw std::runtime_error("Field type does not match the requested type!");
+		return field->position;
+	}
+
+	std::span<const unsigned char> StructView::GetBytes(std::string_view name) const {
+		const Field* field = _FindInternal(name);
+		if(!field) throw std::runtime_error("No field exists with the requested name!");
+		if(!field->stored || GetTypeSize(field->header.type) > 0 || field->header.type == TypeTag::String) throw std::runtime_error("Field type does not match the requested type!");
+		return std::span<const unsigned char>(data.data() + field->offset, field->size);
+	}
+}
\ No newline at end of file
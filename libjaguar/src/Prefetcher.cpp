@@ -0,0 +1,198 @@
+#include "libjaguar/Prefetcher.hpp"
+#include "libjaguar/TypeTags.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace libjaguar {
+	static uint64_t GetBodySize(const ValueEntry& entry) {
+		switch(entry.type) {
+			case TypeTag::String:
+			case TypeTag::ByteBuffer:
+			case TypeTag::Substream: return entry.size;
+			case TypeTag::Vector: return uint64_t(GetTypeSize(entry.elementType)) * entry.width;
+			case TypeTag::Matrix: return uint64_t(GetTypeSize(entry.elementType)) * entry.width * entry.height;
+			case TypeTag::List: return uint64_t(GetTypeSize(entry.elementType)) * entry.size;//0 for variable-size elements
+			default: return GetTypeSize(entry.type);
+		}
+	}
+
+	std::vector<ReadRange> PlanReadRanges(const ScopeEntry& scope, std::span<const std::string_view> fields) {
+		struct Item {
+			ReadRange range;
+			bool wanted;
+		};
+
+		//Collect every entry, since unwanted ones still mark where the wanted ones end
+		std::vector<Item> items;
+		items.reserve(scope.subvalues.size() + scope.subscopes.size());
+		auto isWanted = [&](std::string_view name) { return fields.empty() || std::find(fields.begin(), fields.end(), name) != fields.end(); };
+		for(const ValueEntry& value : scope.subvalues) items.push_back({{uint64_t(std::streamoff(value.streamBeginPosition)), GetBodySize(value)}, isWanted(value.name)});
+		for(const ScopeEntry& subscope : scope.subscopes) items.push_back({{uint64_t(std::streamoff(subscope.streamBeginPosition)), 0}, isWanted(subscope.name)});
+		std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.range.begin < b.range.begin; });
+
+		std::vector<ReadRange> ranges;
+		for(std::size_t i = 0; i < items.size(); ++i) {
+			if(!items[i].wanted) continue;
+			ReadRange range = items[i].range;
+			if(range.size == 0 && i + 1 < items.size()) range.size = items[i + 1].range.begin - range.begin;
+			ranges.push_back(range);
+		}
+		return ranges;
+	}
+
+	Prefetcher::Prefetcher(const std::string& path, std::vector<ReadRange> plan, const PrefetchOptions& options)
+	  : options(options), fd(-1), memory(nullptr), memorySize(0), consumerPosition(0), hintedRange(0), readRange(0), readPosition(0), stopping(false) {
+#ifndef _WIN32
+		fd = open(path.c_str(), O_RDONLY);
+		if(fd < 0) throw std::runtime_error("Cannot open the file to prefetch!");
+#else
+		(void)path;
+#endif
+		_StartInternal(std::move(plan));
+	}
+
+	Prefetcher::Prefetcher(std::span<const unsigned char> memory, std::vector<ReadRange> plan, const PrefetchOptions& options)
+	  : options(options), fd(-1), memory(memory.data()), memorySize(memory.size()), consumerPosition(0), hintedRange(0), readRange(0), readPosition(0), stopping(false) {
+		_StartInternal(std::move(plan));
+	}
+
+	Prefetcher::~Prefetcher() {
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		if(worker.joinable()) worker.join();
+#ifndef _WIN32
+		if(fd >= 0) close(fd);
+#endif
+	}
+
+	void Prefetcher::_StartInternal(std::vector<ReadRange>&& ranges) {
+		plan = std::move(ranges);
+		std::sort(plan.begin(), plan.end(), [](const ReadRange& a, const ReadRange& b) { return a.begin < b.begin; });
+
+		//Ranges of unknown size are prefetched up to the window size
+		for(ReadRange& range : plan) {
+			if(range.size == 0) range.size = options.window;
+		}
+
+#ifndef _WIN32
+		if(options.readaheadBufferSize > 0 && (fd >= 0 || memory)) worker = std::thread(&Prefetcher::_WorkerInternal, this);
+#endif
+		Advance(0);
+	}
+
+	void Prefetcher::_HintInternal(const ReadRange& range, bool willNeed) {
+		if(range.size == 0) return;
+#ifndef _WIN32
+		if(fd >= 0) {
+#ifdef POSIX_FADV_WILLNEED
+			posix_fadvise(fd, off_t(range.begin), off_t(range.size), willNeed ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED);
+#endif
+		} else if(memory && range.begin < memorySize) {
+			//madvise works on whole pages
+			static const uintptr_t pageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+			const uintptr_t begin = reinterpret_cast<uintptr_t>(memory + range.begin) & ~(pageSize - 1);
+			const uintptr_t end = reinterpret_cast<uintptr_t>(memory + std::min(range.begin + range.size, memorySize));
+			if(willNeed) {
+				madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+			} else {
+#ifdef MADV_COLD
+				//The memory might not be backed by a file, so it must not be discarded outright
+				madvise(reinterpret_cast<void*>(begin), end - begin, MADV_COLD);
+#endif
+			}
+		}
+#else
+		(void)willNeed;
+#endif
+	}
+
+	void Prefetcher::Advance(uint64_t position) {
+		std::vector<ReadRange> hints;
+		{
+			std::lock_guard lock(mutex);
+
+			//Going back means starting over
+			if(position < consumerPosition) {
+				hintedRange = 0;
+				readRange = 0;
+				readPosition = 0;
+			}
+			consumerPosition = position;
+
+			//Announce the ranges that now fall within the window
+			const uint64_t windowEnd = position + options.window;
+			while(hintedRange < plan.size() && plan[hintedRange].begin < windowEnd) {
+				const ReadRange& range = plan[hintedRange];
+				if(range.begin + range.size > position) {
+					const uint64_t begin = std::max(range.begin, position);
+					hints.push_back({begin, std::min(range.begin + range.size, windowEnd) - begin});
+				}
+				if(range.begin + range.size > windowEnd) break;//Hinted again once the window has moved on
+				++hintedRange;
+			}
+		}
+		for(const ReadRange& hint : hints) _HintInternal(hint, true);
+		wake.notify_one();
+	}
+
+	void Prefetcher::Drop(const ReadRange& range) {
+		if(range.size < options.dropThreshold) return;
+		_HintInternal(range, false);
+	}
+
+	void Prefetcher::_WorkerInternal() {
+#ifndef _WIN32
+		std::vector<char> buffer(options.readaheadBufferSize);
+		const uint64_t pageSize = uint64_t(sysconf(_SC_PAGESIZE));
+		std::unique_lock lock(mutex);
+		while(true) {
+			//Find the next piece of the window that has not been read yet
+			ReadRange next = {0, 0};
+			wake.wait(lock, [&]() {
+				if(stopping) return true;
+				const uint64_t windowEnd = consumerPosition + options.window;
+				while(readRange < plan.size() && plan[readRange].begin < windowEnd) {
+					const ReadRange& range = plan[readRange];
+					const uint64_t begin = std::max({range.begin, readPosition, consumerPosition});
+					const uint64_t end = std::min(range.begin + range.size, windowEnd);
+					if(begin < end) {
+						next = {begin, std::min<uint64_t>(end - begin, buffer.size())};
+						return true;
+					}
+					if(range.begin + range.size > windowEnd) return false;
+					++readRange;
+				}
+				return false;
+			});
+			if(stopping) return;
+			readPosition = next.begin + next.size;
+
+			//Read without holding the lock; the data only has to reach the page cache
+			lock.unlock();
+			if(fd >= 0) {
+				if(pread(fd, buffer.data(), next.size, off_t(next.begin)) <= 0) next.size = 0;
+			} else if(next.begin < memorySize) {
+				//Touch every page
+				volatile unsigned char sink = 0;
+				const uint64_t end = std::min(next.begin + next.size, memorySize);
+				for(uint64_t at = next.begin; at < end; at += pageSize) sink = sink + memory[at];
+			}
+			lock.lock();
+
+			//Past the end of the file, there is nothing more to read
+			if(next.size == 0) readPosition = UINT64_MAX;
+		}
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "libjaguar/PreparedHeader.hpp"
+#include "Utilities.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace libjaguar {
+	PreparedHeader::PreparedHeader(const ValueHeader& header, bool noIdentifier) : length(0), type(header.type), hasSize(false) {
+		//Scope boundaries are just the tag
+		if(header.type == TypeTag::ScopeBoundary) {
+			bytes[length++] = static_cast<char>(header.type);
+			return;
+		}
+
+		//Basic checks for other types (list elements have no name)
+		if(!noIdentifier) {
+			if(header.name.size() < 1 || header.name.size() > UINT8_MAX) throw std::runtime_error("Header name string is invalid length!");
+			if(!CheckUTF8(header.name)) throw std::runtime_error("Header name string is not valid UTF-8!");
+		}
+		if(header.type == TypeTag::StructuredObj || header.type == TypeTag::StructuredObjTypeDecl || (header.type == TypeTag::List && header.elementType == TypeTag::StructuredObj)) {
+			if(header.typeID.size() < 1 || header.typeID.size() > UINT8_MAX) throw std::runtime_error("Header type ID string is invalid length!");
+			if(!CheckUTF8(header.typeID)) throw std::runtime_error("Header type ID string is not valid UTF-8!");
+		}
+
+		auto putByte = [this](uint8_t value) {
+			bytes[length++] = static_cast<char>(value);
+		};
+		auto putString = [&](std::string_view value) {
+			putByte(static_cast<uint8_t>(value.size()));
+			std::memcpy(bytes.data() + length, value.data(), value.size());
+			length += static_cast<uint16_t>(value.size());
+		};
+		auto putInteger = [&](uint64_t value, uint8_t byteCount) {
+			for(uint8_t i = 0; i < byteCount; ++i) {
+				putByte(static_cast<uint8_t>(value & 0xFF));
+				value >>= 8;
+			}
+		};
+
+		//Identifier
+		if(!noIdentifier) {
+			putByte(static_cast<uint8_t>(header.type));
+			putString(header.name);
+		}
+
+		//Type-specific data
+		switch(header.type) {
+			case TypeTag::List:
+				putByte(static_cast<uint8_t>(header.elementType));
+				if(header.elementType == TypeTag::StructuredObj) putString(header.typeID);
+				putInteger(header.size, 4);
+				hasSize = true;
+				break;
+			case TypeTag::Vector:
+				putByte(static_cast<uint8_t>(header.elementType));
+				putByte(header.width);
+				break;
+			case TypeTag::Matrix:
+				putByte(static_cast<uint8_t>(header.elementType));
+				putByte(header.width);
+				putByte(header.height);
+				break;
+			case TypeTag::StructuredObj: putString(header.typeID); break;
+			case TypeTag::StructuredObjTypeDecl:
+				putString(header.typeID);
+				putInteger(header.fieldCount, 2);
+				break;
+			case TypeTag::UnstructuredObj: putInteger(header.fieldCount, 2); break;
+			case TypeTag::String:
+			case TypeTag::ByteBuffer:
+			case TypeTag::Substream:
+				putInteger(header.size, 4);
+				hasSize = true;
+				break;
+			default: break;
+		}
+	}
+}
\ No newline at end of file
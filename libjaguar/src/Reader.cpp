@@ -105,17 +105,6 @@ namespace libjaguar {
 		return data;
 	}
 
-	bool ValidateTypeTag(uint8_t tagByte) {
-		if(tagByte < 0x0A || tagByte > 0x4B) return false;
-		uint8_t lowerNibble = (tagByte & 0b0000'1111);
-		uint8_t upperNibble = (tagByte & 0b1111'0000) >> 4;
-		if(lowerNibble < 0xA) return false;
-		if((upperNibble == 1 || upperNibble == 2) && lowerNibble > 0xD) return false;
-		if(upperNibble == 4 && lowerNibble > 0xB) return false;
-		if(tagByte == 0x3F) return false;
-		return true;
-	}
-
 	SVHandle Reader::ReadBuffer(uint32_t length) {
 		VerifyOk();
 
@@ -131,19 +120,31 @@ namespace libjaguar {
 		return svh;
 	}
 
-	ValueHeader Reader::ReadHeader() {
+	ValueHeader Reader::ReadHeader(const ValueHeader::allocator_type& alloc) {
+		ValueHeader header(alloc);
+		ReadHeader(header);
+		return header;
+	}
+
+	void Reader::ReadHeader(ValueHeader& header) {
 		VerifyOk();
+		TRACE_SAMPLED_SPAN("ReadHeader", "reader");
 
-		//Create result object
-		ValueHeader header;
+		//Clear what the previous header left behind, keeping the string buffers
+		header.name.clear();
+		header.elementType = {};
+		header.size = 0;
+		header.width = 0;
+		header.height = 0;
+		header.fieldCount = 0;
+		header.typeID.clear();
 
 		//Read and validate type tag
 		uint8_t tagByte = stream->get();
 		STREAMCHECK;
-		if(!ValidateTypeTag(tagByte)) throw std::runtime_error("Read TypeTag is invalid!");
-		uint8_t upperNibble = (tagByte & 0b1111'0000) >> 4;
+		if(!IsValidTypeTag(tagByte)) throw std::runtime_error("Read TypeTag is invalid!");
 		header.type = (TypeTag)tagByte;
-		if(header.type == TypeTag::ScopeBoundary) return header;
+		if(header.type == TypeTag::ScopeBoundary) return;
 
 		//Read and check name string
 		uint8_t nameLen = _ReadIntegerInternal(8);
@@ -153,86 +154,281 @@ namespace libjaguar {
 		STREAMCHECK;
 		if(!CheckUTF8(header.name)) throw std::runtime_error("Read name string is not valid UTF-8!");
 
+		//Read the rest of the header
+		_ReadHeaderDataInternal(header);
+	}
+
+	ValueHeader Reader::ReadElementHeader(TypeTag elementType, const ValueHeader::allocator_type& alloc) {
+		VerifyOk();
+		const TypeTagInfo& info = GetTypeTagInfo(elementType);
+		if(!info.valid || info.category == TypeCategory::Boundary || info.category == TypeCategory::Declaration) throw std::runtime_error("Invalid list element TypeTag!");
+
+		//Elements have no identifier, so only the type-specific data is present
+		//Structured object elements take their type ID from the list header and have no header data at all
+		ValueHeader header(alloc);
+		header.type = elementType;
+		if(elementType != TypeTag::StructuredObj) _ReadHeaderDataInternal(header);
+		return header;
+	}
+
+	void Reader::_ReadHeaderDataInternal(ValueHeader& header) {
 		//For simple types, we're done
-		//We can check this easily using the tag byte
-		if((upperNibble == 1 || upperNibble == 2) || header.type == TypeTag::Float32 || header.type == TypeTag::Float64 || header.type == TypeTag::Boolean) return header;
+		const uint8_t fields = GetTypeTagInfo(header.type).headerFields;
+		if(fields == 0) return;
 
-		//More complex data
-		switch(header.type) {
-			case TypeTag::List: {
-				//Get element TypeTag
-				uint8_t elemTagByte = stream->get();
-				STREAMCHECK;
-				if(!ValidateTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
-				header.elementType = (TypeTag)elemTagByte;
-
-				//Structured object typename handling
-				if(header.elementType == TypeTag::StructuredObj) {
-					uint8_t typeIDLen = _ReadIntegerInternal(8);
-					if(typeIDLen == 0) throw std::runtime_error("Encountered empty type ID string for list of structured objects!");
-					header.typeID.resize(typeIDLen);
-					stream->read(header.typeID.data(), typeIDLen);
+		//The rest is read in stream order
+		if(fields & HeaderField::ElementType) {
+			uint8_t elemTagByte = stream->get();
+			STREAMCHECK;
+			if(!IsValidTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
+			header.elementType = (TypeTag)elemTagByte;
+		}
+		if((fields & HeaderField::ElementTypeID) && header.elementType == TypeTag::StructuredObj) _ReadShortStringInternal(header.typeID, "type ID");
+		if(fields & HeaderField::TypeID) _ReadShortStringInternal(header.typeID, "type ID");
+		if(fields & HeaderField::Width) header.width = (uint8_t)_ReadIntegerInternal(8);
+		if(fields & HeaderField::Height) header.height = (uint8_t)_ReadIntegerInternal(8);
+		if(fields & HeaderField::FieldCount) header.fieldCount = (uint16_t)_ReadIntegerInternal(16);
+		if(fields & HeaderField::Size) header.size = (uint32_t)_ReadIntegerInternal(32);
+	}
+
+	void Reader::SkipBody(const ValueHeader& header) {
+		VerifyOk();
+		_SkipBodyInternal(header, 0);
+	}
+
+	void Reader::_DiscardInternal(uint64_t byteCount) {
+		if(byteCount == 0) return;
+
+		//Large ranges are seeked over rather than read through, if the stream allows it
+		if(byteCount > minSeekDiscardSize) {
+			const std::streampos position = stream->tellg();
+			if(position != std::streampos(-1)) {
+				//Seeking past the end is not an error in itself, so the last byte is read to make sure it exists
+				stream->seekg(position + std::streamoff(byteCount - 1));
+				if(stream->good()) {
+					stream->get();
 					STREAMCHECK;
-					if(!CheckUTF8(header.typeID)) throw std::runtime_error("Encountered a type ID string that is not valid UTF-8!");
+					return;
 				}
 
-				//Get element count
-				header.size = (uint32_t)_ReadIntegerInternal(32);
-				break;
+				//Some streams refuse to seek past their end instead, which is left for ignore() to report as EOF
+				stream->clear();
 			}
-			case TypeTag::Vector: {
-				//Get element TypeTag
-				uint8_t elemTagByte = stream->get();
-				STREAMCHECK;
-				if(!ValidateTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
-				header.elementType = (TypeTag)elemTagByte;
-
-				//Get vector width
-				header.width = (uint8_t)_ReadIntegerInternal(8);
+		}
+		stream->ignore(byteCount);
+		STREAMCHECK;
+	}
+
+	void Reader::_SkipBodyInternal(const ValueHeader& header, uint8_t depth) {
+		switch(header.type) {
+			case TypeTag::String:
+			case TypeTag::ByteBuffer:
+			case TypeTag::Substream:
+				_DiscardInternal(header.size);
 				break;
-			}
+			case TypeTag::Vector:
 			case TypeTag::Matrix: {
-				//Get element TypeTag
-				uint8_t elemTagByte = stream->get();
-				STREAMCHECK;
-				if(!ValidateTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
-				header.elementType = (TypeTag)elemTagByte;
-
-				//Get matrix width and height
-				header.width = (uint8_t)_ReadIntegerInternal(8);
-				header.height = (uint8_t)_ReadIntegerInternal(8);
+				uint32_t elemSize = GetTypeSize(header.elementType);
+				if(elemSize == 0 || header.elementType == TypeTag::Boolean) throw std::runtime_error("Cannot skip a vector or matrix with a non-numeric element type!");
+				_DiscardInternal(uint64_t(elemSize) * header.width * (header.type == TypeTag::Matrix ? header.height : 1));
 				break;
 			}
-			case TypeTag::StructuredObj:
-			case TypeTag::StructuredObjTypeDecl: {
-				//Read and check type ID string
-				uint8_t typeIDLen = _ReadIntegerInternal(8);
-				if(typeIDLen == 0) throw std::runtime_error("Encountered empty type ID string!");
-				header.typeID.resize(typeIDLen);
-				stream->read(header.typeID.data(), typeIDLen);
-				STREAMCHECK;
-				if(!CheckUTF8(header.typeID)) throw std::runtime_error("Encountered a type ID string that is not valid UTF-8!");
-
-				//Break for StructuredObj (StructuredObjTypeDecl has same next field as UnstructuredObj so we intentionally fallthrough there)
-				if(header.type == TypeTag::StructuredObj) break;
+			case TypeTag::List: {
+				if(depth >= maxScopeDepth) throw std::runtime_error("Maximum nesting depth exceeded while skipping a list!");
+
+				//Fixed-size elements can be skipped all at once
+				uint32_t elemSize = GetTypeSize(header.elementType);
+				if(elemSize > 0) {
+					_DiscardInternal(uint64_t(elemSize) * header.size);
+					break;
+				}
+
+				//Everything else has to be walked element by element
+				for(uint32_t i = 0; i < header.size; ++i) {
+					ValueHeader elemHeader = ReadElementHeader(header.elementType);
+					_SkipBodyInternal(elemHeader, depth + 1);
+				}
+				break;
 			}
 			case TypeTag::UnstructuredObj:
-				//Get field count
-				header.fieldCount = (uint16_t)_ReadIntegerInternal(16);
+			case TypeTag::StructuredObj: {
+				if(depth >= maxScopeDepth) throw std::runtime_error("Maximum nesting depth exceeded while skipping an object!");
+
+				//Skip fields until we see the closing boundary
+				while(true) {
+					ValueHeader fieldHeader = ReadHeader();
+					if(fieldHeader.type == TypeTag::ScopeBoundary) break;
+					_SkipBodyInternal(fieldHeader, depth + 1);
+				}
 				break;
-			case TypeTag::String:
-			case TypeTag::ByteBuffer:
-			case TypeTag::Substream:
-				//Get buffer size
-				header.size = _ReadIntegerInternal(32);
+			}
+			case TypeTag::StructuredObjTypeDecl: ReadTypeDeclaration(header); break;
+			case TypeTag::ScopeBoundary: break;
+			default:
+				_DiscardInternal(GetTypeSize(header.type));
 				break;
-			default: break;
 		}
-		return header;
+	}
+
+	void Reader::_ReadShortStringInternal(std::pmr::string& out, const char* what) {
+		uint8_t length = _ReadIntegerInternal(8);
+		if(length == 0) throw std::runtime_error(std::string("Encountered an empty ") + what + " string!");
+		out.resize(length);
+		stream->read(out.data(), length);
+		STREAMCHECK;
+		if(!CheckUTF8(out)) throw std::runtime_error(std::string("Encountered a ") + what + " string that is not valid UTF-8!");
+	}
+
+	StructuredTypeLayout Reader::ReadTypeDeclaration(const ValueHeader& header, const StructuredTypeLayout::allocator_type& alloc) {
+		StructuredTypeLayout layout(alloc);
+		ReadTypeDeclaration(header, layout);
+		return layout;
+	}
+
+	void Reader::ReadTypeDeclaration(const ValueHeader& header, StructuredTypeLayout& layout) {
+		VerifyOk();
+		if(header.type != TypeTag::StructuredObjTypeDecl) throw std::runtime_error("Header is not a structured object type declaration!");
+
+		layout.typeID = header.typeID;
+		layout.fields.resize(header.fieldCount);
+		for(uint16_t i = 0; i < header.fieldCount; ++i) {
+			//Field identifier (fields may hold data from a previous declaration)
+			StructuredTypeLayout::Field& field = layout.fields[i];
+			field.elementType = TypeTag{};
+			field.elementTypeID.clear();
+			field.width = 0;
+			field.height = 0;
+			uint8_t tagByte = stream->get();
+			STREAMCHECK;
+			if(!IsValidTypeTag(tagByte)) throw std::runtime_error("Encountered invalid field TypeTag in type declaration!");
+			field.type = (TypeTag)tagByte;
+			_ReadShortStringInternal(field.name, "field name");
+
+			//Generic types keep their header data (minus list sizes)
+			switch(field.type) {
+				case TypeTag::List: {
+					uint8_t elemTagByte = stream->get();
+					STREAMCHECK;
+					if(!IsValidTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
+					field.elementType = (TypeTag)elemTagByte;
+					if(field.elementType == TypeTag::StructuredObj) _ReadShortStringInternal(field.elementTypeID, "type ID");
+					break;
+				}
+				case TypeTag::Vector:
+				case TypeTag::Matrix: {
+					uint8_t elemTagByte = stream->get();
+					STREAMCHECK;
+					if(!IsValidTypeTag(elemTagByte)) throw std::runtime_error("Encountered invalid element TypeTag!");
+					field.elementType = (TypeTag)elemTagByte;
+					field.width = (uint8_t)_ReadIntegerInternal(8);
+					if(field.type == TypeTag::Matrix) field.height = (uint8_t)_ReadIntegerInternal(8);
+					break;
+				}
+				case TypeTag::StructuredObj:
+					_ReadShortStringInternal(field.elementTypeID, "type ID");
+					break;
+				default: break;
+			}
+		}
+
+		//Declarations are closed like any other scope
+		uint8_t boundary = stream->get();
+		STREAMCHECK;
+		if(boundary != static_cast<uint8_t>(TypeTag::ScopeBoundary)) throw std::runtime_error("Type declaration does not end with a scope boundary!");
+	}
+
+	void TargetRegion(RegionIstream& region, std::istream& parent, uint64_t begin, uint64_t size) {
+		//Memory is read in place; nested regions of a stream go straight to the underlying stream rather than through each other
+		RegionStreambuf* parentRegion = dynamic_cast<RegionStreambuf*>(parent.rdbuf());
+		if(parentRegion && (begin > parentRegion->GetRegionSize() || size > parentRegion->GetRegionSize() - begin)) throw std::runtime_error("Region extends past the end of the stream!");
+		if(parentRegion && parentRegion->GetMemory()) {
+			region.GetBuffer().SetMemory(parentRegion->GetMemory() + begin, size);
+		} else if(parentRegion) {
+			region.GetBuffer().SetSource(parentRegion->GetSource(), parentRegion->GetRegionBegin() + begin, size);
+		} else {
+			region.GetBuffer().SetSource(parent.rdbuf(), begin, size);
+		}
+		region.clear();
+	}
+
+	Reader Reader::FromMemory(std::span<const unsigned char> data) {
+		std::unique_ptr<RegionIstream> region = std::make_unique<RegionIstream>();
+		region->GetBuffer().SetMemory(reinterpret_cast<const char*>(data.data()), data.size());
+		return Reader(std::move(region));
+	}
+
+	void Reader::Reset(std::span<const unsigned char> data) {
+		//Region streams can simply be pointed at the new memory
+		RegionIstream* region = dynamic_cast<RegionIstream*>(stream.get());
+		if(!region) {
+			stream = std::make_unique<RegionIstream>();
+			region = static_cast<RegionIstream*>(stream.get());
+		}
+		region->GetBuffer().SetMemory(reinterpret_cast<const char*>(data.data()), data.size());
+		region->clear();
+		_InvalidateViewInternal();
+	}
+
+	void Reader::Reset(std::unique_ptr<std::istream>&& istream) {
+		//The view refers to the old stream, so it goes first
+		_InvalidateViewInternal();
+		stream = std::move(istream);
+	}
+
+	void Reader::_InvalidateViewInternal() {
+		if(!view) return;
+		view->valid = false;
+		*viewState = false;
+		view.reset();
+	}
+
+	Reader Reader::Pipelined(std::unique_ptr<std::istream>&& istream, const PipelineOptions& options) {
+		if(!istream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		return Reader(std::make_unique<PipelinedIstream>(std::move(istream), options.blockSize, options.depth));
+	}
+
+	Reader Reader::OpenRegion(std::streampos begin, uint64_t size) {
+		VerifyOk();
+		if(begin < 0) throw std::runtime_error("Invalid region position!");
+
+		std::unique_ptr<RegionIstream> region = std::make_unique<RegionIstream>();
+		TargetRegion(*region, *stream, static_cast<uint64_t>(std::streamoff(begin)), size);
+		return Reader(std::move(region));
+	}
+
+	Reader Reader::OpenSubstream(const ValueHeader& header) {
+		VerifyOk();
+		if(header.type != TypeTag::Substream) throw std::runtime_error("Header is not a substream header!");
+		TRACE_SPAN("OpenSubstream", "reader");
+
+		const std::streampos begin = stream->tellg();
+		if(begin == std::streampos(-1)) throw std::runtime_error("Opening a substream requires a seekable stream!");
+		Reader child = OpenRegion(begin, header.size);
+		_SeekPastInternal(begin, header.size);
+		return child;
+	}
+
+	void Reader::_SeekPastInternal(std::streampos begin, uint64_t size) {
+		//Seek rather than read over the range, but check that it is all there
+		stream->seekg(0, std::ios::end);
+		const std::streampos end = stream->tellg();
+		if(end == std::streampos(-1) || uint64_t(std::streamoff(end - begin)) < size) throw std::runtime_error("Unexpected EOF in stream!");
+		stream->seekg(begin + std::streamoff(size));
+		STREAMCHECK;
 	}
 
 	ScopedView::ScopedView(std::istream* streamPtr, std::streamoff size)
-	  : stream(streamPtr), end(stream->tellg() + size), valid(true), eof(false) {}
+	  : stream(streamPtr), end(stream->tellg() + size), valid(true), eof(false) {
+#ifdef LJTRACING
+		traceStart = BeginTraceSpan(false);
+#endif
+	}
+
+	ScopedView::~ScopedView() {
+#ifdef LJTRACING
+		if(traceStart != 0) EmitTraceSpan("View", "reader", {}, traceStart);
+#endif
+	}
 
 	void ScopedView::_ReadInternal(std::span<unsigned char>& out, uint32_t byteCount) {
 		if(!valid || eof) throw std::runtime_error("Cannot perform operations on an invalid scoped read view!");
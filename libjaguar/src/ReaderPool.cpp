@@ -0,0 +1,46 @@
+#include "libjaguar/ReaderPool.hpp"
+#include "libjaguar/TypeTags.hpp"
+#include "Utilities.hpp"
+
+#include <stdexcept>
+
+namespace libjaguar {
+	ReaderPool::ReaderPool(Reader& parent) : parent(parent) {}
+
+	Reader ReaderPool::Acquire(std::streampos begin, uint64_t size) {
+		std::unique_lock lock(mutex);
+		if(released.empty()) {
+			lock.unlock();
+			return parent.OpenRegion(begin, size);
+		}
+		Reader child = std::move(released.back());
+		released.pop_back();
+		lock.unlock();
+
+		//Point the released child's stream at the new range
+		parent.VerifyOk();
+		if(begin < 0) throw std::runtime_error("Invalid region position!");
+		TargetRegion(*static_cast<RegionIstream*>(child.stream.get()), *parent.stream, static_cast<uint64_t>(std::streamoff(begin)), size);
+		return child;
+	}
+
+	Reader ReaderPool::AcquireSubstream(const ValueHeader& header) {
+		parent.VerifyOk();
+		if(header.type != TypeTag::Substream) throw std::runtime_error("Header is not a substream header!");
+
+		const std::streampos begin = parent.stream->tellg();
+		if(begin == std::streampos(-1)) throw std::runtime_error("Opening a substream requires a seekable stream!");
+		Reader child = Acquire(begin, header.size);
+		parent._SeekPastInternal(begin, header.size);
+		return child;
+	}
+
+	void ReaderPool::Release(Reader&& child) {
+		//Only region streams can be pointed somewhere else
+		if(!dynamic_cast<RegionIstream*>(child.stream.get())) return;
+
+		//Moving drops any scoped view the child still had
+		std::lock_guard lock(mutex);
+		released.push_back(std::move(child));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "libjaguar/StructuredListEncoder.hpp"
+#include "libjaguar/ValueHeader.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace libjaguar {
+	//Encoded elements are collected into blocks of about this size before they are written
+	constexpr inline std::size_t encodeBlockSize = 64 * 1024;//64 KiB (one KiB is 1024 bytes)
+
+	static bool IsFixedFieldType(TypeTag type) {
+		return GetTypeSize(type) > 0 || type == TypeTag::Vector || type == TypeTag::Matrix;
+	}
+
+	StructuredListEncoder::StructuredListEncoder(const StructuredTypeLayout& layout, std::span<const FieldBinding> bindings, std::size_t elementSize)
+	  : typeID(layout.typeID), elementSize(elementSize) {
+		if(!ValidateTypeLayout(layout)) throw std::runtime_error("Cannot encode with an invalid type layout!");
+
+		//Match bindings to fields
+		std::vector<const FieldBinding*> bound(layout.fields.size(), nullptr);
+		for(const FieldBinding& binding : bindings) {
+			auto it = std::find_if(layout.fields.begin(), layout.fields.end(), [&](const StructuredTypeLayout::Field& field) { return field.name == std::string_view(binding.name); });
+			if(it == layout.fields.end()) throw std::runtime_error("Field binding does not name a field of the type layout!");
+			const FieldBinding*& slot = bound[it - layout.fields.begin()];
+			if(slot != nullptr) throw std::runtime_error("Field is bound more than once!");
+			slot = &binding;
+		}
+
+		//Lay out the element image, starting a new segment after every field that can't be part of it
+		Segment segment = {0, 0, 0, 0, -1};
+		for(std::size_t f = 0; f < layout.fields.size(); ++f) {
+			const StructuredTypeLayout::Field& field = layout.fields[f];
+			const FieldBinding* binding = bound[f];
+			if(binding == nullptr) throw std::runtime_error("Field of the type layout is not bound!");
+
+			ValueHeader header = {};
+			header.type = field.type;
+			header.name = field.name;
+			if(!binding->encode && IsFixedFieldType(field.type)) {
+				Patch patch = {0, binding->offset, GetTypeSize(field.type), GetTypeSize(field.type)};
+				if(field.type == TypeTag::Vector || field.type == TypeTag::Matrix) {
+					header.elementType = field.elementType;
+					header.width = field.width;
+					header.height = field.height;
+					patch.componentSize = GetTypeSize(field.elementType);
+					patch.size = patch.componentSize * field.width * (field.type == TypeTag::Matrix ? field.height : 1);
+				}
+				if(binding->offset > elementSize || patch.size > elementSize - binding->offset) throw std::runtime_error("Field binding extends past the end of the struct!");
+
+				//Header bytes, then room for the value
+				PreparedHeader prepared(header);
+				image.insert(image.end(), prepared.GetBytes().begin(), prepared.GetBytes().end());
+				patch.imageOffset = image.size();
+				image.resize(image.size() + patch.size);
+				patches.push_back(patch);
+				continue;
+			}
+
+			VariableField variable = {field.type, *binding, std::nullopt};
+			if(!binding->encode) {
+				if((field.type != TypeTag::String && field.type != TypeTag::ByteBuffer) || !binding->bytes) throw std::runtime_error("Field binding cannot provide a value for its field!");
+				variable.header.emplace(header);
+			}
+			segment.imageEnd = image.size();
+			segment.lastPatch = patches.size();
+			segment.variableField = static_cast<int>(variableFields.size());
+			segments.push_back(segment);
+			variableFields.push_back(std::move(variable));
+			segment = {image.size(), 0, patches.size(), 0, -1};
+		}
+
+		//Every element ends with a scope boundary
+		image.push_back(static_cast<char>(TypeTag::ScopeBoundary));
+		segment.imageEnd = image.size();
+		segment.lastPatch = patches.size();
+		segments.push_back(segment);
+	}
+
+	void StructuredListEncoder::WriteList(Writer& writer, std::string_view name, const void* elements, uint32_t count) const {
+		ValueHeader header = {};
+		header.type = TypeTag::List;
+		header.name = name;
+		header.elementType = TypeTag::StructuredObj;
+		header.typeID = typeID;
+		header.size = count;
+		writer.WriteHeader(header);
+		WriteElements(writer, elements, count);
+	}
+
+	void StructuredListEncoder::WriteElements(Writer& writer, const void* elements, uint32_t count) const {
+		if(!*writer) throw std::runtime_error("Cannot perform operations without a backing stream!");
+
+		std::vector<char> block;
+		block.reserve(encodeBlockSize + image.size());
+		auto flush = [&]() {
+			if(block.empty()) return;
+			writer->write(block.data(), block.size());
+			block.clear();
+		};
+
+		const char* element = static_cast<const char*>(elements);
+		for(uint32_t i = 0; i < count; ++i, element += elementSize) {
+			for(const Segment& segment : segments) {
+				//Copy the precompiled bytes, then patch in the values
+				const std::size_t base = block.size() - segment.imageBegin;
+				block.insert(block.end(), image.begin() + segment.imageBegin, image.begin() + segment.imageEnd);
+				for(std::size_t p = segment.firstPatch; p < segment.lastPatch; ++p) {
+					const Patch& patch = patches[p];
+					char* dest = block.data() + base + patch.imageOffset;
+					std::memcpy(dest, element + patch.structOffset, patch.size);
+
+					//Values are stored little-endian, so flip each component on big-endian hosts
+					if constexpr(std::endian::native == std::endian::big) {
+						for(uint32_t c = 0; c < patch.size; c += patch.componentSize) std::reverse(dest + c, dest + c + patch.componentSize);
+					}
+				}
+				if(segment.variableField < 0) continue;
+
+				//Fields outside the image go through the general path
+				const VariableField& field = variableFields[segment.variableField];
+				if(field.binding.encode) {
+					flush();
+					field.binding.encode(writer, element);
+					continue;
+				}
+				std::string_view bytes = field.binding.bytes(element);
+				if(field.type == TypeTag::String) {
+					if(bytes.size() >= std::pow(2, 24)) throw std::runtime_error("String is longer than maximum legal size!");
+					if(!CheckUTF8(bytes)) throw std::runtime_error("String is not valid UTF-8!");
+				} else if(bytes.size() > UINT32_MAX) {
+					throw std::runtime_error("Byte buffer is larger than 4 GiB!");
+				}
+
+				//The prepared header ends in the size
+				std::span<const char> header = field.header->GetBytes();
+				block.insert(block.end(), header.begin(), header.end());
+				uint32_t size = static_cast<uint32_t>(bytes.size());
+				for(std::size_t b = block.size() - 4; b < block.size(); ++b) {
+					block[b] = static_cast<char>(size & 0xFF);
+					size >>= 8;
+				}
+
+				//Large values are written directly rather than copied
+				if(bytes.size() >= encodeBlockSize) {
+					flush();
+					writer->write(bytes.data(), bytes.size());
+				} else {
+					block.insert(block.end(), bytes.begin(), bytes.end());
+				}
+			}
+			if(block.size() >= encodeBlockSize) flush();
+		}
+		flush();
+		if(!writer->good()) throw std::runtime_error("Unexpected stream IO error!");
+	}
+}
\ No newline at end of file
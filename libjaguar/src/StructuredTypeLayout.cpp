@@ -0,0 +1,45 @@
+#include "libjaguar/StructuredTypeLayout.hpp"
+#include "Utilities.hpp"
+
+#include <unordered_set>
+
+namespace libjaguar {
+	static bool IsMathElementType(TypeTag type) {
+		return GetTypeSize(type) > 0 && type != TypeTag::Boolean;
+	}
+
+	bool ValidateTypeLayout(const StructuredTypeLayout& layout) {
+		//Check type ID and field count
+		if(layout.typeID.empty() || layout.typeID.size() > UINT8_MAX || !CheckUTF8(layout.typeID)) return false;
+		if(layout.fields.size() > UINT16_MAX) return false;
+
+		std::unordered_set<std::string_view> names;
+		for(const StructuredTypeLayout::Field& field : layout.fields) {
+			//Names must be legal and unique
+			if(field.name.empty() || field.name.size() > UINT8_MAX || !CheckUTF8(field.name)) return false;
+			if(!names.insert(field.name).second) return false;
+
+			//Type-specific checks
+			switch(field.type) {
+				case TypeTag::ScopeBoundary:
+				case TypeTag::StructuredObjTypeDecl:
+					return false;
+				case TypeTag::Vector:
+					if(!IsMathElementType(field.elementType) || field.width < 2 || field.width > 4) return false;
+					break;
+				case TypeTag::Matrix:
+					if(!IsMathElementType(field.elementType) || field.width < 2 || field.width > 4 || field.height < 2 || field.height > 4) return false;
+					break;
+				case TypeTag::List:
+					if(field.elementType == TypeTag::ScopeBoundary || field.elementType == TypeTag::StructuredObjTypeDecl) return false;
+					if(field.elementType == TypeTag::StructuredObj && (field.elementTypeID.empty() || field.elementTypeID.size() > UINT8_MAX || !CheckUTF8(field.elementTypeID))) return false;
+					break;
+				case TypeTag::StructuredObj:
+					if(field.elementTypeID.empty() || field.elementTypeID.size() > UINT8_MAX || !CheckUTF8(field.elementTypeID)) return false;
+					break;
+				default: break;
+			}
+		}
+		return true;
+	}
+}
\ No newline at end of file
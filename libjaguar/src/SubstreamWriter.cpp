@@ -0,0 +1,81 @@
+#include "libjaguar/SubstreamWriter.hpp"
+#include "libjaguar/PreparedHeader.hpp"
+#include "libjaguar/TypeTags.hpp"
+#include "libjaguar/ValueHeader.hpp"
+#include "Utilities.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace libjaguar {
+	//Writers of the bodies of unfinished substreams, which cannot contain other substreams
+	static std::mutex bodyWritersMutex;
+	static std::unordered_set<const Writer*> bodyWriters;
+
+	SubstreamWriter::SubstreamWriter(Writer& parent, std::string_view name, std::size_t memoryLimit)
+	  : parent(parent), name(name), writer(nullptr), bodyPosition(-1), finished(false) {
+		if(!*parent) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		{
+			std::lock_guard lock(bodyWritersMutex);
+			if(bodyWriters.contains(&parent)) throw std::runtime_error("Substreams may not contain other substreams!");
+		}
+
+		ValueHeader header = {};
+		header.type = TypeTag::Substream;
+		header.name = name;
+		PreparedHeader prepared(header);
+
+		//Seekable parents get the body directly, with the size filled in later
+		if(parent->tellp() != std::streampos(-1)) {
+			parent.WriteHeader(prepared);
+			bodyPosition = parent->tellp();
+			if(!parent->good() || bodyPosition == std::streampos(-1)) throw std::runtime_error("Unexpected stream IO error!");
+			writer = Writer(std::make_unique<std::ostream>(parent->rdbuf()));
+			_RegisterInternal();
+			return;
+		}
+
+		//Otherwise, collect the body until its size is known
+		spill = std::make_unique<SpillStreambuf>(memoryLimit);
+		writer = Writer(std::make_unique<std::ostream>(spill.get()));
+		_RegisterInternal();
+	}
+
+	SubstreamWriter::~SubstreamWriter() {
+		std::lock_guard lock(bodyWritersMutex);
+		bodyWriters.erase(&writer);
+	}
+
+	void SubstreamWriter::_RegisterInternal() {
+		std::lock_guard lock(bodyWritersMutex);
+		bodyWriters.insert(&writer);
+	}
+
+	void SubstreamWriter::Finish() {
+		if(finished) throw std::runtime_error("Substream was already finished!");
+		if(!writer->good()) throw std::runtime_error("Unexpected stream IO error!");
+
+		if(!spill) {
+			//Measure the body and backpatch the size (the last 4 bytes of the header)
+			const std::streampos end = parent->tellp();
+			if(end == std::streampos(-1)) throw std::runtime_error("Unexpected stream IO error!");
+			const std::streamoff size = end - bodyPosition;
+			if(size > std::streamoff(UINT32_MAX)) throw std::runtime_error("Substream is larger than 4 GiB!");
+			parent->seekp(bodyPosition - std::streamoff(4));
+			parent.WriteInteger(static_cast<uint32_t>(size));
+			parent->seekp(end);
+		} else {
+			//Now that the size is known, write the header and copy the body over
+			if(spill->GetSize() > UINT32_MAX) throw std::runtime_error("Substream is larger than 4 GiB!");
+			ValueHeader header = {};
+			header.type = TypeTag::Substream;
+			header.name = name;
+			header.size = static_cast<uint32_t>(spill->GetSize());
+			parent.WriteHeader(header);
+			spill->CopyTo(**parent);
+		}
+		if(!parent->good()) throw std::runtime_error("Unexpected stream IO error!");
+		finished = true;
+	}
+}
\ No newline at end of file
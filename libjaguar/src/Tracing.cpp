@@ -0,0 +1,158 @@
+#include "libjaguar/Tracing.hpp"
+#include "Utilities.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace libjaguar {
+#ifdef LJTRACING
+	std::atomic<bool> traceActive(false);
+
+	//Destination and settings, guarded by the mutex (the sample interval is read without it)
+	static std::mutex traceMutex;
+	static TraceCallback traceCallback;
+	static std::unique_ptr<std::ofstream> traceFile;
+	static bool traceFileEmpty = true;
+	static uint64_t traceOrigin = 0;
+	static std::atomic<uint32_t> traceSampleInterval(1);
+	static std::atomic<uint32_t> traceThreadCount(0);
+
+	bool TraceSample() {
+		thread_local uint32_t skipped = 0;
+		if(++skipped < traceSampleInterval.load(std::memory_order_relaxed)) return false;
+		skipped = 0;
+		return true;
+	}
+
+	uint64_t TraceNow() {
+		//Never 0, which marks spans that are not recorded
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) | 1;
+	}
+
+	//Chrome's trace format counts in microseconds, so nanoseconds are written as fractions
+	static void WriteMicroseconds(std::ostream& out, uint64_t nanoseconds) {
+		char digits[32];
+		std::snprintf(digits, sizeof(digits), "%llu.%03u", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned int>(nanoseconds % 1000));
+		out << digits;
+	}
+
+	static void WriteJsonString(std::ostream& out, std::string_view string) {
+		out << '"';
+		for(char character : string) {
+			const uint8_t byte = static_cast<uint8_t>(character);
+			if(character == '"' || character == '\\') {
+				out << '\\' << character;
+			} else if(byte < 0x20) {
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(byte));
+				out << escaped;
+			} else {
+				out << character;
+			}
+		}
+		out << '"';
+	}
+
+	static void WriteTraceEvent(std::ostream& out, const TraceEvent& event) {
+		out << (traceFileEmpty ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(out, event.name);
+		out << ",\"cat\":";
+		WriteJsonString(out, event.category);
+		out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadID << ",\"ts\":";
+		WriteMicroseconds(out, event.timestamp);
+		out << ",\"dur\":";
+		WriteMicroseconds(out, event.duration);
+		if(!event.detail.empty()) {
+			out << ",\"args\":{\"name\":";
+			WriteJsonString(out, event.detail);
+			out << '}';
+		}
+		out << '}';
+		traceFileEmpty = false;
+	}
+
+	void EmitTraceSpan(std::string_view name, std::string_view category, std::string_view detail, uint64_t start) noexcept {
+		const uint64_t end = TraceNow();
+		thread_local const uint32_t threadID = ++traceThreadCount;
+
+		std::lock_guard lock(traceMutex);
+		if(!traceActive.load(std::memory_order_relaxed)) return;
+
+		//Spans that started before tracing (re)started are cut off at its start
+		start = std::max(start, traceOrigin);
+		const TraceEvent event = {name, category, detail, start - traceOrigin, (end > start ? end - start : 0), threadID};
+		try {
+			if(traceFile) {
+				WriteTraceEvent(*traceFile, event);
+			} else {
+				traceCallback(event);
+			}
+		} catch(...) {
+			//Spans end in destructors, so there is no one to report to; a broken trace file is reported by StopTracing
+		}
+	}
+
+	//Must be called with the mutex held
+	static bool FinishTraceFile() {
+		if(!traceFile) return true;
+		*traceFile << "\n]}\n";
+		traceFile->close();
+		const bool ok = !traceFile->fail();
+		traceFile.reset();
+		return ok;
+	}
+
+	static void StartTracingInternal(TraceCallback&& callback, std::unique_ptr<std::ofstream>&& file, const TraceOptions& options) {
+		std::lock_guard lock(traceMutex);
+		FinishTraceFile();
+		traceCallback = std::move(callback);
+		traceFile = std::move(file);
+		traceFileEmpty = true;
+		traceOrigin = TraceNow();
+		traceSampleInterval = std::max<uint32_t>(options.sampleInterval, 1);
+		traceActive = true;
+	}
+
+	bool IsTracingAvailable() {
+		return true;
+	}
+
+	void StartTracing(TraceCallback callback, const TraceOptions& options) {
+		if(!callback) throw std::runtime_error("Trace callback must not be empty!");
+		StartTracingInternal(std::move(callback), nullptr, options);
+	}
+
+	void StartTracing(const std::string& path, const TraceOptions& options) {
+		auto file = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+		if(!file->good()) throw std::runtime_error("Cannot open the trace file!");
+		*file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		StartTracingInternal(nullptr, std::move(file), options);
+	}
+
+	void StopTracing() {
+		std::lock_guard lock(traceMutex);
+		traceActive = false;
+		traceCallback = nullptr;
+		if(!FinishTraceFile()) throw std::runtime_error("Cannot write the trace file!");
+	}
+#else
+	bool IsTracingAvailable() {
+		return false;
+	}
+
+	void StartTracing(TraceCallback, const TraceOptions&) {
+		throw std::runtime_error("libjaguar was built without tracing support!");
+	}
+
+	void StartTracing(const std::string&, const TraceOptions&) {
+		throw std::runtime_error("libjaguar was built without tracing support!");
+	}
+
+	void StopTracing() {}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "libjaguar/TypeRegistry.hpp"
+#include "libjaguar/Index.hpp"
+#include "libjaguar/IndexID.hpp"
+#include "libjaguar/Writer.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace libjaguar {
+	uint64_t HashTypeLayout(const StructuredTypeLayout& layout) {
+		//Strings are hashed with their lengths (like index IDs), so that neighboring strings cannot run into each other
+		uint64_t hash = ExtendIndexID(indexIDSeed, layout.typeID);
+		for(const StructuredTypeLayout::Field& field : layout.fields) {
+			const char shape[4] = {static_cast<char>(field.type), static_cast<char>(field.elementType), static_cast<char>(field.width), static_cast<char>(field.height)};
+			hash = ExtendIndexID(hash, std::string_view(shape, sizeof(shape)));
+			hash = ExtendIndexID(hash, field.name);
+			hash = ExtendIndexID(hash, field.elementTypeID);
+		}
+		return hash;
+	}
+
+	static bool IsSameLayout(const StructuredTypeLayout& a, const StructuredTypeLayout& b) {
+		if(a.typeID != b.typeID || a.fields.size() != b.fields.size()) return false;
+		for(std::size_t i = 0; i < a.fields.size(); ++i) {
+			const StructuredTypeLayout::Field& x = a.fields[i];
+			const StructuredTypeLayout::Field& y = b.fields[i];
+			if(x.type != y.type || x.name != y.name || x.elementType != y.elementType || x.elementTypeID != y.elementTypeID || x.width != y.width || x.height != y.height)
+				return false;
+		}
+		return true;
+	}
+
+	TypeRegistry::TypeRegistry(std::vector<StructuredTypeLayout>&& layouts) : layouts(std::move(layouts)) {
+		//Writing the declarations validates the layouts as well
+		auto encoded = std::make_unique<std::ostringstream>();
+		std::ostringstream* encodedStream = encoded.get();
+		Writer writer(std::move(encoded));
+
+		hashes.reserve(this->layouts.size());
+		byTypeID.reserve(this->layouts.size());
+		for(std::size_t i = 0; i < this->layouts.size(); ++i) {
+			const StructuredTypeLayout& layout = this->layouts[i];
+			writer.WriteTypeDeclaration(layout);
+			if(!byTypeID.try_emplace(layout.typeID, i).second) throw std::runtime_error("Duplicate type ID in type registry!");
+			hashes.push_back(HashTypeLayout(layout));
+		}
+
+		const std::string bytes = encodedStream->str();
+		encodedDeclarations.assign(bytes.begin(), bytes.end());
+	}
+
+	std::shared_ptr<const TypeRegistry> TypeRegistry::Create(std::span<const StructuredTypeLayout> layouts) {
+		//Layouts are copied into the default resource, since the registry may outlive whatever the originals were allocated from
+		std::vector<StructuredTypeLayout> copies(layouts.begin(), layouts.end());
+		return std::shared_ptr<const TypeRegistry>(new TypeRegistry(std::move(copies)));
+	}
+
+	std::shared_ptr<const TypeRegistry> TypeRegistry::FromIndex(const Index& index) {
+		std::vector<StructuredTypeLayout> copies;
+		copies.reserve(index.types.size() + index.sharedTypes.size());
+		for(const auto& [typeID, layout] : index.types) copies.emplace_back(layout);
+		for(const StructuredTypeLayout* layout : index.sharedTypes) copies.emplace_back(*layout);
+		std::sort(copies.begin(), copies.end(), [](const StructuredTypeLayout& a, const StructuredTypeLayout& b) { return a.typeID < b.typeID; });
+		return std::shared_ptr<const TypeRegistry>(new TypeRegistry(std::move(copies)));
+	}
+
+	const StructuredTypeLayout* TypeRegistry::Find(std::string_view typeID) const {
+		auto it = byTypeID.find(typeID);
+		return (it != byTypeID.end() ? &layouts[it->second] : nullptr);
+	}
+
+	const StructuredTypeLayout* TypeRegistry::FindMatching(const StructuredTypeLayout& layout) const {
+		auto it = byTypeID.find(layout.typeID);
+		if(it == byTypeID.end() || hashes[it->second] != HashTypeLayout(layout)) return nullptr;
+		return (IsSameLayout(layouts[it->second], layout) ? &layouts[it->second] : nullptr);
+	}
+}
\ No newline at end of file
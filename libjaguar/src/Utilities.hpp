@@ -4,14 +4,67 @@
 #include "libjaguar/ScopedView.hpp"
 
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
 #include <stdexcept>
+#include <streambuf>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 constexpr inline uint32_t scopedViewChunkSize = 64 * 1024;//64 KiB (one KiB is 1024 bytes)
+constexpr inline uint8_t maxScopeDepth = 64;				//Maximum object nesting depth allowed by the spec
+constexpr inline uint32_t minSeekDiscardSize = 16 * 1024;	//16 KiB; smaller ranges are read through, since they are likely buffered already
+
+#ifdef LJTRACING
+#define TRACE_SPAN(name, category) libjaguar::TraceSpan traceSpan(name, category, false)
+#define TRACE_SAMPLED_SPAN(name, category) libjaguar::TraceSpan traceSpan(name, category, true)
+#else
+#define TRACE_SPAN(name, category)
+#define TRACE_SAMPLED_SPAN(name, category)
+#endif
 
 namespace libjaguar {
-	uint32_t GetTypeSize(TypeTag type);
+#ifdef LJTRACING
+	//Tracing internals (see Tracing.cpp); all uses are compiled out without LJTRACING
+	extern std::atomic<bool> traceActive;
+	bool TraceSample();
+	uint64_t TraceNow();
+	void EmitTraceSpan(std::string_view name, std::string_view category, std::string_view detail, uint64_t start) noexcept;
+
+	//Start a span if tracing is active (and the span is picked, if it is sampled), returning its start time or 0
+	inline uint64_t BeginTraceSpan(bool sampled) {
+		if(!traceActive.load(std::memory_order_relaxed)) return 0;
+		return (!sampled || TraceSample() ? TraceNow() : 0);
+	}
+
+	//Records the span from its construction to its destruction
+	class TraceSpan {
+	  public:
+		TraceSpan(std::string_view name, std::string_view category, bool sampled) : name(name), category(category), start(BeginTraceSpan(sampled)) {}
+
+		~TraceSpan() {
+			if(start != 0) EmitTraceSpan(name, category, {}, start);
+		}
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	  private:
+		std::string_view name;
+		std::string_view category;
+		uint64_t start;
+	};
+#endif
 
 	class SVstreambuf : public std::streambuf {
 	  public:
@@ -70,7 +123,712 @@ namespace libjaguar {
 		}
 	};
 
-	inline bool CheckUTF8(const std::string& string) {
+	class MemoryStreambuf : public std::streambuf {
+	  public:
+		MemoryStreambuf(const char* data, std::size_t size) {
+			char* base = const_cast<char*>(data);
+			setg(base, base, base + size);
+		}
+
+	  protected:
+		std::streamsize showmanyc() override {
+			return egptr() - gptr();
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::in)) return pos_type(off_type(-1));
+
+			//Resolve the target relative to the requested anchor
+			off_type target = off;
+			if(dir == std::ios_base::cur)
+				target += gptr() - eback();
+			else if(dir == std::ios_base::end)
+				target += egptr() - eback();
+			if(target < 0 || target > egptr() - eback()) return pos_type(off_type(-1));
+
+			setg(eback(), eback() + target, egptr());
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+	};
+
+	class MemoryIstream : public std::istream {
+	  public:
+		MemoryIstream(const char* data, std::size_t size)
+		  : std::istream(nullptr), buf(data, size) {
+			init(&buf);
+		}
+
+	  private:
+		MemoryStreambuf buf;
+	};
+
+	//Read-only streambuf that keeps what it reads from another streambuf in memory until released, so that a run of values can be walked and then decoded in place
+	//Positions count from where the source was when reading started; seeking is possible anywhere within the kept data and forwards
+	class WindowStreambuf : public std::streambuf {
+	  public:
+		explicit WindowStreambuf(std::streambuf* source) : source(source), windowBegin(0) {}
+
+		//The kept data, which starts at the position of the last release
+		const char* GetData() const {
+			return window.data();
+		}
+
+		//Drop the kept data before a position, which must lie within it
+		void Release(uint64_t position) {
+			const std::size_t drop = static_cast<std::size_t>(position - windowBegin);
+			const std::size_t read = static_cast<std::size_t>(gptr() - eback());
+			window.erase(window.begin(), window.begin() + drop);
+			windowBegin = position;
+			setg(window.data(), window.data() + (read - drop), window.data() + window.size());
+		}
+
+	  protected:
+		int_type underflow() override {
+			if(gptr() == egptr() && !_FillInternal()) return traits_type::eof();
+			return traits_type::to_int_type(*gptr());
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::in) || dir == std::ios_base::end) return pos_type(off_type(-1));
+
+			//Resolve the target, reading on until it is kept
+			off_type target = off;
+			if(dir == std::ios_base::cur) target += windowBegin + (gptr() - eback());
+			if(target < off_type(windowBegin)) return pos_type(off_type(-1));
+			while(uint64_t(target) > windowBegin + window.size()) {
+				if(!_FillInternal()) return pos_type(off_type(-1));
+			}
+			setg(window.data(), window.data() + (target - windowBegin), window.data() + window.size());
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+
+	  private:
+		std::streambuf* source;
+		uint64_t windowBegin;//Position of the first kept byte
+		std::vector<char> window;
+
+		bool _FillInternal() {
+			constexpr std::size_t fillSize = 64 * 1024;
+			const std::size_t read = (eback() ? static_cast<std::size_t>(gptr() - eback()) : 0);
+			const std::size_t kept = window.size();
+			window.resize(kept + fillSize);
+			const std::streamsize got = source->sgetn(window.data() + kept, fillSize);
+			window.resize(kept + static_cast<std::size_t>(std::max<std::streamsize>(got, 0)));
+			setg(window.data(), window.data() + read, window.data() + window.size());
+			return got > 0;
+		}
+	};
+
+	class WindowIstream : public std::istream {
+	  public:
+		explicit WindowIstream(std::streambuf* source) : std::istream(nullptr), buf(source) {
+			init(&buf);
+		}
+
+		WindowStreambuf& GetBuffer() {
+			return buf;
+		}
+
+	  private:
+		WindowStreambuf buf;
+	};
+
+	//Read-only streambuf over a byte range, either of memory (read in place, without copying) or of another streambuf
+	//Reads from another streambuf are positional: the source position is restored afterwards, so the source can be read from in between
+	class RegionStreambuf : public std::streambuf {
+	  public:
+		RegionStreambuf() : source(nullptr), memory(nullptr), regionBegin(0), regionSize(0), position(0) {}
+
+		void SetMemory(const char* data, uint64_t size) {
+			source = nullptr;
+			memory = data;
+			regionBegin = 0;
+			regionSize = size;
+			position = 0;
+			char* base = const_cast<char*>(data);
+			setg(base, base, base + size);
+		}
+
+		void SetSource(std::streambuf* sourceBuf, uint64_t begin, uint64_t size) {
+			source = sourceBuf;
+			memory = nullptr;
+			regionBegin = begin;
+			regionSize = size;
+			position = 0;
+			setg(nullptr, nullptr, nullptr);
+		}
+
+		//The streambuf being read from (nullptr for memory) and where the region starts in it
+		std::streambuf* GetSource() const {
+			return source;
+		}
+
+		const char* GetMemory() const {
+			return memory;
+		}
+
+		uint64_t GetRegionBegin() const {
+			return regionBegin;
+		}
+
+		uint64_t GetRegionSize() const {
+			return regionSize;
+		}
+
+	  protected:
+		std::streamsize showmanyc() override {
+			return static_cast<std::streamsize>(regionSize - _TellInternal());
+		}
+
+		int_type underflow() override {
+			if(memory || position >= regionSize) return traits_type::eof();
+
+			//Refill the small buffer used for headers and other short reads
+			const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(buffer.size(), regionSize - position));
+			if(!_ReadSourceInternal(buffer.data(), count)) return traits_type::eof();
+			setg(buffer.data(), buffer.data(), buffer.data() + count);
+			return traits_type::to_int_type(buffer[0]);
+		}
+
+		std::streamsize xsgetn(char* out, std::streamsize count) override {
+			if(memory) return std::streambuf::xsgetn(out, count);
+
+			//Take what is buffered, then read large remainders straight into the destination
+			std::streamsize done = std::min<std::streamsize>(count, egptr() - gptr());
+			if(done > 0) {
+				std::memcpy(out, gptr(), done);
+				gbump(static_cast<int>(done));
+			}
+			if(count - done >= std::streamsize(buffer.size())) {
+				const std::size_t direct = static_cast<std::size_t>(std::min<uint64_t>(count - done, regionSize - position));
+				if(!_ReadSourceInternal(out + done, direct)) return done;
+				setg(nullptr, nullptr, nullptr);
+				return done + direct;
+			}
+			return done + std::streambuf::xsgetn(out + done, count - done);
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::in)) return pos_type(off_type(-1));
+
+			//Resolve the target relative to the requested anchor
+			off_type target = off;
+			if(dir == std::ios_base::cur)
+				target += _TellInternal();
+			else if(dir == std::ios_base::end)
+				target += regionSize;
+			if(target < 0 || uint64_t(target) > regionSize) return pos_type(off_type(-1));
+
+			if(memory) {
+				setg(eback(), eback() + target, egptr());
+			} else {
+				position = target;
+				setg(nullptr, nullptr, nullptr);
+			}
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+
+	  private:
+		std::streambuf* source;
+		const char* memory;
+		uint64_t regionBegin;
+		uint64_t regionSize;
+		uint64_t position;//Region offset of the end of the buffered data (source only)
+		std::array<char, 4096> buffer;
+
+		uint64_t _TellInternal() const {
+			return memory ? uint64_t(gptr() - eback()) : position - (egptr() - gptr());
+		}
+
+		bool _ReadSourceInternal(char* out, std::size_t count) {
+			const pos_type saved = source->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+			if(source->pubseekpos(pos_type(off_type(regionBegin + position)), std::ios_base::in) == pos_type(off_type(-1))) return false;
+			const std::streamsize got = source->sgetn(out, static_cast<std::streamsize>(count));
+			if(saved != pos_type(off_type(-1))) source->pubseekpos(saved, std::ios_base::in);
+			if(got > 0) position += got;
+			return got == std::streamsize(count);
+		}
+	};
+
+	class RegionIstream : public std::istream {
+	  public:
+		RegionIstream() : std::istream(nullptr) {
+			init(&buf);
+		}
+
+		RegionStreambuf& GetBuffer() {
+			return buf;
+		}
+
+	  private:
+		RegionStreambuf buf;
+	};
+
+	//Point a region stream at a byte range of a parent stream (reading memory in place if the parent is memory-backed)
+	void TargetRegion(RegionIstream& region, std::istream& parent, uint64_t begin, uint64_t size);
+
+	//Write-only streambuf that keeps data in memory up to a limit and moves all of it to a temporary file beyond that
+	//Seeking within the written data is supported (so that sizes can be backpatched)
+	class SpillStreambuf : public std::streambuf {
+	  public:
+		explicit SpillStreambuf(std::size_t memoryLimit) : memoryLimit(memoryLimit), file(nullptr), position(0), size(0) {}
+
+		~SpillStreambuf() override {
+			if(file) std::fclose(file);
+		}
+
+		SpillStreambuf(const SpillStreambuf&) = delete;
+		SpillStreambuf& operator=(const SpillStreambuf&) = delete;
+
+		uint64_t GetSize() const {
+			return size;
+		}
+
+		bool IsSpilled() const {
+			return file != nullptr;
+		}
+
+		//Copy everything written so far to another stream
+		void CopyTo(std::ostream& out) {
+			if(!file) {
+				out.write(memory.data(), size);
+				if(!out.good()) throw std::runtime_error("Unexpected stream IO error!");
+				return;
+			}
+
+			std::array<char, scopedViewChunkSize> chunk;
+			if(std::fflush(file) != 0 || !_SeekInternal(0)) throw std::runtime_error("Cannot read back the temporary spill file!");
+			for(uint64_t remaining = size; remaining > 0;) {
+				const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(chunk.size(), remaining));
+				if(std::fread(chunk.data(), 1, count, file) != count) throw std::runtime_error("Cannot read back the temporary spill file!");
+				out.write(chunk.data(), count);
+				if(!out.good()) throw std::runtime_error("Unexpected stream IO error!");
+				remaining -= count;
+			}
+			if(!_SeekInternal(position)) throw std::runtime_error("Cannot seek in the temporary spill file!");
+		}
+
+		//Read back part of what was written, without moving the write position
+		void ReadBack(uint64_t offset, char* data, std::size_t count) {
+			if(offset > size || count > size - offset) throw std::runtime_error("Cannot read past the end of the spilled data!");
+			if(!file) {
+				std::memcpy(data, memory.data() + offset, count);
+				return;
+			}
+			if(std::fflush(file) != 0 || !_SeekInternal(offset) || std::fread(data, 1, count, file) != count) throw std::runtime_error("Cannot read back the temporary spill file!");
+			if(!_SeekInternal(position)) throw std::runtime_error("Cannot seek in the temporary spill file!");
+		}
+
+	  protected:
+		std::streamsize xsputn(const char* data, std::streamsize count) override {
+			if(!file && position + count > memoryLimit) _SpillInternal();
+			if(file) {
+				if(std::fwrite(data, 1, count, file) != static_cast<std::size_t>(count)) return 0;
+			} else {
+				if(position + count > memory.size()) memory.resize(position + count);
+				std::memcpy(memory.data() + position, data, count);
+			}
+			position += count;
+			size = std::max(size, position);
+			return count;
+		}
+
+		int_type overflow(int_type ch) override {
+			if(traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+			char c = traits_type::to_char_type(ch);
+			return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::out)) return pos_type(off_type(-1));
+
+			//Resolve the target relative to the requested anchor
+			off_type target = off;
+			if(dir == std::ios_base::cur)
+				target += position;
+			else if(dir == std::ios_base::end)
+				target += size;
+			if(target < 0 || uint64_t(target) > size) return pos_type(off_type(-1));
+
+			if(file && !_SeekInternal(target)) return pos_type(off_type(-1));
+			position = target;
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+
+	  private:
+		std::size_t memoryLimit;
+		std::vector<char> memory;
+		std::FILE* file;
+		uint64_t position;
+		uint64_t size;
+
+		void _SpillInternal() {
+			file = std::tmpfile();
+			if(!file) throw std::runtime_error("Cannot create a temporary file to spill to!");
+			if(size > 0 && std::fwrite(memory.data(), 1, size, file) != size) throw std::runtime_error("Cannot write to the temporary spill file!");
+			if(!_SeekInternal(position)) throw std::runtime_error("Cannot seek in the temporary spill file!");
+			std::vector<char>().swap(memory);
+		}
+
+		bool _SeekInternal(uint64_t pos) {
+#ifdef _WIN32
+			return _fseeki64(file, static_cast<int64_t>(pos), SEEK_SET) == 0;
+#else
+			return fseeko(file, static_cast<off_t>(pos), SEEK_SET) == 0;
+#endif
+		}
+	};
+
+	//Read-only streambuf that reads ahead of its consumer on a dedicated I/O thread
+	//The thread fills a single-producer/single-consumer ring of blocks and waits while the ring is full. The consumer reads each block in place and only hands it back once
+	//it moves on to the next one. Seeks within the current block (or ahead into data the ring would read anyway) keep the pipeline running; others restart it at the target.
+	class PipelinedStreambuf : public std::streambuf {
+	  public:
+		PipelinedStreambuf(std::unique_ptr<std::istream>&& sourceStream, std::size_t blockSize, std::size_t depth)
+		  : source(std::move(sourceStream)), blockSize(std::max<std::size_t>(blockSize, 1)), blocks(std::max<std::size_t>(depth, 1)), blockStart(0), current(0),
+			holding(false), broken(false), produced(0), consumed(0), stopping(false) {
+			for(Block& block : blocks) block.data.resize(this->blockSize);
+
+			//Non-seekable sources can still be read; they just cannot be restarted elsewhere
+			const std::streampos start = source->tellg();
+			seekable = (start != std::streampos(-1));
+			if(seekable) blockStart = static_cast<uint64_t>(std::streamoff(start));
+			worker = std::thread(&PipelinedStreambuf::_ProduceInternal, this);
+		}
+
+		~PipelinedStreambuf() override {
+			_StopInternal();
+		}
+
+		PipelinedStreambuf(const PipelinedStreambuf&) = delete;
+		PipelinedStreambuf& operator=(const PipelinedStreambuf&) = delete;
+
+	  protected:
+		int_type underflow() override {
+			if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+			if(broken || !_NextBlockInternal()) return traits_type::eof();
+			return traits_type::to_int_type(*gptr());
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::in)) return pos_type(off_type(-1));
+			const uint64_t position = blockStart + (holding ? uint64_t(gptr() - eback()) : 0);
+			if(dir == std::ios_base::cur && off == 0) return pos_type(off_type(position));
+
+			//The end is only known to the source
+			if(dir == std::ios_base::end) {
+				if(!seekable) return pos_type(off_type(-1));
+				_StopInternal();
+				source->clear();
+				const pos_type end = source->rdbuf()->pubseekoff(off, std::ios_base::end, std::ios_base::in);
+				if(end == pos_type(off_type(-1))) return _BreakInternal();
+				return _RestartInternal(static_cast<uint64_t>(off_type(end)));
+			}
+			const off_type target = off + (dir == std::ios_base::cur ? off_type(position) : 0);
+			if(target < 0) return pos_type(off_type(-1));
+			return _SeekInternal(static_cast<uint64_t>(target));
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+
+	  private:
+		struct Block {
+			std::vector<char> data;
+			std::size_t size = 0;
+			bool last = false;//Whether the source ended in (or right after) this block
+		};
+
+		std::unique_ptr<std::istream> source;
+		bool seekable;
+		std::size_t blockSize;
+		std::vector<Block> blocks;
+		uint64_t blockStart;//Stream position of the first byte of the held block (or the next one, if none is held)
+		uint64_t current;	//Sequence number of the held (or next) block
+		bool holding;		//Whether the consumer holds block current
+		bool broken;		//Whether the producer was stopped for a seek that the source refused, so there is nothing to read until a seek succeeds
+
+		//Ring state: blocks [consumed, produced) are filled, and each side only ever advances its own counter
+		std::atomic<uint64_t> produced;
+		std::atomic<uint64_t> consumed;
+		std::atomic<bool> stopping;
+		std::thread worker;
+
+		void _ProduceInternal() {
+			uint64_t next = produced.load(std::memory_order_relaxed);
+			while(true) {
+				//Backpressure: wait for the consumer to hand a block back
+				uint64_t done = consumed.load(std::memory_order_acquire);
+				while(next - done >= blocks.size()) {
+					if(stopping.load(std::memory_order_acquire)) return;
+					consumed.wait(done, std::memory_order_acquire);
+					done = consumed.load(std::memory_order_acquire);
+				}
+				if(stopping.load(std::memory_order_acquire)) return;
+
+				Block& block = blocks[next % blocks.size()];
+				block.size = static_cast<std::size_t>(source->rdbuf()->sgetn(block.data.data(), static_cast<std::streamsize>(blockSize)));
+				block.last = (block.size < blockSize);
+				produced.store(++next, std::memory_order_release);
+				produced.notify_one();
+				if(block.last) return;
+			}
+		}
+
+		void _StopInternal() {
+			if(!worker.joinable()) return;
+
+			//Bumping the counter wakes the producer if it is waiting for a free block
+			stopping.store(true, std::memory_order_release);
+			consumed.fetch_add(1, std::memory_order_acq_rel);
+			consumed.notify_one();
+			worker.join();
+		}
+
+		//Without a producer, waiting for the next block would never end, so reads report EOF instead
+		pos_type _BreakInternal() {
+			broken = true;
+			holding = false;
+			setg(nullptr, nullptr, nullptr);
+			return pos_type(off_type(-1));
+		}
+
+		pos_type _RestartInternal(uint64_t target) {
+			if(source->rdbuf()->pubseekpos(pos_type(off_type(target)), std::ios_base::in) == pos_type(off_type(-1))) return _BreakInternal();
+			broken = false;
+			produced.store(0, std::memory_order_relaxed);
+			consumed.store(0, std::memory_order_relaxed);
+			stopping.store(false, std::memory_order_relaxed);
+			blockStart = target;
+			current = 0;
+			holding = false;
+			setg(nullptr, nullptr, nullptr);
+			worker = std::thread(&PipelinedStreambuf::_ProduceInternal, this);
+			return pos_type(off_type(target));
+		}
+
+		bool _NextBlockInternal() {
+			if(holding) {
+				//The end of the source is not a block boundary; stay at it
+				const Block& held = blocks[current % blocks.size()];
+				if(held.last) return false;
+
+				//Hand the block back to the producer
+				blockStart += held.size;
+				consumed.store(++current, std::memory_order_release);
+				consumed.notify_one();
+				holding = false;
+			}
+
+			//Wait for the producer to fill the next block
+			uint64_t available = produced.load(std::memory_order_acquire);
+			while(available == current) {
+				produced.wait(available, std::memory_order_acquire);
+				available = produced.load(std::memory_order_acquire);
+			}
+			Block& block = blocks[current % blocks.size()];
+			holding = true;
+			setg(block.data.data(), block.data.data(), block.data.data() + block.size);
+			return block.size > 0;
+		}
+
+		pos_type _SeekInternal(uint64_t target) {
+			//Targets in the held block, or ahead within what the ring reads anyway, are reached without restarting
+			if(!broken && target >= blockStart && target - blockStart < uint64_t(blockSize) * blocks.size()) {
+				if(!holding) _NextBlockInternal();
+				while(true) {
+					const Block& held = blocks[current % blocks.size()];
+					const uint64_t offset = target - blockStart;
+
+					//The last block is only reused if the source cannot be read again (it may have grown since)
+					if(offset < held.size && !(held.last && seekable)) {
+						char* base = const_cast<char*>(held.data.data());
+						setg(base, base + offset, base + held.size);
+						return pos_type(off_type(target));
+					}
+					if(held.last) break;
+					_NextBlockInternal();
+				}
+			}
+
+			//Anywhere else (including past the end, or after the source has ended and may have grown) needs the source to seek
+			if(!seekable) return pos_type(off_type(-1));
+			_StopInternal();
+			source->clear();
+			return _RestartInternal(target);
+		}
+	};
+
+	class PipelinedIstream : public std::istream {
+	  public:
+		PipelinedIstream(std::unique_ptr<std::istream>&& source, std::size_t blockSize, std::size_t depth) : std::istream(nullptr), buf(std::move(source), blockSize, depth) {
+			init(&buf);
+		}
+
+	  private:
+		PipelinedStreambuf buf;
+	};
+
+	//Write-only streambuf that hands filled buffers to a background thread, which writes them to the sink stream
+	//Writers only wait when every buffer is in flight. Errors from the sink are deferred: they fail the next buffer handoff and sync(), so a flush reports them.
+	//Seeking is supported for seekable sinks, by waiting for everything to be written and seeking the sink.
+	class AsyncStreambuf : public std::streambuf {
+	  public:
+		AsyncStreambuf(std::unique_ptr<std::ostream>&& sinkStream, std::size_t bufferSize, std::size_t bufferCount)
+		  : sink(std::move(sinkStream)), buffers(std::max<std::size_t>(bufferCount, 1)), sizes(buffers.size()), handed(0), written(0), handedBytes(0), failed(false),
+			stopping(false) {
+			for(std::vector<char>& buffer : buffers) buffer.resize(std::max<std::size_t>(bufferSize, 1));
+			const std::streampos start = sink->tellp();
+			base = (start == std::streampos(-1) ? -1 : std::streamoff(start));
+			setp(buffers[0].data(), buffers[0].data() + buffers[0].size());
+			worker = std::thread(&AsyncStreambuf::_FlushLoopInternal, this);
+		}
+
+		~AsyncStreambuf() override {
+			sync();
+			{
+				std::lock_guard lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			worker.join();
+		}
+
+		AsyncStreambuf(const AsyncStreambuf&) = delete;
+		AsyncStreambuf& operator=(const AsyncStreambuf&) = delete;
+
+	  protected:
+		int_type overflow(int_type ch) override {
+			if(!_HandOffInternal()) return traits_type::eof();
+			if(traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+			return ch;
+		}
+
+		int sync() override {
+			if(!_HandOffInternal() || !_DrainInternal()) return -1;
+			sink->flush();
+			return sink->good() ? 0 : -1;
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			if(!(which & std::ios_base::out) || base < 0) return pos_type(off_type(-1));
+			const off_type position = base + off_type(handedBytes) + (pptr() - pbase());
+			if(dir == std::ios_base::cur && off == 0) return pos_type(position);
+
+			//Everything before the target has to be written before the sink can move
+			if(!_HandOffInternal() || !_DrainInternal()) return pos_type(off_type(-1));
+			if(dir == std::ios_base::end) {
+				sink->seekp(off, std::ios_base::end);
+			} else {
+				sink->seekp(dir == std::ios_base::cur ? position + off : off);
+			}
+			const std::streampos target = sink->tellp();
+			if(!sink->good() || target == std::streampos(-1)) return pos_type(off_type(-1));
+			base = std::streamoff(target);
+			handedBytes = 0;
+			return pos_type(target);
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+
+	  private:
+		std::unique_ptr<std::ostream> sink;
+		std::streamoff base;//Sink position at the start of the data handed off since the last seek, or -1 if the sink cannot seek
+		std::vector<std::vector<char>> buffers;
+		std::vector<std::size_t> sizes;//Size of each handed-off buffer
+
+		//Buffers [written, handed) are waiting for or being written by the background thread; buffer handed is being filled
+		std::mutex mutex;
+		std::condition_variable wake;
+		uint64_t handed;
+		uint64_t written;
+		uint64_t handedBytes;//Only touched by the writing side
+		bool failed;
+		bool stopping;
+		std::thread worker;
+
+		bool _HandOffInternal() {
+			const std::size_t size = pptr() - pbase();
+			std::unique_lock lock(mutex);
+			if(failed) return false;
+			if(size == 0) return true;
+
+			//Queue the filled buffer, then wait until the next one is no longer in flight
+			sizes[handed % buffers.size()] = size;
+			++handed;
+			handedBytes += size;
+			wake.notify_all();
+			wake.wait(lock, [&]() { return handed - written < buffers.size(); });
+			std::vector<char>& next = buffers[handed % buffers.size()];
+			setp(next.data(), next.data() + next.size());
+			return !failed;
+		}
+
+		bool _DrainInternal() {
+			std::unique_lock lock(mutex);
+			wake.wait(lock, [&]() { return written == handed; });
+			return !failed;
+		}
+
+		void _FlushLoopInternal() {
+			std::unique_lock lock(mutex);
+			while(true) {
+				wake.wait(lock, [&]() { return stopping || written < handed; });
+				if(written == handed) return;
+
+				//Write without holding the lock, so that the next buffer can be filled meanwhile
+				const std::vector<char>& buffer = buffers[written % buffers.size()];
+				const std::size_t size = sizes[written % buffers.size()];
+				const bool skip = failed;
+				lock.unlock();
+				bool ok = true;
+				if(!skip) {
+					TRACE_SPAN("Flush", "writer");
+					sink->write(buffer.data(), static_cast<std::streamsize>(size));
+					ok = sink->good();
+				}
+				lock.lock();
+
+				//After a failure, the remaining buffers are dropped so that writers never wait forever
+				if(!ok) failed = true;
+				++written;
+				wake.notify_all();
+			}
+		}
+	};
+
+	class AsyncOstream : public std::ostream {
+	  public:
+		AsyncOstream(std::unique_ptr<std::ostream>&& sink, std::size_t bufferSize, std::size_t bufferCount) : std::ostream(nullptr), buf(std::move(sink), bufferSize, bufferCount) {
+			init(&buf);
+		}
+
+	  private:
+		AsyncStreambuf buf;
+	};
+
+	inline bool CheckUTF8(std::string_view string) {
 		//Keep track of expected continuation bytes (to prevent overlong encodings)
 		uint8_t expectedContinuations = 0;
 
@@ -120,65 +878,4 @@ namespace libjaguar {
 		//All characters passed, string is valid as long as we don't have outstanding continuation bytes
 		return expectedContinuations == 0;
 	}
-
-	inline uint64_t GenIndexID(std::string path) {
-		//Initial seed
-		uint64_t hash = 0xEE674237ull;
-
-		//Split path components
-		std::vector<std::string> components;
-		components.push_back("");
-		std::size_t idx = 0;
-		for(char c : path) {
-			if(c == '.') {
-				++idx;
-				components.push_back("");
-				continue;
-			}
-			if(c == '[') {
-				++idx;
-				components.push_back("$$arr");
-				continue;
-			}
-			if(c == ']') {
-				continue;
-			}
-			components[idx] += c;
-		}
-
-		//Run hashing
-		for(const std::string& component : components) {
-			//Convert string to bytes
-			uint64_t hc = 0;
-			for(char c : component) hc = (hc * 257 + static_cast<unsigned char>(c));
-
-			//Multiply hash component by 37 because why not
-			hc *= 37;
-
-			//Fold new component into hash
-			hash *= (hc + 2);
-
-			//Swap the upper and lower nibbles of all bytes
-			{
-				uint64_t nibbleSwapped = 0;
-				for(uint8_t i = 0; i < 8; ++i) {
-					//Get the byte out
-					uint8_t byte = (hash >> (i * 8)) & 0xFF;
-
-					//Swap it
-					uint8_t swappedByte = ((byte & 0x0F) << 4) | ((byte & 0xF0) >> 4);
-
-					//Put the swapped byte back in
-					nibbleSwapped |= (static_cast<uint64_t>(swappedByte) << (i * 8));
-				}
-				hash = nibbleSwapped;
-			}
-
-			//Rotate hash left by one byte
-			hash = (hash << 8) | (hash >> 56);
-		}
-
-		//Return end product
-		return hash;
-	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "libjaguar/Writer.hpp"
+#include "libjaguar/PreparedHeader.hpp"
 #include "libjaguar/TypeTags.hpp"
 #include "libjaguar/ValueHeader.hpp"
 #include "Utilities.hpp"
@@ -8,6 +9,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace libjaguar {
 	Writer::Writer(std::unique_ptr<std::ostream>&& ostream) : stream(std::move(ostream)) {}
@@ -19,6 +21,11 @@ namespace libjaguar {
 		return *this;
 	}
 
+	Writer Writer::Async(std::unique_ptr<std::ostream>&& ostream, const AsyncWriteOptions& options) {
+		if(!ostream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		return Writer(std::make_unique<AsyncOstream>(std::move(ostream), options.bufferSize, options.bufferCount));
+	}
+
 	std::ostream* Writer::operator->() {
 		return (stream ? stream.get() : nullptr);
 	}
@@ -30,20 +37,21 @@ namespace libjaguar {
 	void Writer::_WriteIntegerInternal(uint64_t value, uint8_t bits) {
 		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
 
-		//Write out integer in little endian
+		//Assemble the integer in little endian, then write it all at once
 		const uint8_t bytes = bits / 8;
+		std::array<char, 8> encoded;
 		uint64_t work = value;
 		for(uint8_t i = 0; i < bytes; ++i) {
-			//Get the lowest 8 bits of the work value and write it
-			const uint8_t byte = (work & 0xFF);
-			stream->put(byte);
+			//Get the lowest 8 bits of the work value
+			encoded[i] = static_cast<char>(work & 0xFF);
 
-			//Discard just-written bits and move everything else 8 bits right
+			//Discard just-taken bits and move everything else 8 bits right
 			work >>= 8;
 		}
+		stream->write(encoded.data(), bytes);
 	}
 
-	void Writer::_WriteBufferInternal(std::span<unsigned char>& value) {
+	void Writer::_WriteBufferInternal(std::span<const unsigned char>& value) {
 		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
 
 		stream->write(reinterpret_cast<const char*>(value.data()), value.size());
@@ -56,7 +64,7 @@ namespace libjaguar {
 		stream->put(val);
 	}
 
-	void Writer::WriteString(const std::string& value) {
+	void Writer::WriteString(std::string_view value) {
 		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
 		if(!CheckUTF8(value)) throw std::runtime_error("String is not valid UTF-8!");
 		if(value.size() >= std::pow(2, 24)) throw std::runtime_error("String is longer than maximum legal size!");
@@ -91,64 +99,99 @@ namespace libjaguar {
 	void Writer::WriteHeader(const ValueHeader& header, bool noIdentifier) {
 		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
 
-		//Scope boundary edge-case
-		if(header.type == TypeTag::ScopeBoundary) {
-			stream->put(static_cast<uint8_t>(TypeTag::ScopeBoundary));
-			return;
-		}
+		//Encode into a local buffer so the whole header goes out in one write
+		WriteHeader(PreparedHeader(header, noIdentifier));
+	}
 
-		//Basic checks for other types
-		if(header.name.size() < 1 || header.name.size() > UINT8_MAX) throw std::runtime_error("Header name string is invalid length!");
-		if(!CheckUTF8(header.name)) throw std::runtime_error("Header name string is not valid UTF-8!");
-		if(header.type == TypeTag::StructuredObj || header.type == TypeTag::StructuredObjTypeDecl) {
-			if(header.typeID.size() < 1 || header.typeID.size() > UINT8_MAX) throw std::runtime_error("Header type ID string is invalid length!");
-			if(!CheckUTF8(header.typeID)) throw std::runtime_error("Header type ID string is not valid UTF-8!");
-		}
+	void Writer::WriteHeader(const PreparedHeader& header) {
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
 
-		//Write identifier
-		if(!noIdentifier) {
-			//Write type tag
-			stream->put(static_cast<uint8_t>(header.type));
+		std::span<const char> bytes = header.GetBytes();
+		stream->write(bytes.data(), bytes.size());
+	}
 
-			//Write name string
-			_WriteIntegerInternal(header.name.size(), 8);
-			WriteString(header.name);
+	void Writer::WriteHeader(const PreparedHeader& header, uint32_t size) {
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		if(!header.HasSize()) throw std::runtime_error("Prepared header has no size to substitute!");
+
+		//The size is always the last 4 bytes
+		std::span<const char> bytes = header.GetBytes();
+		std::array<char, PreparedHeader::maxEncodedSize> patched;
+		std::memcpy(patched.data(), bytes.data(), bytes.size() - 4);
+		for(std::size_t i = bytes.size() - 4; i < bytes.size(); ++i) {
+			patched[i] = static_cast<char>(size & 0xFF);
+			size >>= 8;
 		}
+		stream->write(patched.data(), bytes.size());
+	}
 
-		//Write type-specific data
-		switch(header.type) {
-			case TypeTag::List:
-				stream->put(static_cast<uint8_t>(header.elementType));
-				if(header.elementType == TypeTag::StructuredObj) {
-					_WriteIntegerInternal(header.typeID.size(), 8);
-					WriteString(header.typeID);
-				}
-				_WriteIntegerInternal(header.size, bits_v<decltype(header.size)>);
-				break;
-			case TypeTag::Vector:
-				stream->put(static_cast<uint8_t>(header.elementType));
-				_WriteIntegerInternal(header.width, bits_v<decltype(header.width)>);
-				break;
-			case TypeTag::Matrix:
-				stream->put(static_cast<uint8_t>(header.elementType));
-				_WriteIntegerInternal(header.width, bits_v<decltype(header.width)>);
-				_WriteIntegerInternal(header.height, bits_v<decltype(header.height)>);
-				break;
-			case TypeTag::StructuredObj:
-			case TypeTag::StructuredObjTypeDecl:
-				_WriteIntegerInternal(header.typeID.size(), 8);
-				WriteString(header.typeID);
-				//Intentional fall-through since the below part is common to StructruedObjTypeDecl and UnstructuredObj, but not StructuredObj
-				if(header.type != TypeTag::StructuredObjTypeDecl) break;
-			case TypeTag::UnstructuredObj:
-				_WriteIntegerInternal(header.fieldCount, bits_v<decltype(header.fieldCount)>);
-				break;
-			case TypeTag::String:
-			case TypeTag::ByteBuffer:
-			case TypeTag::Substream:
-				_WriteIntegerInternal(header.size, bits_v<decltype(header.size)>);
-				break;
-			default: break;
+	void Writer::WriteTypeDeclaration(const StructuredTypeLayout& layout) {
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		if(!ValidateTypeLayout(layout)) throw std::runtime_error("Cannot write an invalid type layout!");
+
+		//Declaration header (the type ID doubles as the value name)
+		ValueHeader header = {};
+		header.type = TypeTag::StructuredObjTypeDecl;
+		header.name = layout.typeID;
+		header.typeID = layout.typeID;
+		header.fieldCount = static_cast<uint16_t>(layout.fields.size());
+		WriteHeader(header);
+
+		//Fields keep only their identifier, plus the header data of generic types (lists have no size here)
+		for(const StructuredTypeLayout::Field& field : layout.fields) {
+			stream->put(static_cast<uint8_t>(field.type));
+			_WriteIntegerInternal(field.name.size(), 8);
+			stream->write(field.name.data(), field.name.size());
+			switch(field.type) {
+				case TypeTag::List:
+					stream->put(static_cast<uint8_t>(field.elementType));
+					if(field.elementType == TypeTag::StructuredObj) {
+						_WriteIntegerInternal(field.elementTypeID.size(), 8);
+						stream->write(field.elementTypeID.data(), field.elementTypeID.size());
+					}
+					break;
+				case TypeTag::Vector:
+					stream->put(static_cast<uint8_t>(field.elementType));
+					_WriteIntegerInternal(field.width, 8);
+					break;
+				case TypeTag::Matrix:
+					stream->put(static_cast<uint8_t>(field.elementType));
+					_WriteIntegerInternal(field.width, 8);
+					_WriteIntegerInternal(field.height, 8);
+					break;
+				case TypeTag::StructuredObj:
+					_WriteIntegerInternal(field.elementTypeID.size(), 8);
+					stream->write(field.elementTypeID.data(), field.elementTypeID.size());
+					break;
+				default: break;
+			}
 		}
+
+		//Close the declaration scope
+		stream->put(static_cast<uint8_t>(TypeTag::ScopeBoundary));
+	}
+
+	void Writer::Flush() {
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+		TRACE_SPAN("Flush", "writer");
+		stream->flush();
+		if(!stream->good()) throw std::runtime_error("Unexpected stream IO error!");
+	}
+
+	void Writer::Close() {
+		if(!stream) throw std::runtime_error("Cannot perform operations without a backing stream!");
+
+		//Take the stream first, so it is released even if flushing throws
+		std::unique_ptr<std::ostream> closing = std::move(stream);
+		closing->flush();
+		const bool ok = closing->good();
+		closing.reset();
+		if(!ok) throw std::runtime_error("Unexpected stream IO error!");
+	}
+
+	std::unique_ptr<std::ostream> Writer::Reset(std::unique_ptr<std::ostream>&& ostream) {
+		std::unique_ptr<std::ostream> previous = std::move(stream);
+		stream = std::move(ostream);
+		return previous;
 	}
 }
\ No newline at end of file
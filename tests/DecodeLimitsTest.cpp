@@ -0,0 +1,226 @@
+#include "Testing.hpp"
+#include <libjaguar/Decoder.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace libjaguar;
+
+//A stream of alternating numbers and strings at the root, with a list and an object in between
+static std::string WriteMixedStream(uint32_t count) {
+	return test::WriteStream([count](Writer& writer) {
+		for(uint32_t i = 0; i < count; ++i) {
+			test::WriteUInt32(writer, "n" + std::to_string(i), i);
+			test::WriteString(writer, "s" + std::to_string(i), "value" + std::to_string(i));
+			if(i == count / 2) {
+				ValueHeader list;
+				list.type = TypeTag::List;
+				list.name = "list";
+				list.elementType = TypeTag::UInt16;
+				list.size = 3;
+				writer.WriteHeader(list);
+				for(uint16_t element = 0; element < 3; ++element) writer.WriteInteger<uint16_t>(element);
+
+				ValueHeader object;
+				object.type = TypeTag::UnstructuredObj;
+				object.name = "object";
+				object.fieldCount = 2;
+				writer.WriteHeader(object);
+				test::WriteUInt32(writer, "a", 1);
+				test::WriteString(writer, "b", "two");
+				ValueHeader boundary;
+				boundary.type = TypeTag::ScopeBoundary;
+				writer.WriteHeader(boundary);
+			}
+		}
+	});
+}
+
+static void Parse(const std::string& data, const DecodeOptions& options) {
+	Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), options);
+	decoder.Parse();
+}
+
+//Describe the root-level entries of an index, including materialized bodies, for comparing indexes
+static std::string DescribeValue(const Index& index, const ValueEntry& value) {
+	std::string description = std::string(value.name) + "#" + std::to_string(value.id) + "@" + std::to_string(std::streamoff(value.streamBeginPosition)) + ":" +
+							  std::to_string(int(value.type)) + "/" + std::to_string(value.size);
+	if(value.IsMaterialized()) {
+		std::span<const unsigned char> bytes = index.GetBytes(value);
+		description += "=" + std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+	return description;
+}
+
+static std::string DescribeScope(const Index& index, const ScopeEntry& scope) {
+	std::string description = std::string(scope.name) + "#" + std::to_string(scope.id) + "@" + std::to_string(std::streamoff(scope.streamBeginPosition)) + "(";
+	for(const ValueEntry& value : scope.subvalues) description += DescribeValue(index, value) + ",";
+	for(const ScopeEntry& subscope : scope.subscopes) description += DescribeScope(index, subscope) + ",";
+	return description + ")";
+}
+
+static void DescribeRoot(const Index& index, std::vector<std::string>& descriptions) {
+	for(const ValueEntry& value : index.root.subvalues) descriptions.push_back(DescribeValue(index, value));
+	for(const ScopeEntry& scope : index.root.subscopes) descriptions.push_back(DescribeScope(index, scope));
+}
+
+TEST_CASE(NoLimitsByDefault) {
+	const std::string data = WriteMixedStream(100);
+	Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = true, .limits = {.checkRemainingInput = true}});
+	decoder.Parse();
+	CHECK(decoder.GetIndex().root.subvalues.size() == 201);
+	CHECK(decoder.GetIndex().root.subscopes.size() == 1);
+	CHECK(decoder.GetSpilledChunkCount() == 0);
+}
+
+TEST_CASE(EntryLimit) {
+	const std::string data = WriteMixedStream(10);
+	CHECK_THROWS(Parse(data, {.limits = {.maxEntries = 5}}), "Index entry limit exceeded!");
+
+	//The fields of an object count as entries too
+	Parse(data, {.limits = {.maxEntries = 24}});
+	CHECK_THROWS(Parse(data, {.limits = {.maxEntries = 23}}), "Index entry limit exceeded!");
+}
+
+TEST_CASE(MaterializedByteLimit) {
+	const std::string data = WriteMixedStream(10);
+	CHECK_THROWS(Parse(data, {.materialize = true, .limits = {.maxMaterializedBytes = 16}}), "Materialized value limit exceeded!");
+
+	//Nothing is materialized without materialization
+	Parse(data, {.limits = {.maxMaterializedBytes = 16}});
+}
+
+TEST_CASE(LargeBodiesAreSkippedWhenMaterializing) {
+	const std::string large(300, 'x');
+	const std::string data = test::WriteStream([&](Writer& writer) {
+		test::WriteString(writer, "large", large);
+		ValueHeader buffer;
+		buffer.type = TypeTag::ByteBuffer;
+		buffer.name = "buffer";
+		buffer.size = uint32_t(large.size());
+		writer.WriteHeader(buffer);
+		writer.WriteBuffer(std::span(reinterpret_cast<const unsigned char*>(large.data()), large.size()));
+		test::WriteString(writer, "empty", "");
+		test::WriteUInt32(writer, "after", 7);
+	});
+	Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = true, .maxMaterializedSize = 256, .limits = {.maxMaterializedBytes = 8}});
+	decoder.Parse();
+	const Index& index = decoder.GetIndex();
+	CHECK(index.root.subvalues.size() == 4);
+	CHECK(!index.root.subvalues[0].IsMaterialized() && index.root.subvalues[0].size == large.size());
+	CHECK(!index.root.subvalues[1].IsMaterialized());
+	CHECK(index.root.subvalues[2].IsMaterialized() && index.GetString(index.root.subvalues[2]).empty());
+	CHECK(index.root.subvalues[3].IsMaterialized() && index.Get<uint32_t>(index.root.subvalues[3]) == 7);
+}
+
+TEST_CASE(StringSizeLimit) {
+	const std::string data = test::WriteStream([](Writer& writer) {
+		test::WriteString(writer, "short", "abc");
+		test::WriteString(writer, "long", "abcdefgh");
+	});
+	Parse(data, {.limits = {.maxStringSize = 8}});
+	CHECK_THROWS(Parse(data, {.limits = {.maxStringSize = 7}}), "String size limit exceeded!");
+}
+
+TEST_CASE(RemainingInputCheck) {
+	const std::string data = test::WriteStream([](Writer& writer) {
+		test::WriteUInt32(writer, "first", 1);
+		ValueHeader list;
+		list.type = TypeTag::List;
+		list.name = "list";
+		list.elementType = TypeTag::UInt64;
+		list.size = 1000;
+		writer.WriteHeader(list);
+		for(uint64_t element = 0; element < 1000; ++element) writer.WriteInteger<uint64_t>(element);
+	});
+	Parse(data, {.limits = {.checkRemainingInput = true}});
+
+	//A truncated list is rejected by its header, before any of it is skipped
+	const std::string truncated = data.substr(0, data.size() - 100);
+	CHECK_THROWS(Parse(truncated, {.limits = {.checkRemainingInput = true}}), "Value claims more data than the rest of the stream holds!");
+}
+
+TEST_CASE(ParseTimeLimit) {
+	const std::string data = test::WriteStream([](Writer& writer) {
+		for(uint32_t i = 0; i < 500000; ++i) test::WriteUInt32(writer, "n", i);
+	});
+	CHECK_THROWS(Parse(data, {.limits = {.maxParseTime = std::chrono::milliseconds(1)}}), "Parse time limit exceeded!");
+	Parse(data, {.limits = {.maxParseTime = std::chrono::hours(1)}});
+}
+
+TEST_CASE(FailedParseInvalidatesDecoder) {
+	const std::string data = WriteMixedStream(10);
+	Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), {.limits = {.maxEntries = 5}});
+	CHECK_THROWS(decoder.Parse(), "Index entry limit exceeded!");
+	CHECK_THROWS(decoder.GetIndex(), "Cannot obtain the index; parsing errors occurred!");
+	CHECK_THROWS(decoder.Parse(), "Cannot continue parsing; parsing errors occurred!");
+}
+
+TEST_CASE(SpillRoundTrip) {
+	const std::string data = WriteMixedStream(200);
+	for(bool materialize : {false, true}) {
+		Decoder reference(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = materialize});
+		reference.Parse();
+		std::vector<std::string> expected;
+		DescribeRoot(reference.GetIndex(), expected);
+		std::ranges::sort(expected);
+
+		for(uint64_t maxEntries : {uint64_t(4), uint64_t(7), uint64_t(64), uint64_t(1000)}) {
+			Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = materialize, .limits = {.maxEntries = maxEntries, .spillIndex = true}});
+			decoder.Parse();
+			CHECK((decoder.GetSpilledChunkCount() > 0) == (maxEntries < 1000));
+
+			//Spilled chunks are complete root-level entries, so reading them back in order and appending the rest gives the same index
+			std::vector<std::string> actual;
+			for(std::size_t chunk = 0; chunk < decoder.GetSpilledChunkCount(); ++chunk) {
+				const Index spilled = decoder.LoadSpilledChunk(chunk);
+				CHECK(spilled.root.subvalues.size() + spilled.root.subscopes.size() > 0);
+				DescribeRoot(spilled, actual);
+			}
+			DescribeRoot(decoder.GetIndex(), actual);
+			std::ranges::sort(actual);
+			CHECK(actual == expected);
+		}
+	}
+	CHECK_THROWS(Decoder(test::ReadStream(data)).LoadSpilledChunk(0), "No spilled index chunk with that number exists!");
+}
+
+TEST_CASE(SpillOnMaterializedBytes) {
+	const std::string data = WriteMixedStream(50);
+	Decoder reference(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = true});
+	reference.Parse();
+
+	Decoder decoder(test::ReadStream(data), std::pmr::get_default_resource(), {.materialize = true, .limits = {.maxMaterializedBytes = 32, .spillIndex = true}});
+	decoder.Parse();
+	CHECK(decoder.GetSpilledChunkCount() > 1);
+	uint64_t materializedBytes = decoder.GetIndex().values.size();
+	std::size_t valueCount = decoder.GetIndex().root.subvalues.size();
+	for(std::size_t chunk = 0; chunk < decoder.GetSpilledChunkCount(); ++chunk) {
+		const Index spilled = decoder.LoadSpilledChunk(chunk);
+		//A chunk is spilled once it reaches the limit, so it holds less than the limit plus one root-level value
+		CHECK(spilled.values.size() < 32 + 8);
+		materializedBytes += spilled.values.size();
+		valueCount += spilled.root.subvalues.size();
+		for(const ValueEntry& value : spilled.root.subvalues) {
+			const ValueEntry* original = reference.GetIndex().root.FindValue(value.id);
+			CHECK(original != nullptr && original->IsMaterialized() == value.IsMaterialized());
+			if(original && value.type == TypeTag::String) CHECK(reference.GetIndex().GetString(*original) == spilled.GetString(value));
+		}
+	}
+	CHECK(materializedBytes == reference.GetIndex().values.size());
+	CHECK(valueCount == reference.GetIndex().root.subvalues.size());
+}
+
+TEST_CASE(SpillStillRejectsOversizedValues) {
+	//The object alone holds more entries than the limit, so spilling cannot help
+	const std::string data = WriteMixedStream(10);
+	CHECK_THROWS(Parse(data, {.limits = {.maxEntries = 2, .spillIndex = true}}), "Index entry limit exceeded!");
+}
+
+int main() {
+	return test::RunTests();
+}
\ No newline at end of file
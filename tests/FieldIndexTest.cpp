@@ -0,0 +1,252 @@
+#include "Testing.hpp"
+#include <libjaguar/Decoder.hpp>
+#include <libjaguar/FieldIndex.hpp>
+#include <libjaguar/IndexID.hpp>
+#include <libjaguar/ListView.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+
+using namespace libjaguar;
+
+constexpr uint32_t sampleCount = 2000;
+constexpr double infinity = std::numeric_limits<double>::infinity();
+constexpr double notANumber = std::numeric_limits<double>::quiet_NaN();
+
+//Every hundred elements hold each of the special floating-point values once
+static double GetX(uint32_t i) {
+	switch(i % 100) {
+		case 0: return -0.0;
+		case 1: return 0.0;
+		case 2: return notANumber;
+		case 3: return -notANumber;
+		case 4: return infinity;
+		case 5: return -infinity;
+		default: return i * 0.5 - 300.5;
+	}
+}
+
+static const std::string& GetStream() {
+	static const std::string data = test::WriteStream([](Writer& writer) {
+		StructuredTypeLayout layout;
+		layout.typeID = "Sample";
+		for(auto [type, name] : {std::pair(TypeTag::UInt32, "n"), std::pair(TypeTag::SInt32, "d"), std::pair(TypeTag::Float64, "x"), std::pair(TypeTag::String, "tag"),
+								 std::pair(TypeTag::Boolean, "flag")}) {
+			StructuredTypeLayout::Field field;
+			field.type = type;
+			field.name = name;
+			layout.fields.push_back(field);
+		}
+		writer.WriteTypeDeclaration(layout);
+
+		ValueHeader list;
+		list.type = TypeTag::List;
+		list.name = "samples";
+		list.elementType = TypeTag::StructuredObj;
+		list.typeID = "Sample";
+		list.size = sampleCount;
+		writer.WriteHeader(list);
+		for(uint32_t i = 0; i < sampleCount; ++i) {
+			test::WriteUInt32(writer, "n", i);
+			ValueHeader field;
+			field.type = TypeTag::SInt32;
+			field.name = "d";
+			writer.WriteHeader(field);
+			writer.WriteInteger<int32_t>(int32_t(i) - 1000);
+			field.type = TypeTag::Float64;
+			field.name = "x";
+			writer.WriteHeader(field);
+			writer.WriteFloat<double>(GetX(i));
+			test::WriteString(writer, "tag", "t" + std::to_string(i));
+			field.type = TypeTag::Boolean;
+			field.name = "flag";
+			writer.WriteHeader(field);
+			writer.WriteBool(i % 2 == 0);
+			ValueHeader boundary;
+			boundary.type = TypeTag::ScopeBoundary;
+			writer.WriteHeader(boundary);
+		}
+
+		ValueHeader other = list;
+		other.name = "others";
+		other.size = 1;
+		writer.WriteHeader(other);
+		test::WriteUInt32(writer, "n", 0);
+		ValueHeader field;
+		field.type = TypeTag::SInt32;
+		field.name = "d";
+		writer.WriteHeader(field);
+		writer.WriteInteger<int32_t>(0);
+		field.type = TypeTag::Float64;
+		field.name = "x";
+		writer.WriteHeader(field);
+		writer.WriteFloat<double>(0);
+		test::WriteString(writer, "tag", "");
+		field.type = TypeTag::Boolean;
+		field.name = "flag";
+		writer.WriteHeader(field);
+		writer.WriteBool(false);
+		ValueHeader boundary;
+		boundary.type = TypeTag::ScopeBoundary;
+		writer.WriteHeader(boundary);
+
+		test::WriteUInt32(writer, "count", sampleCount);
+	});
+	return data;
+}
+
+static Reader OpenStream() {
+	return test::ReadStream(GetStream());
+}
+
+//The decoded stream, with checkpoints for reading the list on several threads
+static const Index& GetIndex() {
+	static Decoder decoder = [] {
+		Decoder result(OpenStream(), std::pmr::get_default_resource(), {.listCheckpointInterval = 64});
+		result.Parse();
+		return result;
+	}();
+	return decoder.GetIndex();
+}
+
+static bool SameMatches(std::span<const FieldIndexMatch> a, std::span<const FieldIndexMatch> b) {
+	if(a.size() != b.size()) return false;
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		if(a[i].element != b[i].element || a[i].position != b[i].position) return false;
+	}
+	return true;
+}
+
+TEST_CASE(SerialAndParallelBuildsAgree) {
+	Decoder plain(OpenStream());
+	plain.Parse();
+	const ValueEntry& plainList = plain.GetIndex().root.subvalues[0];
+	const ValueEntry& list = GetIndex().root.subvalues[0];
+	CHECK(plainList.checkpointOffset == UINT64_MAX && list.checkpointOffset != UINT64_MAX);
+
+	for(unsigned int threadCount : {1u, 3u, 8u, 0u}) {
+		const FieldIndex serial = FieldIndex::Build(OpenStream, plain.GetIndex(), plainList, "n", threadCount);
+		const FieldIndex parallel = FieldIndex::Build(OpenStream, GetIndex(), list, "n", threadCount);
+		CHECK(serial.size() == sampleCount && parallel.size() == sampleCount);
+		CHECK(SameMatches(serial.FindRange(uint32_t(0), UINT32_MAX), parallel.FindRange(uint32_t(0), UINT32_MAX)));
+
+		const FieldIndex serialTags = FieldIndex::Build(OpenStream, plain.GetIndex(), plainList, "tag", threadCount);
+		const FieldIndex parallelTags = FieldIndex::Build(OpenStream, GetIndex(), list, "tag", threadCount);
+		CHECK(SameMatches(serialTags.FindRange("", "u"), parallelTags.FindRange("", "u")));
+		CHECK(parallelTags.FindRange("", "u").size() == sampleCount);
+	}
+}
+
+TEST_CASE(FindNumbers) {
+	const ValueEntry& list = GetIndex().root.subvalues[0];
+	const FieldIndex numbers = FieldIndex::Build(OpenStream, GetIndex(), list, "n", 4);
+	CHECK(numbers.GetFieldName() == "n" && numbers.GetKeyType() == TypeTag::UInt32);
+
+	//Every match leads to its element
+	Reader reader = OpenStream();
+	ListView<StructView> view(reader, list);
+	for(uint32_t key : {0u, 1u, 63u, 64u, 1234u, sampleCount - 1}) {
+		std::span<const FieldIndexMatch> matches = numbers.Find(key);
+		CHECK(matches.size() == 1 && matches[0].element == key);
+		view.SkipTo(matches[0].element, matches[0].position);
+		CHECK((*view.begin()).Get<uint32_t>("n") == key);
+	}
+	CHECK(numbers.Find(sampleCount).empty());
+	CHECK(numbers.FindRange(uint32_t(10), uint32_t(19)).size() == 10);
+	CHECK(numbers.FindRange(uint32_t(19), uint32_t(10)).empty());
+	CHECK_THROWS(numbers.Find(int32_t(3)), "Key type does not match the type of the indexed field!");
+	CHECK_THROWS(numbers.Find("3"), "Key type does not match the type of the indexed field!");
+
+	//Negative keys sort before positive ones
+	const FieldIndex signedNumbers = FieldIndex::Build(OpenStream, GetIndex(), list, "d", 4);
+	std::span<const FieldIndexMatch> around = signedNumbers.FindRange(int32_t(-5), int32_t(5));
+	CHECK(around.size() == 11 && around.front().element == 995 && around.back().element == 1005);
+	CHECK(signedNumbers.FindRange(INT32_MIN, int32_t(-1)).size() == 1000);
+}
+
+TEST_CASE(FindStrings) {
+	const FieldIndex tags = FieldIndex::Build(OpenStream, GetIndex(), GetIndex().root.subvalues[0], "tag", 4);
+	std::span<const FieldIndexMatch> matches = tags.Find("t777");
+	CHECK(matches.size() == 1 && matches[0].element == 777);
+	CHECK(tags.Find("t").empty());
+	CHECK(tags.Find("t7777").empty());
+
+	//Byte-wise order puts t1, t10..t19, t100..t199, and t1000..t1999 between t1 and t1~
+	CHECK(tags.FindRange("t1", "t1~").size() == 1111);
+	CHECK(tags.FindRange("t2", "t1").empty());
+	CHECK_THROWS(tags.Find(uint32_t(3)), "Key type does not match the type of the indexed field!");
+}
+
+TEST_CASE(SignedZerosAndNaNs) {
+	const FieldIndex xs = FieldIndex::Build(OpenStream, GetIndex(), GetIndex().root.subvalues[0], "x", 4);
+	constexpr std::size_t runs = sampleCount / 100;
+
+	//-0.0 and 0.0 are one key
+	CHECK(xs.Find(0.0).size() == 2 * runs);
+	CHECK(SameMatches(xs.Find(-0.0), xs.Find(0.0)));
+	CHECK(xs.FindRange(-0.0, 0.0).size() == 2 * runs);
+
+	//NaNs of either sign are one key, above +inf
+	CHECK(xs.Find(notANumber).size() == 2 * runs);
+	CHECK(SameMatches(xs.Find(-notANumber), xs.Find(notANumber)));
+	CHECK(xs.FindRange(-infinity, infinity).size() == sampleCount - 2 * runs);
+	CHECK(xs.FindRange(infinity, notANumber).size() == 3 * runs);
+	CHECK(xs.FindRange(notANumber, infinity).empty());
+	CHECK(xs.Find(-infinity).size() == runs);
+}
+
+TEST_CASE(BuildErrors) {
+	const Index& index = GetIndex();
+	const ValueEntry& list = index.root.subvalues[0];
+	CHECK_THROWS(FieldIndex::Build(OpenStream, index, list, "missing"), "No field exists with the requested name!");
+	CHECK_THROWS(FieldIndex::Build(OpenStream, index, list, "flag"), "Only number and string fields can be indexed!");
+	CHECK_THROWS(FieldIndex::Build(OpenStream, index, index.root.subvalues[2], "n"), "Only lists of structured objects can be indexed!");
+}
+
+TEST_CASE(SaveAndLoad) {
+	const Index& index = GetIndex();
+	const ValueEntry& list = index.root.subvalues[0];
+	for(std::string_view field : {"n", "x", "tag"}) {
+		const FieldIndex built = FieldIndex::Build(OpenStream, index, list, field, 4);
+		const std::string saved = test::WriteStream([&](Writer& writer) { built.Save(writer); });
+
+		Reader reader = test::ReadStream(saved);
+		const FieldIndex loaded = FieldIndex::Load(reader, list);
+		CHECK(loaded.size() == built.size() && loaded.GetKeyType() == built.GetKeyType() && loaded.GetFieldName() == field);
+		CHECK(loaded.GetID() == built.GetID());
+		if(field == "n") CHECK(SameMatches(loaded.FindRange(uint32_t(5), uint32_t(500)), built.FindRange(uint32_t(5), uint32_t(500))));
+		if(field == "x") CHECK(SameMatches(loaded.Find(notANumber), built.Find(notANumber)) && SameMatches(loaded.Find(-0.0), built.Find(0.0)));
+		if(field == "tag") CHECK(SameMatches(loaded.FindRange("t2", "t3"), built.FindRange("t2", "t3")));
+
+		//An index only loads for the list it was built for
+		Reader otherReader = test::ReadStream(saved);
+		CHECK_THROWS(FieldIndex::Load(otherReader, index.root.subvalues[1]), "Saved field index was built for a different list!");
+	}
+}
+
+TEST_CASE(BuildFromSpilledChunk) {
+	//Every root-level value is spilled on its own, away from the type declaration
+	Decoder decoder(OpenStream(), std::pmr::get_default_resource(), {.listCheckpointInterval = 64, .limits = {.maxEntries = 1, .spillIndex = true}});
+	decoder.Parse();
+	CHECK(decoder.GetSpilledChunkCount() == 3);
+	const Index spilled = decoder.LoadSpilledChunk(0);
+	const ValueEntry& list = spilled.root.subvalues[0];
+	CHECK(list.name == "samples" && spilled.FindType(list.typeID) != nullptr);
+
+	const FieldIndex numbers = FieldIndex::Build(OpenStream, spilled, list, "n", 4);
+	const FieldIndex reference = FieldIndex::Build(OpenStream, GetIndex(), GetIndex().root.subvalues[0], "n", 4);
+	CHECK(SameMatches(numbers.FindRange(uint32_t(0), UINT32_MAX), reference.FindRange(uint32_t(0), UINT32_MAX)));
+}
+
+TEST_CASE(PathID) {
+	const FieldIndex tags = FieldIndex::Build(OpenStream, GetIndex(), GetIndex().root.subvalues[0], "tag", 1);
+	CHECK(tags.GetID() == "samples[].tag"_jid);
+	CHECK(tags.GetID() != "samples.tag"_jid);
+}
+
+int main() {
+	return test::RunTests();
+}
\ No newline at end of file
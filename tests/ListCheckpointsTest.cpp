@@ -0,0 +1,214 @@
+#include "Testing.hpp"
+#include <libjaguar/Decoder.hpp>
+#include <libjaguar/ListView.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace libjaguar;
+
+constexpr uint32_t nameCount = 1000;
+constexpr uint32_t frameCount = 500;
+constexpr uint32_t fixedCount = 300;
+
+static std::string GetName(uint32_t i) {
+	return "name" + std::to_string(i * 7919 % 1000) + std::string(i % 13, '.');
+}
+
+static void WriteListHeader(Writer& writer, std::string_view name, TypeTag elementType, uint32_t size, std::string_view typeID = {}) {
+	ValueHeader header;
+	header.type = TypeTag::List;
+	header.name = name;
+	header.elementType = elementType;
+	header.size = size;
+	header.typeID = typeID;
+	writer.WriteHeader(header);
+}
+
+//Lists of strings, objects, and numbers with varying element sizes, and a list too short for any checkpoint
+static const std::string& GetStream() {
+	static const std::string data = test::WriteStream([](Writer& writer) {
+		StructuredTypeLayout layout;
+		layout.typeID = "Frame";
+		StructuredTypeLayout::Field number;
+		number.type = TypeTag::UInt32;
+		number.name = "n";
+		layout.fields.push_back(number);
+		StructuredTypeLayout::Field tag;
+		tag.type = TypeTag::String;
+		tag.name = "tag";
+		layout.fields.push_back(tag);
+		writer.WriteTypeDeclaration(layout);
+
+		test::WriteUInt32(writer, "before", 1);
+		WriteListHeader(writer, "names", TypeTag::String, nameCount);
+		for(uint32_t i = 0; i < nameCount; ++i) {
+			const std::string name = GetName(i);
+			ValueHeader element;
+			element.type = TypeTag::String;
+			element.size = uint32_t(name.size());
+			writer.WriteHeader(element, true);
+			writer.WriteString(name);
+		}
+
+		WriteListHeader(writer, "frames", TypeTag::StructuredObj, frameCount, "Frame");
+		for(uint32_t i = 0; i < frameCount; ++i) {
+			test::WriteUInt32(writer, "n", i);
+			test::WriteString(writer, "tag", "t" + std::to_string(i));
+			ValueHeader boundary;
+			boundary.type = TypeTag::ScopeBoundary;
+			writer.WriteHeader(boundary);
+		}
+
+		WriteListHeader(writer, "fixed", TypeTag::UInt32, fixedCount);
+		for(uint32_t i = 0; i < fixedCount; ++i) writer.WriteInteger<uint32_t>(i * 3);
+
+		WriteListHeader(writer, "short", TypeTag::String, 2);
+		for(std::string_view name : {"a", "b"}) {
+			ValueHeader element;
+			element.type = TypeTag::String;
+			element.size = uint32_t(name.size());
+			writer.WriteHeader(element, true);
+			writer.WriteString(name);
+		}
+		test::WriteUInt32(writer, "after", 2);
+	});
+	return data;
+}
+
+static const ValueEntry& FindList(const Index& index, std::string_view name) {
+	for(const ValueEntry& value : index.root.subvalues) {
+		if(value.name == name) return value;
+	}
+	throw std::runtime_error("No list with that name!");
+}
+
+TEST_CASE(CheckpointsAreRecordedForWalkedLists) {
+	Decoder decoder(test::ReadStream(GetStream()), std::pmr::get_default_resource(), {.listCheckpointInterval = 100});
+	decoder.Parse();
+	const Index& index = decoder.GetIndex();
+	CHECK(index.listCheckpointInterval == 100);
+	CHECK(FindList(index, "names").checkpointOffset != UINT64_MAX);
+	CHECK(FindList(index, "frames").checkpointOffset != UINT64_MAX);
+
+	//Fixed-size elements are seeked to directly, and short lists need no checkpoints
+	CHECK(FindList(index, "fixed").checkpointOffset == UINT64_MAX);
+	CHECK(FindList(index, "short").checkpointOffset == UINT64_MAX);
+	CHECK(index.listCheckpoints.size() == (nameCount - 1) / 100 + (frameCount - 1) / 100);
+
+	//Without an interval, nothing is walked or recorded
+	Decoder plain(test::ReadStream(GetStream()));
+	plain.Parse();
+	CHECK(plain.GetIndex().listCheckpoints.empty());
+	CHECK(FindList(plain.GetIndex(), "names").checkpointOffset == UINT64_MAX);
+}
+
+TEST_CASE(FindListCheckpoint) {
+	Decoder decoder(test::ReadStream(GetStream()), std::pmr::get_default_resource(), {.listCheckpointInterval = 100});
+	decoder.Parse();
+	const Index& index = decoder.GetIndex();
+	const ValueEntry& names = FindList(index, "names");
+	CHECK(index.FindListCheckpoint(names, 0) == std::make_pair(uint32_t(0), names.streamBeginPosition));
+	CHECK(index.FindListCheckpoint(names, 99).first == 0);
+	CHECK(index.FindListCheckpoint(names, 100).first == 100);
+	CHECK(index.FindListCheckpoint(names, 250).first == 200);
+	CHECK(index.FindListCheckpoint(names, nameCount - 1).first == 900);
+
+	//Each checkpoint is the position of its element
+	Reader reader = test::ReadStream(GetStream());
+	for(uint32_t element : {0u, 1u, 100u, 250u, 999u}) {
+		const auto [first, position] = index.FindListCheckpoint(names, element);
+		ListView<std::string_view> view(reader, names);
+		view.SkipTo(first, position);
+		CHECK(*view.begin() == GetName(first));
+	}
+}
+
+TEST_CASE(RandomAccessMatchesSequentialReads) {
+	for(uint32_t interval : {1u, 7u, 100u, 5000u}) {
+		Decoder decoder(test::ReadStream(GetStream()), std::pmr::get_default_resource(), {.listCheckpointInterval = interval});
+		decoder.Parse();
+		const Index& index = decoder.GetIndex();
+		Reader reader = test::ReadStream(GetStream());
+
+		//Forward and backward jumps alike, with the last element and repeats included
+		std::mt19937 random(interval);
+		ListView<std::string_view> names(reader, FindList(index, "names"), index);
+		for(int i = 0; i < 200; ++i) {
+			const uint32_t element = (i % 50 == 0 ? nameCount - 1 : random() % nameCount);
+			names.SkipTo(element);
+			CHECK(*names.begin() == GetName(element));
+		}
+		names.SkipTo(nameCount);
+		CHECK(names.begin() == names.end());
+
+		ListView<StructView> frames(reader, FindList(index, "frames"), index);
+		for(uint32_t element : {frameCount - 1, 5u, 250u, 0u, 377u, 377u}) {
+			frames.SkipTo(element);
+			const StructView& frame = *frames.begin();
+			CHECK(frame.Get<uint32_t>("n") == element);
+			CHECK(frame.GetString("tag") == "t" + std::to_string(element));
+		}
+		frames.SkipRemaining();
+
+		ListView<uint32_t> fixed(reader, FindList(index, "fixed"), index);
+		for(uint32_t element : {fixedCount - 1, 3u, 150u}) {
+			fixed.SkipTo(element);
+			CHECK(*fixed.begin() == element * 3);
+		}
+
+		ListView<std::string_view> shortList(reader, FindList(index, "short"), index);
+		shortList.SkipTo(1);
+		CHECK(*shortList.begin() == "b");
+		shortList.SkipTo(0);
+		CHECK(*shortList.begin() == "a");
+	}
+}
+
+TEST_CASE(BackwardAccessNeedsIndex) {
+	Decoder decoder(test::ReadStream(GetStream()));
+	decoder.Parse();
+	Reader reader = test::ReadStream(GetStream());
+	ListView<std::string_view> names(reader, FindList(decoder.GetIndex(), "names"));
+	names.SkipTo(10);
+	CHECK(*names.begin() == GetName(10));
+	CHECK_THROWS(names.SkipTo(3), "List view elements can only be read in order!");
+	CHECK_THROWS(names.SkipTo(nameCount + 1), "Out of bounds list element access!");
+}
+
+TEST_CASE(SpilledChunksKeepCheckpoints) {
+	Decoder reference(test::ReadStream(GetStream()), std::pmr::get_default_resource(), {.listCheckpointInterval = 100});
+	reference.Parse();
+
+	Decoder decoder(test::ReadStream(GetStream()), std::pmr::get_default_resource(), {.listCheckpointInterval = 100, .limits = {.maxEntries = 2, .spillIndex = true}});
+	decoder.Parse();
+	CHECK(decoder.GetSpilledChunkCount() > 2);
+
+	std::size_t checkpointCount = decoder.GetIndex().listCheckpoints.size();
+	bool foundNames = false;
+	Reader reader = test::ReadStream(GetStream());
+	for(std::size_t chunk = 0; chunk < decoder.GetSpilledChunkCount(); ++chunk) {
+		const Index spilled = decoder.LoadSpilledChunk(chunk);
+		checkpointCount += spilled.listCheckpoints.size();
+		for(const ValueEntry& value : spilled.root.subvalues) {
+			if(value.name != "names") continue;
+			foundNames = true;
+			CHECK(spilled.listCheckpointInterval == 100);
+			CHECK(spilled.FindListCheckpoint(value, 750) == reference.GetIndex().FindListCheckpoint(FindList(reference.GetIndex(), "names"), 750));
+			ListView<std::string_view> names(reader, value, spilled);
+			for(uint32_t element : {750u, 20u, 999u}) {
+				names.SkipTo(element);
+				CHECK(*names.begin() == GetName(element));
+			}
+		}
+	}
+	CHECK(foundNames);
+	CHECK(checkpointCount == reference.GetIndex().listCheckpoints.size());
+}
+
+int main() {
+	return test::RunTests();
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <libjaguar/Reader.hpp>
+#include <libjaguar/ValueHeader.hpp>
+#include <libjaguar/Writer.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//Minimal test harness: each test executable declares its cases with TEST_CASE and runs them all from main() with RunTests()
+#define TEST_CASE(name)                                                       \
+	static void name();                                                       \
+	static const bool name##Registered = test::RegisterTestCase(#name, name); \
+	static void name()
+
+#define CHECK(condition)                                                                       \
+	do {                                                                                       \
+		if(!(condition)) test::ReportFailure(__FILE__, __LINE__, "Check failed: " #condition); \
+	} while(false)
+
+//Check that an expression throws a std::runtime_error with exactly the given message
+#define CHECK_THROWS(expression, message)                                                                                  \
+	do {                                                                                                                   \
+		try {                                                                                                              \
+			expression;                                                                                                    \
+			test::ReportFailure(__FILE__, __LINE__, "No exception from: " #expression);                                    \
+		} catch(const std::runtime_error& e) {                                                                             \
+			if(std::string_view(e.what()) != std::string_view(message))                                                    \
+				test::ReportFailure(__FILE__, __LINE__, std::string("Wrong exception from " #expression ": ") + e.what()); \
+		}                                                                                                                  \
+	} while(false)
+
+namespace test {
+	struct TestCase {
+		const char* name;
+		void (*run)();
+	};
+
+	inline std::vector<TestCase>& GetTestCases() {
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	inline int failureCount = 0;
+
+	inline bool RegisterTestCase(const char* name, void (*run)()) {
+		GetTestCases().push_back({name, run});
+		return true;
+	}
+
+	inline void ReportFailure(const char* file, int line, const std::string& message) {
+		std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+		++failureCount;
+	}
+
+	/**
+	 * @brief Run all registered test cases, reporting each one
+	 *
+	 * @return The process exit code (0 if every check passed)
+	 */
+	inline int RunTests() {
+		for(const TestCase& testCase : GetTestCases()) {
+			const int failuresBefore = failureCount;
+			try {
+				testCase.run();
+			} catch(const std::exception& e) {
+				ReportFailure(testCase.name, 0, std::string("Unexpected exception: ") + e.what());
+			}
+			std::printf("%s %s\n", failureCount == failuresBefore ? "PASS" : "FAIL", testCase.name);
+		}
+		return failureCount == 0 ? 0 : 1;
+	}
+
+	/**
+	 * @brief Write a Jaguar stream into memory
+	 *
+	 * @param write Writes the stream contents
+	 *
+	 * @return The stream data
+	 */
+	inline std::string WriteStream(const std::function<void(libjaguar::Writer&)>& write) {
+		auto stream = std::make_unique<std::ostringstream>(std::ios::binary);
+		std::ostringstream* output = stream.get();
+		libjaguar::Writer writer(std::move(stream));
+		write(writer);
+		writer.Flush();
+		return output->str();
+	}
+
+	/**
+	 * @brief Create a seekable reader over a copy of stream data in memory
+	 *
+	 * @param data The stream data
+	 *
+	 * @return The reader
+	 */
+	inline libjaguar::Reader ReadStream(const std::string& data) {
+		return libjaguar::Reader(std::make_unique<std::istringstream>(data, std::ios::binary));
+	}
+
+	inline void WriteUInt32(libjaguar::Writer& writer, std::string_view name, uint32_t value) {
+		libjaguar::ValueHeader header;
+		header.type = libjaguar::TypeTag::UInt32;
+		header.name = name;
+		writer.WriteHeader(header);
+		writer.WriteInteger<uint32_t>(value);
+	}
+
+	inline void WriteString(libjaguar::Writer& writer, std::string_view name, std::string_view value) {
+		libjaguar::ValueHeader header;
+		header.type = libjaguar::TypeTag::String;
+		header.name = name;
+		header.size = uint32_t(value.size());
+		writer.WriteHeader(header);
+		writer.WriteString(value);
+	}
+}
\ No newline at end of file
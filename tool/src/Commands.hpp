@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace jaguartool {
+	//Each subcommand receives the arguments following its name and returns the process exit code
+	int RunCompile(const std::vector<std::string>& args);
+	int RunDump(const std::vector<std::string>& args);
+	int RunFromJson(const std::vector<std::string>& args);
+	int RunToJson(const std::vector<std::string>& args);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Commands.hpp"
+#include "Compiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+namespace jaguartool {
+	struct CompileJob {
+		std::filesystem::path input;
+		std::filesystem::path output;
+		std::string error;
+	};
+
+	static void PrintCompileUsage() {
+		std::cerr << "Usage: jaguartool compile [-j THREADS] [-o OUTPUT] INPUT...\n"
+					 "\n"
+					 "Compile Jaguar text files into Jaguar streams.\n"
+					 "\n"
+					 "With one input, OUTPUT names the output file (defaults to the input with a .jag extension, or standard output for '-').\n"
+					 "With several inputs, OUTPUT names a directory that receives one .jag file per input (defaults to next to each input),\n"
+					 "and inputs are compiled in parallel on up to THREADS threads (defaults to the hardware concurrency).\n";
+	}
+
+	int RunCompile(const std::vector<std::string>& args) {
+		//Parse arguments
+		std::vector<std::filesystem::path> inputs;
+		std::filesystem::path output;
+		unsigned int threadCount = 0;
+		for(std::size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			if((arg == "-o" || arg == "-j") && i + 1 >= args.size()) {
+				PrintCompileUsage();
+				return 2;
+			}
+			if(arg == "-o") {
+				output = args[++i];
+			} else if(arg == "-j") {
+				try {
+					threadCount = static_cast<unsigned int>(std::stoul(args[++i]));
+				} catch(...) {
+					PrintCompileUsage();
+					return 2;
+				}
+			} else if(arg == "-h" || arg == "--help") {
+				PrintCompileUsage();
+				return 0;
+			} else {
+				inputs.push_back(arg);
+			}
+		}
+		if(inputs.empty()) {
+			PrintCompileUsage();
+			return 2;
+		}
+
+		//Work out where each output goes
+		std::vector<CompileJob> jobs;
+		for(const std::filesystem::path& input : inputs) {
+			CompileJob job = {input, {}, {}};
+			if(inputs.size() == 1 && !output.empty()) {
+				job.output = output;
+			} else if(input == "-") {
+				job.output = "-";
+			} else {
+				std::filesystem::path name = input.filename().replace_extension(".jag");
+				job.output = (output.empty() ? input.parent_path() / name : output / name);
+			}
+			jobs.push_back(std::move(job));
+		}
+		if(inputs.size() > 1 && !output.empty()) std::filesystem::create_directories(output);
+
+		//Compile everything, pulling jobs off a shared counter
+		if(threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+		threadCount = std::min<unsigned int>(threadCount, jobs.size());
+		std::atomic<std::size_t> nextJob = 0;
+		auto worker = [&]() {
+			for(std::size_t idx = nextJob++; idx < jobs.size(); idx = nextJob++) {
+				CompileJob& job = jobs[idx];
+				try {
+					CompileFile(job.input, job.output);
+				} catch(const std::exception& e) {
+					job.error = e.what();
+					if(job.output != "-") {
+						std::error_code ec;
+						std::filesystem::remove(job.output, ec);
+					}
+				}
+			}
+		};
+		std::vector<std::thread> workers;
+		for(unsigned int t = 1; t < threadCount; ++t) workers.emplace_back(worker);
+		worker();
+		for(std::thread& t : workers) t.join();
+
+		//Report failures in input order
+		int failures = 0;
+		for(const CompileJob& job : jobs) {
+			if(job.error.empty()) continue;
+			std::cerr << "error: " << job.error << "\n";
+			++failures;
+		}
+		if(failures > 0 && jobs.size() > 1) std::cerr << failures << " of " << jobs.size() << " files failed to compile\n";
+		return failures > 0 ? 1 : 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,527 @@
+#include "Compiler.hpp"
+
+#include "libjaguar/TypeTags.hpp"
+#include "libjaguar/ValueHeader.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <unordered_set>
+
+using namespace libjaguar;
+
+namespace jaguartool {
+	Compiler::Compiler(Lexer& lexer, Writer& writer, PatchableOstream& out) : lexer(lexer), writer(writer), out(out), inSubstream(false) {}
+
+	void Compiler::Compile() {
+		try {
+			CompileStatements(false);
+		} catch(const SyntaxError&) {
+			throw;
+		} catch(const std::exception& e) {
+			//Errors from the writer don't know where they came from
+			throw SyntaxError(lexer.Location() + ": " + e.what());
+		}
+	}
+
+	void Compiler::CompileStatements(bool untilBrace) {
+		while(true) {
+			const Token& next = lexer.Peek();
+			if(next.type == TokenType::End) {
+				if(untilBrace) lexer.Fail(next, "Expected '}'");
+				return;
+			}
+			if(next.type == TokenType::RBrace) {
+				if(!untilBrace) lexer.Fail(next, "Unexpected '}'");
+				lexer.Next();
+				return;
+			}
+			if(lexer.Accept(TokenType::Semicolon)) continue;
+
+			//Type declarations are only allowed at the root
+			Token first = lexer.Next();
+			if(first.type == TokenType::Identifier && first.text == "type") {
+				CompileTypeDeclaration();
+				continue;
+			}
+
+			//Otherwise this is a value: <type> <name> = <literal>
+			TypeSpec spec = ParseTypeSpec(first);
+			std::string name = ParseName(lexer.Next());
+			lexer.Expect(TokenType::Equals, "'='");
+			CompileValue(spec, name, false, 0);
+			lexer.Accept(TokenType::Semicolon);
+		}
+	}
+
+	void Compiler::CompileTypeDeclaration() {
+		Token nameToken = lexer.Next();
+		std::string typeID = ParseName(nameToken);
+		if(types.contains(typeID)) lexer.Fail(nameToken, "Type '" + typeID + "' has already been declared");
+		StructuredTypeLayout layout;
+		layout.typeID = typeID;
+		lexer.Expect(TokenType::LBrace, "'{'");
+
+		while(!lexer.Accept(TokenType::RBrace)) {
+			if(lexer.Accept(TokenType::Semicolon)) continue;
+
+			//Each field is <type> <name>
+			Token first = lexer.Next();
+			TypeSpec spec = ParseTypeSpec(first);
+			StructuredTypeLayout::Field field = {};
+			field.type = spec.type;
+			field.name = ParseName(lexer.Next());
+			switch(spec.type) {
+				case TypeTag::Vector:
+				case TypeTag::Matrix:
+					field.elementType = spec.elementType;
+					field.width = spec.width;
+					field.height = spec.height;
+					break;
+				case TypeTag::List:
+					field.elementType = spec.element->type;
+					field.elementTypeID = spec.element->typeID;
+					break;
+				case TypeTag::StructuredObj:
+					field.elementTypeID = spec.typeID;
+					break;
+				default: break;
+			}
+			layout.fields.push_back(std::move(field));
+			lexer.Accept(TokenType::Semicolon);
+		}
+
+		if(!ValidateTypeLayout(layout)) lexer.Fail(nameToken, "Type '" + typeID + "' is not a valid type layout (check for duplicate fields)");
+		writer.WriteTypeDeclaration(layout);
+		types.emplace(std::move(typeID), std::move(layout));
+	}
+
+	uint16_t Compiler::CompileFields(uint8_t depth) {
+		std::unordered_set<std::string> names;
+		while(!lexer.Accept(TokenType::RBrace)) {
+			if(lexer.Accept(TokenType::Semicolon)) continue;
+
+			Token first = lexer.Next();
+			if(first.type == TokenType::Identifier && first.text == "type") lexer.Fail(first, "Type declarations may not appear inside objects");
+			TypeSpec spec = ParseTypeSpec(first);
+			Token nameToken = lexer.Next();
+			std::string name = ParseName(nameToken);
+			if(!names.insert(name).second) lexer.Fail(nameToken, "Duplicate field '" + name + "'");
+			if(names.size() > UINT16_MAX) lexer.Fail(nameToken, "Too many fields in object");
+			lexer.Expect(TokenType::Equals, "'='");
+			CompileValue(spec, name, false, depth);
+			lexer.Accept(TokenType::Semicolon);
+		}
+		return static_cast<uint16_t>(names.size());
+	}
+
+	//Build the type description of a structured object field from its declaration
+	static bool SpecFromField(const StructuredTypeLayout::Field& field, TypeSpec& spec) {
+		spec.type = field.type;
+		spec.elementType = field.elementType;
+		spec.width = field.width;
+		spec.height = field.height;
+		if(field.type == TypeTag::StructuredObj) spec.typeID = field.elementTypeID;
+		if(field.type == TypeTag::List) {
+			//Declarations don't describe the shape of generic list elements
+			if(field.elementType == TypeTag::Vector || field.elementType == TypeTag::Matrix || field.elementType == TypeTag::List) return false;
+			spec.element = std::make_unique<TypeSpec>();
+			spec.element->type = field.elementType;
+			spec.element->typeID = field.elementTypeID;
+		}
+		return true;
+	}
+
+	static bool SpecMatchesField(const TypeSpec& spec, const StructuredTypeLayout::Field& field) {
+		if(spec.type != field.type) return false;
+		switch(spec.type) {
+			case TypeTag::Vector: return spec.elementType == field.elementType && spec.width == field.width;
+			case TypeTag::Matrix: return spec.elementType == field.elementType && spec.width == field.width && spec.height == field.height;
+			case TypeTag::List: return spec.element->type == field.elementType && spec.element->typeID == std::string_view(field.elementTypeID);
+			case TypeTag::StructuredObj: return spec.typeID == std::string_view(field.elementTypeID);
+			default: return true;
+		}
+	}
+
+	void Compiler::CompileStructuredFields(const StructuredTypeLayout& layout, uint8_t depth) {
+		std::vector<bool> seen(layout.fields.size());
+		while(!lexer.Accept(TokenType::RBrace)) {
+			if(lexer.Accept(TokenType::Semicolon)) continue;
+
+			//Fields are either "<name> = <literal>" (type taken from the declaration) or fully typed
+			Token first = lexer.Next();
+			TypeSpec spec = {};
+			Token nameToken = first;
+			bool typed = lexer.Peek().type != TokenType::Equals;
+			if(typed) {
+				spec = ParseTypeSpec(first);
+				nameToken = lexer.Next();
+			}
+			std::string name = ParseName(nameToken);
+
+			//Find the declared field
+			std::size_t fieldIdx = 0;
+			while(fieldIdx < layout.fields.size() && layout.fields[fieldIdx].name != std::string_view(name)) ++fieldIdx;
+			if(fieldIdx == layout.fields.size()) lexer.Fail(nameToken, "Type '" + std::string(layout.typeID) + "' has no field '" + name + "'");
+			if(seen[fieldIdx]) lexer.Fail(nameToken, "Duplicate field '" + name + "'");
+			seen[fieldIdx] = true;
+			const StructuredTypeLayout::Field& field = layout.fields[fieldIdx];
+
+			if(typed) {
+				if(!SpecMatchesField(spec, field)) lexer.Fail(nameToken, "Field '" + name + "' does not match the type declared by '" + std::string(layout.typeID) + "'");
+			} else if(!SpecFromField(field, spec)) {
+				lexer.Fail(nameToken, "Field '" + name + "' needs an explicit type because its declaration does not fully describe it");
+			}
+
+			lexer.Expect(TokenType::Equals, "'='");
+			CompileValue(spec, name, false, depth);
+			lexer.Accept(TokenType::Semicolon);
+		}
+
+		for(std::size_t i = 0; i < seen.size(); ++i) {
+			if(!seen[i]) lexer.Fail("Missing field '" + std::string(layout.fields[i].name) + "' of type '" + std::string(layout.typeID) + "'");
+		}
+	}
+
+	void Compiler::CompileValue(const TypeSpec& spec, const std::string& name, bool element, uint8_t depth) {
+		ValueHeader header = {};
+		header.type = spec.type;
+		header.name = name;
+
+		switch(spec.type) {
+			case TypeTag::String: {
+				Token literal = lexer.Expect(TokenType::String, "a string literal");
+				header.size = static_cast<uint32_t>(literal.text.size());
+				writer.WriteHeader(header, element);
+				writer.WriteString(literal.text);
+				break;
+			}
+			case TypeTag::ByteBuffer:
+				WriteBytes(lexer.Next(), header, element);
+				break;
+			case TypeTag::Substream: {
+				//Substreams may also be given as raw bytes
+				if(lexer.Peek().type != TokenType::LBrace) {
+					WriteBytes(lexer.Next(), header, element);
+					break;
+				}
+				if(inSubstream) lexer.Fail("Substreams may not contain other substreams");
+				lexer.Next();
+
+				//Write the header now and fill in the size once the body is done
+				header.size = 0;
+				writer.WriteHeader(header, element);
+				const uint64_t sizePos = out.Position() - 4;
+				const uint64_t bodyStart = out.Position();
+
+				//Substreams are independent, so they get their own type namespace
+				std::unordered_map<std::string, StructuredTypeLayout> outerTypes;
+				std::swap(types, outerTypes);
+				inSubstream = true;
+				CompileStatements(true);
+				inSubstream = false;
+				std::swap(types, outerTypes);
+
+				const uint64_t size = out.Position() - bodyStart;
+				if(size > UINT32_MAX) lexer.Fail("Substream is larger than 4 GiB");
+				out.PatchInteger(sizePos, size, 4);
+				break;
+			}
+			case TypeTag::Boolean: {
+				Token literal = lexer.Expect(TokenType::Identifier, "'true' or 'false'");
+				if(literal.text != "true" && literal.text != "false") lexer.Fail(literal, "Expected 'true' or 'false'");
+				if(!element) writer.WriteHeader(header);
+				writer.WriteBool(literal.text == "true");
+				break;
+			}
+			case TypeTag::Vector: {
+				header.elementType = spec.elementType;
+				header.width = spec.width;
+				writer.WriteHeader(header, element);
+				lexer.Expect(TokenType::LParen, "'('");
+				for(uint8_t i = 0; i < spec.width; ++i) {
+					if(i > 0) lexer.Expect(TokenType::Comma, "','");
+					WriteNumber(spec.elementType);
+				}
+				lexer.Expect(TokenType::RParen, "')'");
+				break;
+			}
+			case TypeTag::Matrix: {
+				//Written as a tuple of columns, matching the column-major storage order
+				header.elementType = spec.elementType;
+				header.width = spec.width;
+				header.height = spec.height;
+				writer.WriteHeader(header, element);
+				lexer.Expect(TokenType::LParen, "'('");
+				for(uint8_t col = 0; col < spec.width; ++col) {
+					if(col > 0) lexer.Expect(TokenType::Comma, "','");
+					lexer.Expect(TokenType::LParen, "'('");
+					for(uint8_t row = 0; row < spec.height; ++row) {
+						if(row > 0) lexer.Expect(TokenType::Comma, "','");
+						WriteNumber(spec.elementType);
+					}
+					lexer.Expect(TokenType::RParen, "')'");
+				}
+				lexer.Expect(TokenType::RParen, "')'");
+				break;
+			}
+			case TypeTag::List: {
+				if(depth >= maxNestingDepth) lexer.Fail("Maximum nesting depth exceeded");
+				header.elementType = spec.element->type;
+				header.typeID = spec.element->typeID;
+				header.size = 0;
+				writer.WriteHeader(header, element);
+				const uint64_t countPos = out.Position() - 4;
+
+				//Elements are comma-separated, with an optional trailing comma
+				lexer.Expect(TokenType::LBracket, "'['");
+				uint64_t count = 0;
+				while(!lexer.Accept(TokenType::RBracket)) {
+					CompileValue(*spec.element, "", true, depth + 1);
+					if(++count > UINT32_MAX) lexer.Fail("Too many list elements");
+					if(!lexer.Accept(TokenType::Comma)) {
+						lexer.Expect(TokenType::RBracket, "',' or ']'");
+						break;
+					}
+				}
+				out.PatchInteger(countPos, count, 4);
+				break;
+			}
+			case TypeTag::UnstructuredObj: {
+				if(depth >= maxNestingDepth) lexer.Fail("Maximum nesting depth exceeded");
+				header.fieldCount = 0;
+				writer.WriteHeader(header, element);
+				const uint64_t countPos = out.Position() - 2;
+				lexer.Expect(TokenType::LBrace, "'{'");
+				uint16_t fieldCount = CompileFields(depth + 1);
+
+				ValueHeader boundary = {};
+				boundary.type = TypeTag::ScopeBoundary;
+				writer.WriteHeader(boundary);
+				out.PatchInteger(countPos, fieldCount, 2);
+				break;
+			}
+			case TypeTag::StructuredObj: {
+				if(depth >= maxNestingDepth) lexer.Fail("Maximum nesting depth exceeded");
+				const StructuredTypeLayout& layout = types.at(spec.typeID);
+
+				//List elements take their type ID from the list
+				header.typeID = spec.typeID;
+				if(!element) writer.WriteHeader(header);
+				lexer.Expect(TokenType::LBrace, "'{'");
+				CompileStructuredFields(layout, depth + 1);
+
+				ValueHeader boundary = {};
+				boundary.type = TypeTag::ScopeBoundary;
+				writer.WriteHeader(boundary);
+				break;
+			}
+			default:
+				//Numbers have no header data, so list elements are just the number
+				if(!element) writer.WriteHeader(header);
+				WriteNumber(spec.type);
+				break;
+		}
+	}
+
+	void Compiler::WriteBytes(const Token& literal, ValueHeader& header, bool element) {
+		switch(literal.type) {
+			case TokenType::HexBytes: {
+				//The size isn't known until the literal ends
+				header.size = 0;
+				writer.WriteHeader(header, element);
+				const uint64_t sizePos = out.Position() - 4;
+				uint64_t size = lexer.ReadHexBody([this](const unsigned char* data, std::size_t count) {
+					writer.WriteBuffer(std::span<const unsigned char>(data, count));
+				});
+				if(size > UINT32_MAX) lexer.Fail(literal, "Byte literal is larger than 4 GiB");
+				out.PatchInteger(sizePos, size, 4);
+				break;
+			}
+			case TokenType::FilePath: {
+				//Embed a file's contents
+				std::ifstream file(literal.text, std::ios::binary);
+				if(!file) lexer.Fail(literal, "Cannot open file '" + literal.text + "'");
+				std::error_code ec;
+				uintmax_t size = std::filesystem::file_size(literal.text, ec);
+				if(ec) lexer.Fail(literal, "Cannot determine the size of file '" + literal.text + "'");
+				if(size > UINT32_MAX) lexer.Fail(literal, "File '" + literal.text + "' is larger than 4 GiB");
+				header.size = static_cast<uint32_t>(size);
+				writer.WriteHeader(header, element);
+				if(size > 0) writer.WriteBufferFromStream(&file, size);
+				break;
+			}
+			case TokenType::String:
+				//Raw string bytes
+				header.size = static_cast<uint32_t>(literal.text.size());
+				writer.WriteHeader(header, element);
+				writer.WriteBuffer(std::span<const unsigned char>(reinterpret_cast<const unsigned char*>(literal.text.data()), literal.text.size()));
+				break;
+			default: lexer.Fail(literal, "Expected a byte literal (x\"...\", file\"...\", or a string)");
+		}
+	}
+
+	template<integer T>
+	static T ParseInteger(Lexer& lexer, const Token& literal) {
+		//Strip sign, digit separators, and base prefix
+		std::string text;
+		for(char c : literal.text) {
+			if(c != '_') text.push_back(c);
+		}
+		bool negative = false;
+		std::size_t pos = 0;
+		if(!text.empty() && (text[0] == '-' || text[0] == '+')) {
+			negative = text[0] == '-';
+			pos = 1;
+		}
+		int base = 10;
+		if(text.size() > pos + 2 && text[pos] == '0' && (text[pos + 1] == 'x' || text[pos + 1] == 'X')) {
+			base = 16;
+			pos += 2;
+		}
+
+		//Parse the magnitude
+		uint64_t magnitude = 0;
+		auto [end, ec] = std::from_chars(text.data() + pos, text.data() + text.size(), magnitude, base);
+		if(ec != std::errc() || end != text.data() + text.size() || pos == text.size()) lexer.Fail(literal, "Invalid integer literal '" + literal.text + "'");
+
+		//Range check against the target type
+		if constexpr(std::is_signed_v<T>) {
+			const uint64_t limit = negative ? uint64_t(std::numeric_limits<T>::max()) + 1 : uint64_t(std::numeric_limits<T>::max());
+			if(magnitude > limit) lexer.Fail(literal, "Integer literal '" + literal.text + "' is out of range");
+			return negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+		} else {
+			if(negative && magnitude != 0) lexer.Fail(literal, "Integer literal '" + literal.text + "' is out of range");
+			if(magnitude > std::numeric_limits<T>::max()) lexer.Fail(literal, "Integer literal '" + literal.text + "' is out of range");
+			return static_cast<T>(magnitude);
+		}
+	}
+
+	template<std::floating_point T>
+	static T ParseFloat(Lexer& lexer, const Token& literal) {
+		std::string_view text = literal.text;
+		if(!text.empty() && text[0] == '+') text.remove_prefix(1);
+		T value = 0;
+		auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if(ec != std::errc() || end != text.data() + text.size()) lexer.Fail(literal, "Invalid floating-point literal '" + literal.text + "'");
+		return value;
+	}
+
+	void Compiler::WriteNumber(TypeTag type) {
+		Token literal = lexer.Next();
+		bool floatKeyword = literal.type == TokenType::Identifier && (literal.text == "inf" || literal.text == "nan");
+		if(literal.type != TokenType::Number && !((type == TypeTag::Float32 || type == TypeTag::Float64) && floatKeyword)) lexer.Fail(literal, "Expected a number");
+
+		switch(type) {
+			case TypeTag::Float32: writer.WriteFloat(ParseFloat<float>(lexer, literal)); break;
+			case TypeTag::Float64: writer.WriteFloat(ParseFloat<double>(lexer, literal)); break;
+			case TypeTag::SInt8: writer.WriteInteger(ParseInteger<int8_t>(lexer, literal)); break;
+			case TypeTag::SInt16: writer.WriteInteger(ParseInteger<int16_t>(lexer, literal)); break;
+			case TypeTag::SInt32: writer.WriteInteger(ParseInteger<int32_t>(lexer, literal)); break;
+			case TypeTag::SInt64: writer.WriteInteger(ParseInteger<int64_t>(lexer, literal)); break;
+			case TypeTag::UInt8: writer.WriteInteger(ParseInteger<uint8_t>(lexer, literal)); break;
+			case TypeTag::UInt16: writer.WriteInteger(ParseInteger<uint16_t>(lexer, literal)); break;
+			case TypeTag::UInt32: writer.WriteInteger(ParseInteger<uint32_t>(lexer, literal)); break;
+			case TypeTag::UInt64: writer.WriteInteger(ParseInteger<uint64_t>(lexer, literal)); break;
+			default: lexer.Fail(literal, "Expected a numeric type");
+		}
+	}
+
+	std::string Compiler::ParseName(const Token& token) {
+		if(token.type != TokenType::Identifier && token.type != TokenType::String) lexer.Fail(token, "Expected a name");
+		if(token.text.empty() || token.text.size() > UINT8_MAX) lexer.Fail(token, "Names must be between 1 and 255 bytes long");
+		return token.text;
+	}
+
+	const StructuredTypeLayout& Compiler::LookupType(const Token& at, const std::string& typeID) {
+		auto it = types.find(typeID);
+		if(it == types.end()) lexer.Fail(at, "Type '" + typeID + "' has not been declared");
+		return it->second;
+	}
+
+	TypeSpec Compiler::ParseTypeSpec(const Token& first) {
+		if(first.type != TokenType::Identifier) lexer.Fail(first, "Expected a type");
+		TypeSpec spec = {};
+		const std::string& word = first.text;
+
+		//Simple types
+		if(auto scalar = LookupScalarKeyword(word)) {
+			spec.type = *scalar;
+			return spec;
+		}
+
+		//Vectors (vecN<type>) and matrices (matWxH<type>)
+		bool isVector = word.size() == 4 && word.starts_with("vec") && word[3] >= '2' && word[3] <= '4';
+		bool isMatrix = word.size() == 6 && word.starts_with("mat") && word[3] >= '2' && word[3] <= '4' && word[4] == 'x' && word[5] >= '2' && word[5] <= '4';
+		if(isVector || isMatrix) {
+			spec.type = isVector ? TypeTag::Vector : TypeTag::Matrix;
+			spec.width = static_cast<uint8_t>(word[3] - '0');
+			spec.height = isMatrix ? static_cast<uint8_t>(word[5] - '0') : 0;
+			lexer.Expect(TokenType::LAngle, "'<'");
+			Token elem = lexer.Expect(TokenType::Identifier, "a number type");
+			auto elemType = LookupScalarKeyword(elem.text);
+			if(!elemType || !IsMathElementType(*elemType)) lexer.Fail(elem, "Vectors and matrices may only contain numbers");
+			spec.elementType = *elemType;
+			lexer.Expect(TokenType::RAngle, "'>'");
+			return spec;
+		}
+
+		//Lists
+		if(word == "list") {
+			spec.type = TypeTag::List;
+			lexer.Expect(TokenType::LAngle, "'<'");
+			spec.element = std::make_unique<TypeSpec>(ParseTypeSpec(lexer.Next()));
+			spec.elementType = spec.element->type;
+			lexer.Expect(TokenType::RAngle, "'>'");
+			return spec;
+		}
+
+		//Objects
+		if(word == "object") {
+			if(!lexer.Accept(TokenType::LAngle)) {
+				spec.type = TypeTag::UnstructuredObj;
+				return spec;
+			}
+			Token typeToken = lexer.Next();
+			spec.type = TypeTag::StructuredObj;
+			spec.typeID = ParseName(typeToken);
+			LookupType(typeToken, spec.typeID);
+			lexer.Expect(TokenType::RAngle, "'>'");
+			return spec;
+		}
+
+		lexer.Fail(first, "Unknown type '" + word + "'");
+	}
+
+	void CompileFile(const std::filesystem::path& input, const std::filesystem::path& output) {
+		//Open input
+		std::ifstream inFile;
+		if(input != "-") {
+			inFile.open(input, std::ios::binary);
+			if(!inFile) throw std::runtime_error("Cannot open input file '" + input.string() + "'");
+		}
+		std::istream& in = (input == "-" ? std::cin : inFile);
+
+		//Open output
+		std::unique_ptr<PatchableOstream> outStream;
+		if(output == "-") {
+			outStream = std::make_unique<PatchableOstream>(std::cout);
+		} else {
+			auto outFile = std::make_unique<std::ofstream>(output, std::ios::binary | std::ios::trunc);
+			if(!*outFile) throw std::runtime_error("Cannot open output file '" + output.string() + "'");
+			outStream = std::make_unique<PatchableOstream>(std::move(outFile));
+		}
+		PatchableOstream& out = *outStream;
+		Writer writer(std::move(outStream));
+
+		//Compile
+		Lexer lexer(in, input == "-" ? std::string("<stdin>") : input.string());
+		Compiler compiler(lexer, writer, out);
+		compiler.Compile();
+		out.flush();
+		if(!out.good()) throw std::runtime_error("IO error while writing output file '" + output.string() + "'");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Lexer.hpp"
+#include "PatchableOutput.hpp"
+#include "TextFormat.hpp"
+
+#include "libjaguar/StructuredTypeLayout.hpp"
+#include "libjaguar/Writer.hpp"
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace jaguartool {
+	/*
+	 * Single-pass compiler from the Jaguar text format to a Jaguar stream
+	 *
+	 * Values are written as soon as they are parsed; element counts, field counts, and buffer sizes that are only known at the end of a value are patched in afterwards.
+	 * Memory use is therefore bounded by the output buffer and the nesting depth, not by the size of the input.
+	 */
+	class Compiler {
+	  public:
+		Compiler(Lexer& lexer, libjaguar::Writer& writer, PatchableOstream& out);
+
+		//Compile the whole input as a root stream
+		void Compile();
+
+	  private:
+		Lexer& lexer;
+		libjaguar::Writer& writer;
+		PatchableOstream& out;
+		std::unordered_map<std::string, libjaguar::StructuredTypeLayout> types;
+		bool inSubstream;
+
+		void CompileStatements(bool untilBrace);
+		void CompileTypeDeclaration();
+		uint16_t CompileFields(uint8_t depth);
+		void CompileStructuredFields(const libjaguar::StructuredTypeLayout& layout, uint8_t depth);
+		void CompileValue(const TypeSpec& spec, const std::string& name, bool element, uint8_t depth);
+
+		TypeSpec ParseTypeSpec(const Token& first);
+		std::string ParseName(const Token& token);
+		const libjaguar::StructuredTypeLayout& LookupType(const Token& at, const std::string& typeID);
+
+		void WriteNumber(libjaguar::TypeTag type);
+		void WriteBytes(const Token& literal, libjaguar::ValueHeader& header, bool element);
+	};
+
+	//Compile one text file (or "-" for standard input) into one stream file (or "-" for standard output)
+	void CompileFile(const std::filesystem::path& input, const std::filesystem::path& output);
+}
\ No newline at end of file
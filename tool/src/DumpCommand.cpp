@@ -0,0 +1,104 @@
+#include "Commands.hpp"
+#include "Dumper.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace jaguartool {
+	static void PrintDumpUsage() {
+		std::cerr << "Usage: jaguartool dump [options] [INPUT]\n"
+					 "\n"
+					 "Render a Jaguar stream or container as Jaguar text, reading INPUT (defaults to standard input, or '-') front to back.\n"
+					 "The output compiles back to the same stream unless values were truncated or filtered.\n"
+					 "\n"
+					 "Options:\n"
+					 "  -o OUTPUT             Write to OUTPUT instead of standard output\n"
+					 "  --max-bytes N         Show at most N bytes of each byte buffer (default 64, 0 for no limit)\n"
+					 "  --max-string N        Show at most N bytes of each string (default 0, no limit)\n"
+					 "  --max-elements N      Show at most N elements of each list (default 0, no limit)\n"
+					 "  --depth N             Elide the contents of objects and lists nested N or more levels deep\n"
+					 "  --substreams MODE     Render substreams as nested streams ('expand', the default) or as byte buffers ('bytes')\n"
+					 "  --path PATH           Only render values on PATH, e.g. 'config.name', 'points[3]', or 'frames[*].time' (repeatable)\n"
+					 "  --offsets             Annotate each value with its offset in the input\n"
+					 "  --raw                 Never treat the input as a container\n";
+	}
+
+	int RunDump(const std::vector<std::string>& args) {
+		//Parse arguments
+		DumpOptions options;
+		std::string input = "-";
+		std::string output = "-";
+		bool haveInput = false;
+		for(std::size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			const bool takesValue = (arg == "-o" || arg == "--max-bytes" || arg == "--max-string" || arg == "--max-elements" || arg == "--depth" || arg == "--substreams" || arg == "--path");
+			if(takesValue && i + 1 >= args.size()) {
+				PrintDumpUsage();
+				return 2;
+			}
+
+			try {
+				if(arg == "-o") {
+					output = args[++i];
+				} else if(arg == "--max-bytes") {
+					options.maxBytes = std::stoull(args[++i]);
+				} else if(arg == "--max-string") {
+					options.maxString = static_cast<uint32_t>(std::stoul(args[++i]));
+				} else if(arg == "--max-elements") {
+					options.maxElements = static_cast<uint32_t>(std::stoul(args[++i]));
+				} else if(arg == "--depth") {
+					options.maxDepth = static_cast<uint32_t>(std::stoul(args[++i]));
+				} else if(arg == "--substreams") {
+					const std::string& mode = args[++i];
+					if(mode == "expand") {
+						options.substreams = SubstreamMode::Expand;
+					} else if(mode == "bytes") {
+						options.substreams = SubstreamMode::Bytes;
+					} else {
+						PrintDumpUsage();
+						return 2;
+					}
+				} else if(arg == "--path") {
+					options.paths.push_back(args[++i]);
+				} else if(arg == "--offsets") {
+					options.offsets = true;
+				} else if(arg == "--raw") {
+					options.raw = true;
+				} else if(arg == "-h" || arg == "--help") {
+					PrintDumpUsage();
+					return 0;
+				} else if(!haveInput && (arg == "-" || !arg.starts_with("-"))) {
+					input = arg;
+					haveInput = true;
+				} else {
+					PrintDumpUsage();
+					return 2;
+				}
+			} catch(const std::logic_error&) {
+				//Numeric conversion failures
+				PrintDumpUsage();
+				return 2;
+			}
+		}
+
+		//Open the input and output
+		std::unique_ptr<std::ifstream> inFile;
+		if(input != "-") {
+			inFile = std::make_unique<std::ifstream>(input, std::ios::binary);
+			if(!inFile->is_open()) throw std::runtime_error("Failed to open '" + input + "' for reading");
+		}
+		std::unique_ptr<std::ofstream> outFile;
+		if(output != "-") {
+			outFile = std::make_unique<std::ofstream>(output, std::ios::binary | std::ios::trunc);
+			if(!outFile->is_open()) throw std::runtime_error("Failed to open '" + output + "' for writing");
+		}
+		std::istream& in = (inFile ? static_cast<std::istream&>(*inFile) : std::cin);
+		std::ostream& out = (outFile ? static_cast<std::ostream&>(*outFile) : std::cout);
+
+		Dumper dumper(in, out, options);
+		dumper.Dump();
+		if(!out) throw std::runtime_error("Failed to write output");
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,469 @@
+#include "Dumper.hpp"
+#include "TextFormat.hpp"
+
+#include "libjaguar/TypeTags.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+using namespace libjaguar;
+
+namespace jaguartool {
+	constexpr inline std::size_t bytesPerHexLine = 64;
+	constexpr inline std::size_t numbersPerLine = 16;
+
+	static bool IsGenericType(TypeTag type) {
+		return type == TypeTag::Vector || type == TypeTag::Matrix || type == TypeTag::List;
+	}
+
+	static bool IsContainerType(TypeTag type) {
+		return type == TypeTag::List || type == TypeTag::UnstructuredObj || type == TypeTag::StructuredObj || type == TypeTag::Substream;
+	}
+
+	Dumper::Dumper(std::istream& in, std::ostream& out, const DumpOptions& options)
+	  : input(new CountingIstream(in)), reader(std::unique_ptr<std::istream>(input)), out(out), options(options) {
+		//Parse path selectors like "a.b", "points[3].x", "*.name", or "frames[*]"
+		for(const std::string& text : options.paths) {
+			std::vector<PathComponent> selector;
+			std::string current;
+			auto pushName = [&]() {
+				if(current.empty()) return;
+				selector.push_back({current == "*" ? PathComponent::Kind::AnyName : PathComponent::Kind::Name, current, 0});
+				current.clear();
+			};
+			for(std::size_t i = 0; i < text.size(); ++i) {
+				if(text[i] == '.') {
+					pushName();
+				} else if(text[i] == '[') {
+					pushName();
+					std::size_t close = text.find(']', i);
+					if(close == std::string::npos) throw std::runtime_error("Unterminated index in path '" + text + "'");
+					std::string_view index = std::string_view(text).substr(i + 1, close - i - 1);
+					if(index == "*") {
+						selector.push_back({PathComponent::Kind::AnyIndex, "", 0});
+					} else {
+						uint64_t value = 0;
+						auto [end, ec] = std::from_chars(index.data(), index.data() + index.size(), value);
+						if(ec != std::errc() || end != index.data() + index.size()) throw std::runtime_error("Invalid index in path '" + text + "'");
+						selector.push_back({PathComponent::Kind::Index, "", value});
+					}
+					i = close;
+				} else {
+					current.push_back(text[i]);
+				}
+			}
+			pushName();
+			if(!selector.empty()) selectors.push_back(std::move(selector));
+		}
+	}
+
+	void Dumper::Dump() {
+		//Containers start with a 24-byte header
+		if(!options.raw) {
+			if(std::optional<ContainerInfo> container = ReadContainerHeader(*input)) {
+				out << "# Jaguar container (intent " << static_cast<unsigned int>(container->intent) << ", MD5 " << container->hash << ")\n";
+			}
+		}
+
+		DumpStatements(UINT64_MAX, 0, selectors.empty() ? Selection::Full : Selection::Ancestor);
+		out.flush();
+	}
+
+	void Dumper::Indent(uint32_t indent) {
+		for(uint32_t i = 0; i < indent; ++i) out.put('\t');
+	}
+
+	Dumper::Selection Dumper::Select(Selection parent) const {
+		if(parent == Selection::Full || selectors.empty()) return Selection::Full;
+
+		Selection result = Selection::None;
+		for(const std::vector<PathComponent>& selector : selectors) {
+			//Compare the shared prefix of the selector and the current path
+			bool matches = true;
+			for(std::size_t i = 0; i < selector.size() && i < path.size() && matches; ++i) {
+				const PathComponent& want = selector[i];
+				const PathComponent& have = path[i];
+				switch(want.kind) {
+					case PathComponent::Kind::Name: matches = have.kind == PathComponent::Kind::Name && have.name == want.name; break;
+					case PathComponent::Kind::AnyName: matches = have.kind == PathComponent::Kind::Name; break;
+					case PathComponent::Kind::Index: matches = have.kind == PathComponent::Kind::Index && have.index == want.index; break;
+					case PathComponent::Kind::AnyIndex: matches = have.kind == PathComponent::Kind::Index; break;
+				}
+			}
+			if(!matches) continue;
+			if(selector.size() <= path.size()) return Selection::Full;
+			result = Selection::Ancestor;
+		}
+		return result;
+	}
+
+	void Dumper::DumpStatements(uint64_t end, uint32_t indent, Selection selection) {
+		while(true) {
+			//The root runs to EOF, substreams run to their size
+			if(end == UINT64_MAX) {
+				if(reader->peek() == std::char_traits<char>::eof()) break;
+			} else if(input->Position() >= end) {
+				break;
+			}
+
+			const uint64_t offset = input->Position();
+			ValueHeader header = reader.ReadHeader();
+			if(header.type == TypeTag::ScopeBoundary) throw std::runtime_error("Unexpected scope boundary at offset " + std::to_string(offset));
+
+			if(header.type == TypeTag::StructuredObjTypeDecl) {
+				if(selection == Selection::Full) {
+					if(options.offsets) {
+						Indent(indent);
+						out << "# @" << offset << "\n";
+					}
+					DumpTypeDeclaration(header, indent);
+				} else {
+					reader.ReadTypeDeclaration(header);
+				}
+				continue;
+			}
+
+			path.push_back({PathComponent::Kind::Name, std::string(header.name), 0});
+			Selection valueSelection = Select(selection);
+			if(valueSelection != Selection::None && options.offsets) {
+				Indent(indent);
+				out << "# @" << offset << "\n";
+			}
+			DumpNamedValue(header, indent, valueSelection);
+			path.pop_back();
+		}
+	}
+
+	void Dumper::DumpTypeDeclaration(const ValueHeader& header, uint32_t indent) {
+		StructuredTypeLayout layout = reader.ReadTypeDeclaration(header);
+		Indent(indent);
+		out << "type " << FormatName(layout.typeID) << " {\n";
+		for(const StructuredTypeLayout::Field& field : layout.fields) {
+			//Describe the field the same way as a value header
+			ValueHeader fieldHeader = {};
+			fieldHeader.type = field.type;
+			fieldHeader.elementType = field.elementType;
+			fieldHeader.width = field.width;
+			fieldHeader.height = field.height;
+			fieldHeader.typeID = field.elementTypeID;
+			Indent(indent + 1);
+			out << TypeSpecOf(fieldHeader, {}) << " " << FormatName(field.name) << ";\n";
+		}
+		Indent(indent);
+		out << "}\n";
+	}
+
+	void Dumper::DumpNamedValue(const ValueHeader& header, uint32_t indent, Selection selection) {
+		//Skip values that aren't selected, and scalars that merely share a prefix with a selector
+		if(selection == Selection::None || (selection == Selection::Ancestor && !IsContainerType(header.type))) {
+			reader.SkipBody(header);
+			return;
+		}
+
+		//Generic list elements carry their own headers, so the first ones are needed to describe the list type
+		std::vector<ValueHeader> chain;
+		if(header.type == TypeTag::List) chain = ReadElementChain(header);
+
+		Indent(indent);
+		out << TypeSpecOf(header, chain) << " " << FormatName(header.name) << " = ";
+		std::string comment = DumpLiteral(header, indent, selection, chain);
+		out << ";";
+		if(!comment.empty()) out << " # " << comment;
+		out << "\n";
+	}
+
+	std::string Dumper::DumpLiteral(const ValueHeader& header, uint32_t indent, Selection selection, std::span<const ValueHeader> chain) {
+		switch(header.type) {
+			case TypeTag::String: return DumpString(header.size);
+			case TypeTag::ByteBuffer: return DumpBytes(header.size, options.maxBytes);
+			case TypeTag::Substream:
+				if(options.substreams == SubstreamMode::Bytes) return DumpBytes(header.size, options.maxBytes);
+				return DumpSubstream(header.size, indent, selection);
+			case TypeTag::Boolean:
+				out << (reader.ReadBool() ? "true" : "false");
+				return {};
+			case TypeTag::Vector:
+				out << "(";
+				for(uint8_t i = 0; i < header.width; ++i) {
+					if(i > 0) out << ", ";
+					DumpNumber(header.elementType);
+				}
+				out << ")";
+				return {};
+			case TypeTag::Matrix:
+				out << "(";
+				for(uint8_t col = 0; col < header.width; ++col) {
+					out << (col > 0 ? ", (" : "(");
+					for(uint8_t row = 0; row < header.height; ++row) {
+						if(row > 0) out << ", ";
+						DumpNumber(header.elementType);
+					}
+					out << ")";
+				}
+				out << ")";
+				return {};
+			case TypeTag::List: return DumpList(header, indent, selection, chain);
+			case TypeTag::UnstructuredObj:
+			case TypeTag::StructuredObj:
+				if(indent >= options.maxDepth) {
+					out << "{}";
+					reader.SkipBody(header);
+					return "fields elided";
+				}
+				return DumpObjectBody(indent, selection);
+			default:
+				DumpNumber(header.type);
+				return {};
+		}
+	}
+
+	std::string Dumper::DumpObjectBody(uint32_t indent, Selection selection) {
+		out << "{\n";
+		while(true) {
+			const uint64_t offset = input->Position();
+			ValueHeader field = reader.ReadHeader();
+			if(field.type == TypeTag::ScopeBoundary) break;
+			if(field.type == TypeTag::StructuredObjTypeDecl) throw std::runtime_error("Type declaration inside an object at offset " + std::to_string(offset));
+
+			path.push_back({PathComponent::Kind::Name, std::string(field.name), 0});
+			Selection fieldSelection = Select(selection);
+			if(fieldSelection != Selection::None && options.offsets) {
+				Indent(indent + 1);
+				out << "# @" << offset << "\n";
+			}
+			DumpNamedValue(field, indent + 1, fieldSelection);
+			path.pop_back();
+		}
+		Indent(indent);
+		out << "}";
+		return selection == Selection::Full ? std::string() : std::string("filtered");
+	}
+
+	std::string Dumper::DumpList(const ValueHeader& header, uint32_t indent, Selection selection, std::span<const ValueHeader> chain) {
+		if(indent >= options.maxDepth) {
+			out << "[]";
+			SkipValue(header, chain);
+			return std::to_string(header.size) + (header.size == 1 ? " element elided" : " elements elided");
+		}
+
+		//Numbers and booleans go on as few lines as possible; everything else gets one line per element
+		const bool compact = IsMathElementType(header.elementType) || header.elementType == TypeTag::Boolean;
+		const uint64_t shown = (options.maxElements > 0 && header.size > options.maxElements) ? options.maxElements : header.size;
+		uint64_t printed = 0;
+		out << "[";
+		for(uint64_t i = 0; i < header.size; ++i) {
+			//Skip whatever is beyond the element limit in one go
+			if(i == shown) {
+				ValueHeader rest = header;
+				rest.size = static_cast<uint32_t>(header.size - i);
+				reader.SkipBody(rest);
+				break;
+			}
+
+			//Get this element's header (the first one may already have been read)
+			ValueHeader element;
+			std::span<const ValueHeader> subchain;
+			if(i == 0 && !chain.empty()) {
+				element = chain[0];
+				subchain = chain.subspan(1);
+			} else {
+				element = reader.ReadElementHeader(header.elementType);
+			}
+			if(element.type == TypeTag::StructuredObj) element.typeID = header.typeID;
+
+			path.push_back({PathComponent::Kind::Index, "", i});
+			Selection elementSelection = Select(selection);
+			if(elementSelection == Selection::None || (elementSelection == Selection::Ancestor && !IsContainerType(element.type))) {
+				SkipValue(element, subchain);
+				path.pop_back();
+				continue;
+			}
+
+			if(compact) {
+				if(printed > 0) out << ", ";
+				if(printed > 0 && printed % numbersPerLine == 0) {
+					out << "\n";
+					Indent(indent + 1);
+				}
+				DumpLiteral(element, indent + 1, elementSelection, subchain);
+			} else {
+				out << "\n";
+				Indent(indent + 1);
+				std::string comment = DumpLiteral(element, indent + 1, elementSelection, subchain);
+				if(selection != Selection::Full) comment = "[" + std::to_string(i) + "]" + (comment.empty() ? "" : " " + comment);
+				out << ",";
+				if(!comment.empty()) out << " # " << comment;
+			}
+			++printed;
+			path.pop_back();
+		}
+		if(!compact && printed > 0) {
+			out << "\n";
+			Indent(indent);
+		}
+		out << "]";
+
+		if(shown < header.size) return "showing " + std::to_string(shown) + " of " + std::to_string(header.size) + " elements";
+		if(selection != Selection::Full) return "filtered";
+		return {};
+	}
+
+	std::string Dumper::DumpString(uint32_t size) {
+		if(options.maxString == 0 || size <= options.maxString) {
+			out << QuoteString(reader.ReadString(size));
+			return {};
+		}
+
+		//Read only the preview and discard the rest
+		std::vector<unsigned char> preview(options.maxString);
+		{
+			SVHandle view = reader.ReadBuffer(size);
+			view->Read(preview, options.maxString);
+			view->DiscardAll();
+		}
+
+		//Don't cut a UTF-8 sequence in half
+		std::size_t length = preview.size();
+		std::size_t lead = length;
+		while(lead > 0 && (preview[lead - 1] & 0b1100'0000) == 0b1000'0000) --lead;
+		if(lead > 0) {
+			unsigned char byte = preview[lead - 1];
+			std::size_t sequence = (byte & 0b1000'0000) == 0 ? 1 : (byte & 0b1110'0000) == 0b1100'0000 ? 2 : (byte & 0b1111'0000) == 0b1110'0000 ? 3 : 4;
+			if(lead - 1 + sequence > length) length = lead - 1;
+		}
+		out << QuoteString(std::string_view(reinterpret_cast<const char*>(preview.data()), length));
+		return "truncated: showing " + std::to_string(length) + " of " + std::to_string(size) + " bytes";
+	}
+
+	std::string Dumper::DumpBytes(uint32_t size, uint64_t limit) {
+		static constexpr char hexDigits[] = "0123456789ABCDEF";
+		const uint64_t shown = (limit == 0 || size <= limit) ? size : limit;
+		out << "x\"";
+		if(size > 0) {
+			SVHandle view = reader.ReadBuffer(size);
+			std::vector<unsigned char> chunk(std::min<uint64_t>(shown, 64 * 1024));
+			std::string line;
+			uint64_t done = 0;
+			while(done < shown) {
+				const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(chunk.size(), shown - done));
+				view->Read(chunk, count);
+				for(uint32_t i = 0; i < count; ++i) {
+					if(done + i > 0 && (done + i) % bytesPerHexLine == 0) line.push_back('\n');
+					line.push_back(hexDigits[chunk[i] >> 4]);
+					line.push_back(hexDigits[chunk[i] & 0xF]);
+				}
+				out << line;
+				line.clear();
+				done += count;
+			}
+			if(shown < size) view->DiscardAll();
+		}
+		out << "\"";
+		if(shown < size) return "truncated: showing " + std::to_string(shown) + " of " + std::to_string(size) + " bytes";
+		return {};
+	}
+
+	std::string Dumper::DumpSubstream(uint32_t size, uint32_t indent, Selection selection) {
+		const uint64_t end = input->Position() + size;
+		out << "{\n";
+		std::string comment;
+		try {
+			DumpStatements(end, indent + 1, selection);
+			if(input->Position() != end) throw std::runtime_error("Substream contents overrun the substream size");
+		} catch(const std::exception& e) {
+			//A broken substream doesn't break the containing stream, as long as we can get back to its end
+			std::istream* raw = *reader;
+			if(!raw || !raw->good() || input->Position() > end) throw;
+			raw->ignore(end - input->Position());
+			Indent(indent + 1);
+			out << "# invalid substream: " << e.what() << "\n";
+			comment = "invalid";
+		}
+		Indent(indent);
+		out << "}";
+		return comment;
+	}
+
+	void Dumper::DumpNumber(TypeTag type) {
+		char buffer[64];
+		std::to_chars_result result = {buffer, std::errc()};
+		auto formatFloat = [&](auto value) {
+			if(std::isnan(value)) {
+				out << "nan";
+			} else if(std::isinf(value)) {
+				out << (value < 0 ? "-inf" : "inf");
+			} else {
+				result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+				out.write(buffer, result.ptr - buffer);
+			}
+		};
+		auto formatInteger = [&](auto value) {
+			result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.write(buffer, result.ptr - buffer);
+		};
+
+		switch(type) {
+			case TypeTag::Float32: formatFloat(reader.ReadFloat<float>()); break;
+			case TypeTag::Float64: formatFloat(reader.ReadFloat<double>()); break;
+			case TypeTag::SInt8: formatInteger(reader.ReadInteger<int8_t>()); break;
+			case TypeTag::SInt16: formatInteger(reader.ReadInteger<int16_t>()); break;
+			case TypeTag::SInt32: formatInteger(reader.ReadInteger<int32_t>()); break;
+			case TypeTag::SInt64: formatInteger(reader.ReadInteger<int64_t>()); break;
+			case TypeTag::UInt8: formatInteger(reader.ReadInteger<uint8_t>()); break;
+			case TypeTag::UInt16: formatInteger(reader.ReadInteger<uint16_t>()); break;
+			case TypeTag::UInt32: formatInteger(reader.ReadInteger<uint32_t>()); break;
+			case TypeTag::UInt64: formatInteger(reader.ReadInteger<uint64_t>()); break;
+			case TypeTag::Boolean: out << (reader.ReadBool() ? "true" : "false"); break;
+			default: throw std::runtime_error("Vectors and matrices may only contain numbers");
+		}
+	}
+
+	std::vector<ValueHeader> Dumper::ReadElementChain(const ValueHeader& list) {
+		std::vector<ValueHeader> chain;
+		ValueHeader current = list;
+		while(current.type == TypeTag::List && current.size > 0 && IsGenericType(current.elementType)) {
+			current = reader.ReadElementHeader(current.elementType);
+			chain.push_back(current);
+		}
+		return chain;
+	}
+
+	std::string Dumper::TypeSpecOf(const ValueHeader& header, std::span<const ValueHeader> chain) {
+		switch(header.type) {
+			case TypeTag::Vector: return "vec" + std::to_string(header.width) + "<" + std::string(ScalarKeywordOf(header.elementType)) + ">";
+			case TypeTag::Matrix: return "mat" + std::to_string(header.width) + "x" + std::to_string(header.height) + "<" + std::string(ScalarKeywordOf(header.elementType)) + ">";
+			case TypeTag::UnstructuredObj: return "object";
+			case TypeTag::StructuredObj: return "object<" + FormatName(header.typeID) + ">";
+			case TypeTag::List: {
+				//Generic element shapes come from the first element; empty lists get a placeholder (which encodes identically)
+				if(IsGenericType(header.elementType)) {
+					if(!chain.empty()) return "list<" + TypeSpecOf(chain[0], chain.subspan(1)) + ">";
+					if(header.elementType == TypeTag::Vector) return "list<vec2<u8>>";
+					if(header.elementType == TypeTag::Matrix) return "list<mat2x2<u8>>";
+					return "list<list<u8>>";
+				}
+				ValueHeader element = {};
+				element.type = header.elementType;
+				element.typeID = header.typeID;
+				return "list<" + TypeSpecOf(element, {}) + ">";
+			}
+			default: return std::string(ScalarKeywordOf(header.type));
+		}
+	}
+
+	void Dumper::SkipValue(const ValueHeader& header, std::span<const ValueHeader> chain) {
+		if(chain.empty()) {
+			reader.SkipBody(header);
+			return;
+		}
+
+		//The first element's header was already consumed
+		SkipValue(chain[0], chain.subspan(1));
+		if(header.size > 1) {
+			ValueHeader rest = header;
+			rest.size = header.size - 1;
+			reader.SkipBody(rest);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "InputBuffer.hpp"
+
+#include "libjaguar/Reader.hpp"
+#include "libjaguar/ValueHeader.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace jaguartool {
+	enum class SubstreamMode {
+		Expand,//Render substreams as nested streams
+		Bytes  //Render substreams as byte literals (subject to the byte preview limit)
+	};
+
+	struct DumpOptions {
+		uint64_t maxBytes = 64;					  //Bytes shown for byte buffers before truncating (0 for no limit)
+		uint32_t maxString = 0;					  //Bytes shown for strings before truncating (0 for no limit)
+		uint32_t maxElements = 0;				  //Elements shown per list before truncating (0 for no limit)
+		uint32_t maxDepth = UINT32_MAX;			  //Deepest object or list level to render
+		SubstreamMode substreams = SubstreamMode::Expand;
+		bool offsets = false;					  //Annotate values with their stream offsets
+		bool raw = false;						  //Never treat the input as a container
+		std::vector<std::string> paths;			  //Only render values on these paths (all values if empty)
+	};
+
+	/*
+	 * Pull-based renderer from a Jaguar stream (or container) to the text format
+	 *
+	 * The input is read strictly front to back and nothing is indexed, so memory use does not depend on the input size. Large values are previewed
+	 * and skipped rather than read into memory.
+	 */
+	class Dumper {
+	  public:
+		Dumper(std::istream& in, std::ostream& out, const DumpOptions& options);
+
+		void Dump();
+
+	  private:
+		//One step of a value path: a field name or a list index
+		struct PathComponent {
+			enum class Kind {
+				Name,
+				Index,
+				AnyName,
+				AnyIndex
+			} kind;
+			std::string name;
+			uint64_t index;
+		};
+
+		enum class Selection {
+			None,	 //Not on any selected path
+			Ancestor,//Contains selected values
+			Full	 //Selected in full
+		};
+
+		CountingIstream* input;
+		libjaguar::Reader reader;
+		std::ostream& out;
+		DumpOptions options;
+		std::vector<std::vector<PathComponent>> selectors;
+		std::vector<PathComponent> path;
+
+		void DumpStatements(uint64_t end, uint32_t indent, Selection selection);
+		void DumpTypeDeclaration(const libjaguar::ValueHeader& header, uint32_t indent);
+		void DumpNamedValue(const libjaguar::ValueHeader& header, uint32_t indent, Selection selection);
+		std::string DumpLiteral(const libjaguar::ValueHeader& header, uint32_t indent, Selection selection, std::span<const libjaguar::ValueHeader> chain);
+		std::string DumpObjectBody(uint32_t indent, Selection selection);
+		std::string DumpList(const libjaguar::ValueHeader& header, uint32_t indent, Selection selection, std::span<const libjaguar::ValueHeader> chain);
+		std::string DumpBytes(uint32_t size, uint64_t limit);
+		std::string DumpString(uint32_t size);
+		std::string DumpSubstream(uint32_t size, uint32_t indent, Selection selection);
+		void DumpNumber(libjaguar::TypeTag type);
+
+		std::vector<libjaguar::ValueHeader> ReadElementChain(const libjaguar::ValueHeader& list);
+		std::string TypeSpecOf(const libjaguar::ValueHeader& header, std::span<const libjaguar::ValueHeader> chain);
+		void SkipValue(const libjaguar::ValueHeader& header, std::span<const libjaguar::ValueHeader> chain);
+
+		Selection Select(Selection parent) const;
+		void Indent(uint32_t indent);
+	};
+}
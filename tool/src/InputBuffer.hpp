@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jaguartool {
+	constexpr inline std::size_t inputBufferSize = 256 * 1024;//256 KiB
+
+	/*
+	 * Forward-only input buffer that tracks the absolute position in the source
+	 *
+	 * This allows positions to be reported (and substream bounds to be tracked) even when reading from a pipe, and lets the first bytes of the input
+	 * be inspected before any of them are consumed.
+	 */
+	class CountingStreambuf : public std::streambuf {
+	  public:
+		CountingStreambuf(std::istream& source) : source(source), buffer(inputBufferSize), consumed(0) {
+			setg(buffer.data(), buffer.data(), buffer.data());
+		}
+
+		//Absolute position of the next byte to be read
+		uint64_t Position() const {
+			return consumed + (gptr() - eback());
+		}
+
+		//View up to the next count bytes without consuming them (fewer are returned only at EOF)
+		std::string_view PeekAhead(std::size_t count) {
+			count = std::min(count, buffer.size());
+			if(static_cast<std::size_t>(egptr() - gptr()) < count) {
+				//Move the unread bytes to the front and top up the buffer
+				const std::size_t unread = egptr() - gptr();
+				consumed += gptr() - eback();
+				std::memmove(buffer.data(), gptr(), unread);
+				std::size_t filled = unread;
+				while(filled < count) {
+					source.read(buffer.data() + filled, buffer.size() - filled);
+					if(source.gcount() == 0) break;
+					filled += static_cast<std::size_t>(source.gcount());
+				}
+				setg(buffer.data(), buffer.data(), buffer.data() + filled);
+			}
+			return std::string_view(gptr(), std::min<std::size_t>(count, egptr() - gptr()));
+		}
+
+	  protected:
+		int_type underflow() override {
+			consumed += egptr() - eback();
+			source.read(buffer.data(), buffer.size());
+			const std::streamsize got = source.gcount();
+			setg(buffer.data(), buffer.data(), buffer.data() + got);
+			return got > 0 ? traits_type::to_int_type(buffer[0]) : traits_type::eof();
+		}
+
+		std::streamsize showmanyc() override {
+			return egptr() - gptr();
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			//Only position queries are supported
+			if(off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::in)) return pos_type(off_type(-1));
+			return pos_type(static_cast<off_type>(Position()));
+		}
+
+	  private:
+		std::istream& source;
+		std::vector<char> buffer;
+		uint64_t consumed;
+	};
+
+	class CountingIstream : public std::istream {
+	  public:
+		CountingIstream(std::istream& source) : std::istream(nullptr), buf(source) {
+			init(&buf);
+		}
+
+		uint64_t Position() const {
+			return buf.Position();
+		}
+
+		std::string_view PeekAhead(std::size_t count) {
+			return buf.PeekAhead(count);
+		}
+
+	  private:
+		CountingStreambuf buf;
+	};
+
+	//Intent and integrity hash from a container header
+	struct ContainerInfo {
+		uint8_t intent;
+		std::string hash;//MD5 as lowercase hex
+	};
+
+	//Consume the 24-byte container header (magic, intent byte, null separator, and MD5 hash) if the input starts with one
+	inline std::optional<ContainerInfo> ReadContainerHeader(CountingIstream& input) {
+		std::string_view head = input.PeekAhead(24);
+		if(head.size() != 24 || !head.starts_with("JAGUAR") || head[7] != '\0') return std::nullopt;
+
+		static constexpr char hexDigits[] = "0123456789abcdef";
+		ContainerInfo info = {static_cast<uint8_t>(head[6]), {}};
+		for(char c : head.substr(8)) {
+			info.hash.push_back(hexDigits[(static_cast<unsigned char>(c) >> 4) & 0xF]);
+			info.hash.push_back(hexDigits[static_cast<unsigned char>(c) & 0xF]);
+		}
+		input.ignore(24);
+		return info;
+	}
+}
\ No newline at end of file
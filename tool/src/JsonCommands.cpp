@@ -0,0 +1,174 @@
+#include "Commands.hpp"
+#include "JsonExporter.hpp"
+#include "JsonImporter.hpp"
+#include "TextFormat.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+using namespace libjaguar;
+
+namespace jaguartool {
+	static void PrintFromJsonUsage() {
+		std::cerr << "Usage: jaguartool from-json [options] [INPUT]\n"
+					 "\n"
+					 "Convert a JSON document into a Jaguar stream in a single streaming pass. INPUT defaults to standard input (or '-').\n"
+					 "A root object's fields become root values; any other root value is stored under the root name.\n"
+					 "\n"
+					 "Options:\n"
+					 "  -o OUTPUT             Write to OUTPUT (defaults to the input with a .jag extension, or standard output for '-')\n"
+					 "  --int TYPE            Type for integral numbers: i8, i16, i32, i64 (default), u8, u16, u32, u64, or 'auto' for the narrowest\n"
+					 "                        signed type that fits\n"
+					 "  --float TYPE          Type for numbers with a fraction or exponent: f32 or f64 (default)\n"
+					 "  --numbers MODE        'auto' (default) types integral numbers with --int, 'float' types every number with --float\n"
+					 "  --vectors             Store arrays of 2 to 4 numbers as vectors instead of lists\n"
+					 "  --lookahead N         Number of leading array elements used to pick a number array's element type (default 65536)\n"
+					 "  --nulls MODE          'skip' (default) leaves out null fields, 'error' rejects them\n"
+					 "  --root-name NAME      Name for a root value that is not an object (default 'root')\n";
+	}
+
+	static void PrintToJsonUsage() {
+		std::cerr << "Usage: jaguartool to-json [options] [INPUT]\n"
+					 "\n"
+					 "Convert a Jaguar stream or container into a JSON document in a single streaming pass. INPUT defaults to standard input (or '-').\n"
+					 "\n"
+					 "Options:\n"
+					 "  -o OUTPUT             Write to OUTPUT instead of standard output\n"
+					 "  --indent N            Pretty-print with N spaces per level (default 0, compact)\n"
+					 "  --bytes ENCODING      Encoding for byte buffers: base64 (default) or hex\n"
+					 "  --raw                 Never treat the input as a container\n";
+	}
+
+	int RunFromJson(const std::vector<std::string>& args) {
+		//Parse arguments
+		JsonImportOptions options;
+		std::filesystem::path input = "-";
+		std::filesystem::path output;
+		bool haveInput = false;
+		for(std::size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			const bool takesValue = (arg == "-o" || arg == "--int" || arg == "--float" || arg == "--numbers" || arg == "--lookahead" || arg == "--nulls" || arg == "--root-name");
+			if(takesValue && i + 1 >= args.size()) {
+				PrintFromJsonUsage();
+				return 2;
+			}
+
+			if(arg == "-o") {
+				output = args[++i];
+			} else if(arg == "--int") {
+				const std::string& type = args[++i];
+				std::optional<TypeTag> tag = LookupScalarKeyword(type);
+				if(type == "auto") {
+					options.narrowIntegers = true;
+				} else if(tag && IsMathElementType(*tag) && *tag != TypeTag::Float32 && *tag != TypeTag::Float64) {
+					options.integerType = *tag;
+				} else {
+					PrintFromJsonUsage();
+					return 2;
+				}
+			} else if(arg == "--float") {
+				const std::string& type = args[++i];
+				if(type != "f32" && type != "f64") {
+					PrintFromJsonUsage();
+					return 2;
+				}
+				options.floatType = (type == "f32" ? TypeTag::Float32 : TypeTag::Float64);
+			} else if(arg == "--numbers") {
+				const std::string& mode = args[++i];
+				if(mode != "auto" && mode != "float") {
+					PrintFromJsonUsage();
+					return 2;
+				}
+				options.integersAsFloats = (mode == "float");
+			} else if(arg == "--lookahead") {
+				try {
+					options.lookahead = static_cast<uint32_t>(std::stoul(args[++i]));
+				} catch(...) {
+					PrintFromJsonUsage();
+					return 2;
+				}
+			} else if(arg == "--nulls") {
+				const std::string& mode = args[++i];
+				if(mode != "skip" && mode != "error") {
+					PrintFromJsonUsage();
+					return 2;
+				}
+				options.nulls = (mode == "error" ? JsonNullMode::Error : JsonNullMode::Skip);
+			} else if(arg == "--root-name") {
+				options.rootName = args[++i];
+			} else if(arg == "--vectors") {
+				options.vectors = true;
+			} else if(arg == "-h" || arg == "--help") {
+				PrintFromJsonUsage();
+				return 0;
+			} else if(!haveInput && (arg == "-" || !arg.starts_with("-"))) {
+				input = arg;
+				haveInput = true;
+			} else {
+				PrintFromJsonUsage();
+				return 2;
+			}
+		}
+		if(output.empty()) output = (input == "-" ? std::filesystem::path("-") : std::filesystem::path(input).replace_extension(".jag"));
+
+		try {
+			ImportJsonFile(input, output, options);
+		} catch(...) {
+			//Don't leave a partial output behind
+			if(output != "-") {
+				std::error_code ec;
+				std::filesystem::remove(output, ec);
+			}
+			throw;
+		}
+		return 0;
+	}
+
+	int RunToJson(const std::vector<std::string>& args) {
+		//Parse arguments
+		JsonExportOptions options;
+		std::string input = "-";
+		std::string output = "-";
+		bool haveInput = false;
+		for(std::size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			const bool takesValue = (arg == "-o" || arg == "--indent" || arg == "--bytes");
+			if(takesValue && i + 1 >= args.size()) {
+				PrintToJsonUsage();
+				return 2;
+			}
+
+			if(arg == "-o") {
+				output = args[++i];
+			} else if(arg == "--indent") {
+				try {
+					options.indent = static_cast<uint32_t>(std::stoul(args[++i]));
+				} catch(...) {
+					PrintToJsonUsage();
+					return 2;
+				}
+			} else if(arg == "--bytes") {
+				const std::string& encoding = args[++i];
+				if(encoding != "base64" && encoding != "hex") {
+					PrintToJsonUsage();
+					return 2;
+				}
+				options.bytes = (encoding == "hex" ? JsonBytesEncoding::Hex : JsonBytesEncoding::Base64);
+			} else if(arg == "--raw") {
+				options.raw = true;
+			} else if(arg == "-h" || arg == "--help") {
+				PrintToJsonUsage();
+				return 0;
+			} else if(!haveInput && (arg == "-" || !arg.starts_with("-"))) {
+				input = arg;
+				haveInput = true;
+			} else {
+				PrintToJsonUsage();
+				return 2;
+			}
+		}
+
+		ExportJsonFile(input, output, options);
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "JsonExporter.hpp"
+
+#include "libjaguar/TypeTags.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace libjaguar;
+
+namespace jaguartool {
+	//Byte buffers are encoded in chunks of this many bytes (a multiple of 3 so base64 needs no padding between chunks)
+	constexpr inline uint32_t bytesChunkSize = 48 * 1024;
+
+	JsonExporter::JsonExporter(std::istream& in, std::ostream& out, const JsonExportOptions& options)
+	  : input(new CountingIstream(in)), reader(std::unique_ptr<std::istream>(input)), out(out), options(options) {}
+
+	void JsonExporter::Export() {
+		if(!options.raw) ReadContainerHeader(*input);
+
+		out.put('{');
+		ExportMembers(UINT64_MAX, 1, false);
+		out.put('}');
+		if(options.indent > 0) out.put('\n');
+		out.flush();
+	}
+
+	void JsonExporter::NewLine(uint32_t depth) {
+		if(options.indent == 0) return;
+		out.put('\n');
+		for(uint64_t i = 0; i < uint64_t(depth) * options.indent; ++i) out.put(' ');
+	}
+
+	void JsonExporter::ExportMembers(uint64_t end, uint32_t depth, bool object) {
+		bool first = true;
+		while(true) {
+			//Objects run to their boundary, the root to EOF, and substreams to their size
+			if(!object) {
+				if(end == UINT64_MAX) {
+					if(reader->peek() == std::char_traits<char>::eof()) break;
+				} else if(input->Position() >= end) {
+					break;
+				}
+			}
+
+			ValueHeader header = reader.ReadHeader();
+			if(header.type == TypeTag::ScopeBoundary) {
+				if(object) break;
+				throw std::runtime_error("Unexpected scope boundary");
+			}
+			if(header.type == TypeTag::StructuredObjTypeDecl) {
+				if(object) throw std::runtime_error("Type declaration inside an object");
+				reader.ReadTypeDeclaration(header);
+				continue;
+			}
+
+			if(!first) out.put(',');
+			first = false;
+			NewLine(depth);
+			WriteQuoted(header.name);
+			out << (options.indent > 0 ? ": " : ":");
+			ExportValue(header, depth);
+		}
+		if(!first) NewLine(depth - 1);
+	}
+
+	void JsonExporter::ExportValue(const ValueHeader& header, uint32_t depth) {
+		switch(header.type) {
+			case TypeTag::String: ExportString(header.size); break;
+			case TypeTag::ByteBuffer: ExportBytes(header.size); break;
+			case TypeTag::Substream:
+				out.put('{');
+				ExportMembers(input->Position() + header.size, depth + 1, false);
+				out.put('}');
+				break;
+			case TypeTag::Boolean: out << (reader.ReadBool() ? "true" : "false"); break;
+			case TypeTag::Vector:
+				out.put('[');
+				for(uint8_t i = 0; i < header.width; ++i) {
+					if(i > 0) out.put(',');
+					ExportNumber(header.elementType);
+				}
+				out.put(']');
+				break;
+			case TypeTag::Matrix:
+				//Column-major, matching the storage order
+				out.put('[');
+				for(uint8_t col = 0; col < header.width; ++col) {
+					out << (col > 0 ? ",[" : "[");
+					for(uint8_t row = 0; row < header.height; ++row) {
+						if(row > 0) out.put(',');
+						ExportNumber(header.elementType);
+					}
+					out.put(']');
+				}
+				out.put(']');
+				break;
+			case TypeTag::List: {
+				//Scalars stay on one line; containers get a line each
+				const bool multiline = header.elementType == TypeTag::List || header.elementType == TypeTag::UnstructuredObj || header.elementType == TypeTag::StructuredObj ||
+									   header.elementType == TypeTag::String || header.elementType == TypeTag::ByteBuffer || header.elementType == TypeTag::Substream;
+				out.put('[');
+				for(uint32_t i = 0; i < header.size; ++i) {
+					if(i > 0) out.put(',');
+					if(multiline) NewLine(depth + 1);
+					ExportValue(reader.ReadElementHeader(header.elementType), depth + 1);
+				}
+				if(multiline && header.size > 0) NewLine(depth);
+				out.put(']');
+				break;
+			}
+			case TypeTag::UnstructuredObj:
+			case TypeTag::StructuredObj:
+				out.put('{');
+				ExportMembers(0, depth + 1, true);
+				out.put('}');
+				break;
+			default: ExportNumber(header.type); break;
+		}
+	}
+
+	void JsonExporter::ExportNumber(TypeTag type) {
+		char buffer[64];
+		auto writeFloat = [&](auto value) {
+			//JSON has no representation for infinities and NaN
+			if(!std::isfinite(value)) {
+				out << "null";
+				return;
+			}
+			std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.write(buffer, result.ptr - buffer);
+		};
+		auto writeInteger = [&](auto value) {
+			std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.write(buffer, result.ptr - buffer);
+		};
+
+		switch(type) {
+			case TypeTag::Float32: writeFloat(reader.ReadFloat<float>()); break;
+			case TypeTag::Float64: writeFloat(reader.ReadFloat<double>()); break;
+			case TypeTag::SInt8: writeInteger(reader.ReadInteger<int8_t>()); break;
+			case TypeTag::SInt16: writeInteger(reader.ReadInteger<int16_t>()); break;
+			case TypeTag::SInt32: writeInteger(reader.ReadInteger<int32_t>()); break;
+			case TypeTag::SInt64: writeInteger(reader.ReadInteger<int64_t>()); break;
+			case TypeTag::UInt8: writeInteger(reader.ReadInteger<uint8_t>()); break;
+			case TypeTag::UInt16: writeInteger(reader.ReadInteger<uint16_t>()); break;
+			case TypeTag::UInt32: writeInteger(reader.ReadInteger<uint32_t>()); break;
+			case TypeTag::UInt64: writeInteger(reader.ReadInteger<uint64_t>()); break;
+			case TypeTag::Boolean: out << (reader.ReadBool() ? "true" : "false"); break;
+			default: throw std::runtime_error("Vectors and matrices may only contain numbers");
+		}
+	}
+
+	void JsonExporter::ExportString(uint32_t size) {
+		WriteQuoted(reader.ReadString(size));
+	}
+
+	void JsonExporter::ExportBytes(uint32_t size) {
+		static constexpr char base64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		static constexpr char hexDigits[] = "0123456789abcdef";
+
+		out.put('"');
+		if(size > 0) {
+			SVHandle view = reader.ReadBuffer(size);
+			std::vector<unsigned char> chunk(std::min(size, bytesChunkSize));
+			std::string encoded;
+			uint32_t done = 0;
+			while(done < size) {
+				const uint32_t count = std::min<uint32_t>(static_cast<uint32_t>(chunk.size()), size - done);
+				view->Read(chunk, count);
+				encoded.clear();
+				if(options.bytes == JsonBytesEncoding::Hex) {
+					for(uint32_t i = 0; i < count; ++i) {
+						encoded.push_back(hexDigits[chunk[i] >> 4]);
+						encoded.push_back(hexDigits[chunk[i] & 0xF]);
+					}
+				} else {
+					for(uint32_t i = 0; i < count; i += 3) {
+						const uint32_t remaining = count - i;
+						const uint32_t triple = (uint32_t(chunk[i]) << 16) | (remaining > 1 ? uint32_t(chunk[i + 1]) << 8 : 0) | (remaining > 2 ? uint32_t(chunk[i + 2]) : 0);
+						encoded.push_back(base64Digits[(triple >> 18) & 0x3F]);
+						encoded.push_back(base64Digits[(triple >> 12) & 0x3F]);
+						encoded.push_back(remaining > 1 ? base64Digits[(triple >> 6) & 0x3F] : '=');
+						encoded.push_back(remaining > 2 ? base64Digits[triple & 0x3F] : '=');
+					}
+				}
+				out << encoded;
+				done += count;
+			}
+		}
+		out.put('"');
+	}
+
+	void JsonExporter::WriteQuoted(std::string_view text) {
+		static constexpr char hexDigits[] = "0123456789abcdef";
+		out.put('"');
+
+		//Write runs of characters that need no escaping in one go
+		std::size_t runStart = 0;
+		for(std::size_t i = 0; i < text.size(); ++i) {
+			const unsigned char c = static_cast<unsigned char>(text[i]);
+			if(c >= 0x20 && c != '"' && c != '\\') continue;
+			out.write(text.data() + runStart, i - runStart);
+			runStart = i + 1;
+			switch(c) {
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\r': out << "\\r"; break;
+				case '\t': out << "\\t"; break;
+				case '\b': out << "\\b"; break;
+				case '\f': out << "\\f"; break;
+				default: {
+					const char escape[] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF]};
+					out.write(escape, sizeof(escape));
+					break;
+				}
+			}
+		}
+		out.write(text.data() + runStart, text.size() - runStart);
+		out.put('"');
+	}
+
+	void ExportJsonFile(const std::string& input, const std::string& output, const JsonExportOptions& options) {
+		//Open input
+		std::ifstream inFile;
+		if(input != "-") {
+			inFile.open(input, std::ios::binary);
+			if(!inFile) throw std::runtime_error("Cannot open input file '" + input + "'");
+		}
+		std::istream& in = (input == "-" ? std::cin : inFile);
+
+		//Open output
+		std::ofstream outFile;
+		if(output != "-") {
+			outFile.open(output, std::ios::binary | std::ios::trunc);
+			if(!outFile) throw std::runtime_error("Cannot open output file '" + output + "'");
+		}
+		std::ostream& out = (output == "-" ? std::cout : outFile);
+
+		//Convert
+		JsonExporter exporter(in, out, options);
+		exporter.Export();
+		if(!out.good()) throw std::runtime_error("IO error while writing output file '" + output + "'");
+	}
+}
\ No newline at end of file
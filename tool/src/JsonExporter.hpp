@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InputBuffer.hpp"
+
+#include "libjaguar/Reader.hpp"
+#include "libjaguar/ValueHeader.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace jaguartool {
+	enum class JsonBytesEncoding {
+		Base64,
+		Hex
+	};
+
+	struct JsonExportOptions {
+		uint32_t indent = 0;//Spaces per nesting level, or 0 for compact output
+		JsonBytesEncoding bytes = JsonBytesEncoding::Base64;
+		bool raw = false;//Never treat the input as a container
+	};
+
+	/*
+	 * Single-pass converter from a Jaguar stream (or container) to JSON
+	 *
+	 * The root scope becomes a JSON object. Objects (structured or not) and expanded substreams become objects, lists, vectors, and matrices
+	 * (as arrays of columns) become arrays, byte buffers become encoded strings, and non-finite floats become null. Type declarations are
+	 * dropped since structured objects carry their field names. Output is written as the input is read, so memory use is bounded by the
+	 * nesting depth.
+	 */
+	class JsonExporter {
+	  public:
+		JsonExporter(std::istream& in, std::ostream& out, const JsonExportOptions& options);
+
+		void Export();
+
+	  private:
+		CountingIstream* input;
+		libjaguar::Reader reader;
+		std::ostream& out;
+		JsonExportOptions options;
+
+		void ExportMembers(uint64_t end, uint32_t depth, bool object);
+		void ExportValue(const libjaguar::ValueHeader& header, uint32_t depth);
+		void ExportNumber(libjaguar::TypeTag type);
+		void ExportString(uint32_t size);
+		void ExportBytes(uint32_t size);
+
+		void WriteQuoted(std::string_view text);
+		void NewLine(uint32_t depth);
+	};
+
+	//Convert one stream file (or "-" for standard input) into one JSON file (or "-" for standard output)
+	void ExportJsonFile(const std::string& input, const std::string& output, const JsonExportOptions& options);
+}
\ No newline at end of file
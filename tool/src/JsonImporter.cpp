@@ -0,0 +1,386 @@
+#include "JsonImporter.hpp"
+#include "TextFormat.hpp"
+
+#include "libjaguar/ValueHeader.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+using namespace libjaguar;
+
+namespace jaguartool {
+	JsonImporter::JsonImporter(JsonTokenizer& tokenizer, Writer& writer, PatchableOstream& out, const JsonImportOptions& options)
+	  : tokenizer(tokenizer), writer(writer), out(out), options(options) {
+		//Vectors are only recognized once the whole array is in the window
+		if(this->options.lookahead < 5) this->options.lookahead = 5;
+	}
+
+	void JsonImporter::Import() {
+		try {
+			//The fields of a root object become root values; anything else becomes a single named value
+			const JsonToken& first = tokenizer.Peek();
+			if(first.type == JsonTokenType::End) tokenizer.Fail(first, "Expected a JSON value");
+			if(first.type == JsonTokenType::BeginObject) {
+				tokenizer.Next();
+				ImportFields(0);
+			} else {
+				ImportValue(options.rootName, false, 0);
+			}
+			tokenizer.Expect(JsonTokenType::End, "the end of the input");
+		} catch(const SyntaxError&) {
+			throw;
+		} catch(const std::exception& e) {
+			//Errors from the writer don't know where they came from
+			throw SyntaxError(tokenizer.Location() + ": " + e.what());
+		}
+	}
+
+	void JsonImporter::CheckName(const JsonToken& key) const {
+		if(key.text.empty() || key.text.size() > UINT8_MAX) tokenizer.Fail(key, "Field names must be between 1 and 255 bytes long to be used as Jaguar names");
+	}
+
+	void JsonImporter::FailElement(const JsonToken& token, const char* expected) const {
+		//A truncated array is not a type mismatch
+		if(token.type == JsonTokenType::End) tokenizer.Fail(token, "Unexpected end of the input");
+		tokenizer.Fail(token, std::string("Array elements must all have the same type (expected ") + expected + ")");
+	}
+
+	uint64_t JsonImporter::ImportFields(uint8_t depth) {
+		if(tokenizer.Peek().type == JsonTokenType::EndObject) {
+			tokenizer.Next();
+			return 0;
+		}
+
+		//Names must be unique within an object, as in the text format
+		std::unordered_set<std::string> names;
+		uint64_t count = 0;
+		while(true) {
+			const JsonToken& key = tokenizer.Expect(JsonTokenType::String, "a field name");
+			CheckName(key);
+			std::string name = key.text;
+			if(!names.insert(name).second) tokenizer.Fail(key, "Duplicate field '" + name + "'");
+			tokenizer.Expect(JsonTokenType::Colon, "':'");
+			if(ImportValue(name, false, depth)) ++count;
+
+			const JsonToken& separator = tokenizer.Next();
+			if(separator.type == JsonTokenType::EndObject) break;
+			if(separator.type != JsonTokenType::Comma) tokenizer.Fail(separator, "Expected ',' or '}'");
+		}
+		return count;
+	}
+
+	bool JsonImporter::ImportValue(const std::string& name, bool element, uint8_t depth) {
+		const JsonToken& token = tokenizer.Next();
+		ValueHeader header = {};
+		header.name = name;
+		switch(token.type) {
+			case JsonTokenType::String:
+				header.type = TypeTag::String;
+				header.size = static_cast<uint32_t>(token.text.size());
+				writer.WriteHeader(header, element);
+				writer.WriteString(token.text);
+				break;
+			case JsonTokenType::Number: {
+				JsonNumber number = ParseNumber(token);
+				header.type = ChooseNumberType(std::span<const JsonNumber>(&number, 1));
+				if(!element) writer.WriteHeader(header);
+				WriteNumber(header.type, number);
+				break;
+			}
+			case JsonTokenType::True:
+			case JsonTokenType::False:
+				header.type = TypeTag::Boolean;
+				if(!element) writer.WriteHeader(header);
+				writer.WriteBool(token.type == JsonTokenType::True);
+				break;
+			case JsonTokenType::Null:
+				//Jaguar has no null, so the field is left out
+				if(options.nulls == JsonNullMode::Error) tokenizer.Fail(token, "Null values are not allowed");
+				return false;
+			case JsonTokenType::BeginObject: ImportObject(name, element, depth); break;
+			case JsonTokenType::BeginArray: ImportArray(name, element, depth, ArrayShape::Any); break;
+			default: tokenizer.Fail(token, "Expected a value");
+		}
+		return true;
+	}
+
+	void JsonImporter::ImportObject(const std::string& name, bool element, uint8_t depth) {
+		if(depth >= maxNestingDepth) tokenizer.Fail("Maximum nesting depth exceeded");
+		ValueHeader header = {};
+		header.type = TypeTag::UnstructuredObj;
+		header.name = name;
+		header.fieldCount = 0;
+		writer.WriteHeader(header, element);
+		const uint64_t countPos = out.Position() - 2;
+
+		uint64_t fieldCount = ImportFields(depth + 1);
+		if(fieldCount > UINT16_MAX) tokenizer.Fail("Object has more than 65535 fields");
+
+		ValueHeader boundary = {};
+		boundary.type = TypeTag::ScopeBoundary;
+		writer.WriteHeader(boundary);
+		out.PatchInteger(countPos, fieldCount, 2);
+	}
+
+	TypeTag JsonImporter::ImportArray(const std::string& name, bool element, uint8_t depth, ArrayShape shape) {
+		if(depth >= maxNestingDepth) tokenizer.Fail("Maximum nesting depth exceeded");
+
+		//The first element decides the element type
+		const JsonToken& first = tokenizer.Peek();
+		if(first.type == JsonTokenType::Number) return ImportNumberArray(name, element, shape);
+		if(shape == ArrayShape::Vector) tokenizer.Fail(first, "Expected a vector of 2 to 4 numbers, like the first element of the containing array");
+
+		ValueHeader header = {};
+		header.type = TypeTag::List;
+		header.name = name;
+		header.size = 0;
+		switch(first.type) {
+			case JsonTokenType::EndArray:
+				//Empty arrays have no element type to infer, so use the default number type
+				tokenizer.Next();
+				header.elementType = options.integersAsFloats ? options.floatType : options.integerType;
+				writer.WriteHeader(header, element);
+				return TypeTag::List;
+			case JsonTokenType::String: header.elementType = TypeTag::String; break;
+			case JsonTokenType::True:
+			case JsonTokenType::False: header.elementType = TypeTag::Boolean; break;
+			case JsonTokenType::BeginObject: header.elementType = TypeTag::UnstructuredObj; break;
+			case JsonTokenType::BeginArray: header.elementType = TypeTag::List; break;
+			case JsonTokenType::Null: tokenizer.Fail(first, "Arrays may not contain null");
+			default: tokenizer.Fail(first, "Expected a value or ']'");
+		}
+		writer.WriteHeader(header, element);
+		ImportArrayElements(header.elementType, out.Position() - 4, depth + 1);
+		return TypeTag::List;
+	}
+
+	void JsonImporter::ImportArrayElements(TypeTag elementType, uint64_t countPos, uint8_t depth) {
+		ArrayShape innerShape = ArrayShape::Any;
+		uint64_t count = 0;
+		while(true) {
+			const JsonToken& token = tokenizer.Next();
+			switch(elementType) {
+				case TypeTag::String: {
+					if(token.type != JsonTokenType::String) FailElement(token, "a string");
+					ValueHeader header = {};
+					header.type = TypeTag::String;
+					header.size = static_cast<uint32_t>(token.text.size());
+					writer.WriteHeader(header, true);
+					writer.WriteString(token.text);
+					break;
+				}
+				case TypeTag::Boolean:
+					if(token.type != JsonTokenType::True && token.type != JsonTokenType::False) FailElement(token, "a boolean");
+					writer.WriteBool(token.type == JsonTokenType::True);
+					break;
+				case TypeTag::UnstructuredObj:
+					if(token.type != JsonTokenType::BeginObject) FailElement(token, "an object");
+					ImportObject("", true, depth);
+					break;
+				default:
+					if(token.type != JsonTokenType::BeginArray) FailElement(token, "an array");
+					if(count == 0) {
+						//The first nested array decides whether the elements are lists or vectors; the element tag sits just before the count
+						if(ImportArray("", true, depth, ArrayShape::Any) == TypeTag::Vector) {
+							out.PatchInteger(countPos - 1, static_cast<uint8_t>(TypeTag::Vector), 1);
+							innerShape = ArrayShape::Vector;
+						} else {
+							innerShape = ArrayShape::List;
+						}
+					} else {
+						ImportArray("", true, depth, innerShape);
+					}
+					break;
+			}
+			if(++count > UINT32_MAX) tokenizer.Fail(token, "Too many array elements");
+
+			const JsonToken& separator = tokenizer.Next();
+			if(separator.type == JsonTokenType::EndArray) break;
+			if(separator.type != JsonTokenType::Comma) tokenizer.Fail(separator, "Expected ',' or ']'");
+		}
+		out.PatchInteger(countPos, count, 4);
+	}
+
+	TypeTag JsonImporter::ImportNumberArray(const std::string& name, bool element, ArrayShape shape) {
+		//Collect the first elements to pick the element type
+		window.clear();
+		bool done = false;
+		while(!done && window.size() < options.lookahead) {
+			const JsonToken& token = tokenizer.Next();
+			if(token.type != JsonTokenType::Number) FailElement(token, "a number");
+			window.push_back(ParseNumber(token));
+
+			const JsonToken& separator = tokenizer.Next();
+			if(separator.type == JsonTokenType::EndArray) {
+				done = true;
+			} else if(separator.type != JsonTokenType::Comma) {
+				tokenizer.Fail(separator, "Expected ',' or ']'");
+			}
+		}
+		const TypeTag type = ChooseNumberType(window);
+		const bool vectorSized = done && window.size() >= 2 && window.size() <= 4;
+		if(shape == ArrayShape::Vector && !vectorSized) tokenizer.Fail("Expected a vector of 2 to 4 numbers, like the first element of the containing array");
+
+		ValueHeader header = {};
+		header.name = name;
+		header.elementType = type;
+		if(shape == ArrayShape::Vector || (shape == ArrayShape::Any && options.vectors && vectorSized)) {
+			header.type = TypeTag::Vector;
+			header.width = static_cast<uint8_t>(window.size());
+			writer.WriteHeader(header, element);
+			for(const JsonNumber& number : window) WriteNumber(type, number);
+			return TypeTag::Vector;
+		}
+
+		//Write what we have, then stream the rest straight through
+		header.type = TypeTag::List;
+		header.size = 0;
+		writer.WriteHeader(header, element);
+		const uint64_t countPos = out.Position() - 4;
+		for(const JsonNumber& number : window) WriteNumber(type, number);
+		uint64_t count = window.size();
+		while(!done) {
+			const JsonToken& token = tokenizer.Next();
+			if(token.type != JsonTokenType::Number) FailElement(token, "a number");
+			WriteNumber(type, ParseNumber(token));
+			if(++count > UINT32_MAX) tokenizer.Fail(token, "Too many array elements");
+
+			const JsonToken& separator = tokenizer.Next();
+			if(separator.type == JsonTokenType::EndArray) {
+				done = true;
+			} else if(separator.type != JsonTokenType::Comma) {
+				tokenizer.Fail(separator, "Expected ',' or ']'");
+			}
+		}
+		out.PatchInteger(countPos, count, 4);
+		return TypeTag::List;
+	}
+
+	JsonNumber JsonImporter::ParseNumber(const JsonToken& token) const {
+		JsonNumber number = {JsonNumber::Kind::Signed, 0, 0, 0.0};
+		const char* begin = token.text.data();
+		const char* end = begin + token.text.size();
+
+		//Integers that don't fit in 64 bits are treated like any other number with a fraction
+		if(token.integral) {
+			if(std::from_chars(begin, end, number.signedValue).ec == std::errc()) return number;
+			if(token.text[0] != '-' && std::from_chars(begin, end, number.unsignedValue).ec == std::errc()) {
+				number.kind = JsonNumber::Kind::Unsigned;
+				return number;
+			}
+		}
+		number.kind = JsonNumber::Kind::Float;
+		if(std::from_chars(begin, end, number.floatValue).ec != std::errc()) tokenizer.Fail(token, "Number '" + token.text + "' is out of range");
+		return number;
+	}
+
+	TypeTag JsonImporter::ChooseNumberType(std::span<const JsonNumber> numbers) const {
+		if(options.integersAsFloats) return options.floatType;
+
+		int64_t min = 0;
+		int64_t max = 0;
+		bool huge = false;
+		for(const JsonNumber& number : numbers) {
+			if(number.kind == JsonNumber::Kind::Float) return options.floatType;
+			if(number.kind == JsonNumber::Kind::Unsigned) {
+				huge = true;
+			} else {
+				min = std::min(min, number.signedValue);
+				max = std::max(max, number.signedValue);
+			}
+		}
+
+		//Values past the signed range only fit an unsigned 64-bit integer
+		if(huge && min >= 0 && (options.narrowIntegers || options.integerType == TypeTag::SInt64)) return TypeTag::UInt64;
+		if(!options.narrowIntegers) return options.integerType;
+		if(min >= INT8_MIN && max <= INT8_MAX) return TypeTag::SInt8;
+		if(min >= INT16_MIN && max <= INT16_MAX) return TypeTag::SInt16;
+		if(min >= INT32_MIN && max <= INT32_MAX) return TypeTag::SInt32;
+		return TypeTag::SInt64;
+	}
+
+	//Convert a number to an integer type, returning false if it doesn't fit exactly
+	template<typename T>
+	static bool ToInteger(const JsonNumber& number, T& out) {
+		switch(number.kind) {
+			case JsonNumber::Kind::Signed:
+				if(!std::in_range<T>(number.signedValue)) return false;
+				out = static_cast<T>(number.signedValue);
+				return true;
+			case JsonNumber::Kind::Unsigned:
+				if(!std::in_range<T>(number.unsignedValue)) return false;
+				out = static_cast<T>(number.unsignedValue);
+				return true;
+			default:
+				//Integral floats (like 2.0 or 1e3) are fine as long as they are in range
+				if(number.floatValue != std::trunc(number.floatValue)) return false;
+				if(number.floatValue < static_cast<double>(std::numeric_limits<T>::min()) || number.floatValue >= std::ldexp(1.0, std::numeric_limits<T>::digits)) return false;
+				out = static_cast<T>(number.floatValue);
+				return true;
+		}
+	}
+
+	template<typename T>
+	static void WriteIntegerChecked(Writer& writer, const JsonNumber& number, TypeTag type, const JsonTokenizer& tokenizer) {
+		T value;
+		if(!ToInteger(number, value)) {
+			tokenizer.Fail("Number does not fit the inferred type " + std::string(ScalarKeywordOf(type)) +
+						   " (the type is chosen from the first array elements; try a larger --lookahead, a wider --int, or --numbers float)");
+		}
+		writer.WriteInteger(value);
+	}
+
+	void JsonImporter::WriteNumber(TypeTag type, const JsonNumber& number) {
+		double asDouble = number.floatValue;
+		if(number.kind == JsonNumber::Kind::Signed) asDouble = static_cast<double>(number.signedValue);
+		if(number.kind == JsonNumber::Kind::Unsigned) asDouble = static_cast<double>(number.unsignedValue);
+
+		switch(type) {
+			case TypeTag::Float32: writer.WriteFloat(static_cast<float>(asDouble)); break;
+			case TypeTag::Float64: writer.WriteFloat(asDouble); break;
+			case TypeTag::SInt8: WriteIntegerChecked<int8_t>(writer, number, type, tokenizer); break;
+			case TypeTag::SInt16: WriteIntegerChecked<int16_t>(writer, number, type, tokenizer); break;
+			case TypeTag::SInt32: WriteIntegerChecked<int32_t>(writer, number, type, tokenizer); break;
+			case TypeTag::SInt64: WriteIntegerChecked<int64_t>(writer, number, type, tokenizer); break;
+			case TypeTag::UInt8: WriteIntegerChecked<uint8_t>(writer, number, type, tokenizer); break;
+			case TypeTag::UInt16: WriteIntegerChecked<uint16_t>(writer, number, type, tokenizer); break;
+			case TypeTag::UInt32: WriteIntegerChecked<uint32_t>(writer, number, type, tokenizer); break;
+			case TypeTag::UInt64: WriteIntegerChecked<uint64_t>(writer, number, type, tokenizer); break;
+			default: tokenizer.Fail("Invalid number type");
+		}
+	}
+
+	void ImportJsonFile(const std::filesystem::path& input, const std::filesystem::path& output, const JsonImportOptions& options) {
+		//Open input
+		std::ifstream inFile;
+		if(input != "-") {
+			inFile.open(input, std::ios::binary);
+			if(!inFile) throw std::runtime_error("Cannot open input file '" + input.string() + "'");
+		}
+		std::istream& in = (input == "-" ? std::cin : inFile);
+
+		//Open output
+		std::unique_ptr<PatchableOstream> outStream;
+		if(output == "-") {
+			outStream = std::make_unique<PatchableOstream>(std::cout);
+		} else {
+			auto outFile = std::make_unique<std::ofstream>(output, std::ios::binary | std::ios::trunc);
+			if(!*outFile) throw std::runtime_error("Cannot open output file '" + output.string() + "'");
+			outStream = std::make_unique<PatchableOstream>(std::move(outFile));
+		}
+		PatchableOstream& out = *outStream;
+		Writer writer(std::move(outStream));
+
+		//Convert
+		JsonTokenizer tokenizer(in, input == "-" ? std::string("<stdin>") : input.string());
+		JsonImporter importer(tokenizer, writer, out, options);
+		importer.Import();
+		out.flush();
+		if(!out.good()) throw std::runtime_error("IO error while writing output file '" + output.string() + "'");
+	}
+}
\ No newline at end of file
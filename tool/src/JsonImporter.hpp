@@ -0,0 +1,87 @@
+#pragma once
+
+#include "JsonTokenizer.hpp"
+#include "PatchableOutput.hpp"
+
+#include "libjaguar/TypeTags.hpp"
+#include "libjaguar/Writer.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace jaguartool {
+	enum class JsonNullMode {
+		Skip, //Leave out object fields whose value is null
+		Error //Fail on any null
+	};
+
+	struct JsonImportOptions {
+		libjaguar::TypeTag integerType = libjaguar::TypeTag::SInt64;//Type for integral numbers
+		bool narrowIntegers = false;								 //Pick the narrowest signed type that fits instead of integerType
+		libjaguar::TypeTag floatType = libjaguar::TypeTag::Float64;	 //Type for numbers with a fraction or exponent
+		bool integersAsFloats = false;								 //Treat every number as floatType
+		bool vectors = false;										 //Turn arrays of 2-4 numbers into vectors
+		uint32_t lookahead = 65536;									 //Number array elements inspected before the element type is fixed
+		JsonNullMode nulls = JsonNullMode::Skip;
+		std::string rootName = "root";//Name of the root value when the document is not an object
+	};
+
+	//A parsed JSON number
+	struct JsonNumber {
+		enum class Kind {
+			Signed,
+			Unsigned,//Only used for integers above the signed 64-bit range
+			Float
+		} kind;
+		int64_t signedValue;
+		uint64_t unsignedValue;
+		double floatValue;
+	};
+
+	/*
+	 * Single-pass converter from JSON to a Jaguar stream
+	 *
+	 * Objects become unstructured objects (the fields of a root object become root values), arrays become lists, and numbers are typed according to
+	 * the import options. Arrays of numbers get one element type for the whole list, chosen from the first elements (up to the lookahead limit) so
+	 * that memory stays bounded; later elements that don't fit that type are an error. Counts are patched in once each array or object ends.
+	 */
+	class JsonImporter {
+	  public:
+		JsonImporter(JsonTokenizer& tokenizer, libjaguar::Writer& writer, PatchableOstream& out, const JsonImportOptions& options);
+
+		void Import();
+
+	  private:
+		//Shape that the elements of a list of arrays are constrained to
+		enum class ArrayShape {
+			Any,
+			List,
+			Vector
+		};
+
+		JsonTokenizer& tokenizer;
+		libjaguar::Writer& writer;
+		PatchableOstream& out;
+		JsonImportOptions options;
+		std::vector<JsonNumber> window;
+
+		bool ImportValue(const std::string& name, bool element, uint8_t depth);
+		void ImportObject(const std::string& name, bool element, uint8_t depth);
+		uint64_t ImportFields(uint8_t depth);
+		libjaguar::TypeTag ImportArray(const std::string& name, bool element, uint8_t depth, ArrayShape shape);
+		libjaguar::TypeTag ImportNumberArray(const std::string& name, bool element, ArrayShape shape);
+		void ImportArrayElements(libjaguar::TypeTag elementType, uint64_t countPos, uint8_t depth);
+
+		JsonNumber ParseNumber(const JsonToken& token) const;
+		libjaguar::TypeTag ChooseNumberType(std::span<const JsonNumber> numbers) const;
+		void WriteNumber(libjaguar::TypeTag type, const JsonNumber& number);
+		void CheckName(const JsonToken& key) const;
+		[[noreturn]] void FailElement(const JsonToken& token, const char* expected) const;
+	};
+
+	//Convert one JSON file (or "-" for standard input) into one stream file (or "-" for standard output)
+	void ImportJsonFile(const std::filesystem::path& input, const std::filesystem::path& output, const JsonImportOptions& options);
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "JsonTokenizer.hpp"
+
+#include <cstring>
+
+namespace jaguartool {
+	constexpr inline std::size_t jsonBufferSize = 256 * 1024;			   //256 KiB
+	constexpr inline std::size_t maxJsonStringLength = (1 << 24) - 1; //Jaguar string size limit
+
+	JsonTokenizer::JsonTokenizer(std::istream& in, std::string sourceName)
+	  : in(in), sourceName(std::move(sourceName)), buffer(jsonBufferSize), bufferPos(0), bufferEnd(0), consumed(0), line(1), lineStart(0), hasPeeked(false), token() {}
+
+	bool JsonTokenizer::Refill() {
+		consumed += bufferEnd;
+		in.read(buffer.data(), buffer.size());
+		bufferPos = 0;
+		bufferEnd = static_cast<std::size_t>(in.gcount());
+		if(bufferEnd == 0 && in.bad()) Fail("IO error while reading input");
+		return bufferEnd > 0;
+	}
+
+	int JsonTokenizer::PeekChar() {
+		if(bufferPos == bufferEnd && !Refill()) return EOF;
+		return static_cast<unsigned char>(buffer[bufferPos]);
+	}
+
+	std::string JsonTokenizer::Location() const {
+		return sourceName + ":" + std::to_string(line) + ":" + std::to_string(Offset() - lineStart + 1);
+	}
+
+	void JsonTokenizer::Fail(const JsonToken& at, const std::string& message) const {
+		throw SyntaxError(sourceName + ":" + std::to_string(at.line) + ":" + std::to_string(at.column) + ": " + message);
+	}
+
+	void JsonTokenizer::Fail(const std::string& message) const {
+		throw SyntaxError(Location() + ": " + message);
+	}
+
+	const JsonToken& JsonTokenizer::Peek() {
+		if(!hasPeeked) {
+			LexToken();
+			hasPeeked = true;
+		}
+		return token;
+	}
+
+	const JsonToken& JsonTokenizer::Next() {
+		if(hasPeeked) {
+			hasPeeked = false;
+		} else {
+			LexToken();
+		}
+		return token;
+	}
+
+	const JsonToken& JsonTokenizer::Expect(JsonTokenType type, const char* what) {
+		const JsonToken& next = Next();
+		if(next.type != type) Fail(next, std::string("Expected ") + what);
+		return next;
+	}
+
+	void JsonTokenizer::LexToken() {
+		//Skip whitespace
+		int c = PeekChar();
+		while(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			++bufferPos;
+			if(c == '\n') {
+				++line;
+				lineStart = Offset();
+			}
+			c = PeekChar();
+		}
+
+		token.line = line;
+		token.column = Offset() - lineStart + 1;
+		token.text.clear();
+		token.integral = false;
+		switch(c) {
+			case EOF: token.type = JsonTokenType::End; return;
+			case '{': token.type = JsonTokenType::BeginObject; break;
+			case '}': token.type = JsonTokenType::EndObject; break;
+			case '[': token.type = JsonTokenType::BeginArray; break;
+			case ']': token.type = JsonTokenType::EndArray; break;
+			case ':': token.type = JsonTokenType::Colon; break;
+			case ',': token.type = JsonTokenType::Comma; break;
+			case '"':
+				++bufferPos;
+				LexString();
+				return;
+			case 't': LexKeyword("true", JsonTokenType::True); return;
+			case 'f': LexKeyword("false", JsonTokenType::False); return;
+			case 'n': LexKeyword("null", JsonTokenType::Null); return;
+			default:
+				if(c == '-' || (c >= '0' && c <= '9')) {
+					LexNumber();
+					return;
+				}
+				Fail("Unexpected character '" + std::string(1, static_cast<char>(c)) + "'");
+		}
+		++bufferPos;
+	}
+
+	void JsonTokenizer::LexKeyword(const char* word, JsonTokenType type) {
+		for(const char* p = word; *p; ++p) {
+			if(PeekChar() != *p) Fail("Invalid literal (expected '" + std::string(word) + "')");
+			++bufferPos;
+		}
+		token.type = type;
+	}
+
+	void JsonTokenizer::LexNumber() {
+		token.type = JsonTokenType::Number;
+		std::string& text = token.text;
+		auto digits = [&]() {
+			std::size_t count = 0;
+			for(int c = PeekChar(); c >= '0' && c <= '9'; c = PeekChar()) {
+				text.push_back(static_cast<char>(c));
+				++bufferPos;
+				++count;
+			}
+			return count;
+		};
+
+		//-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		if(PeekChar() == '-') {
+			text.push_back('-');
+			++bufferPos;
+		}
+		if(PeekChar() == '0') {
+			text.push_back('0');
+			++bufferPos;
+			if(int c = PeekChar(); c >= '0' && c <= '9') Fail("Numbers may not have leading zeros");
+		} else if(digits() == 0) {
+			Fail("Invalid number");
+		}
+		token.integral = true;
+		if(PeekChar() == '.') {
+			text.push_back('.');
+			++bufferPos;
+			if(digits() == 0) Fail("Expected digits after the decimal point");
+			token.integral = false;
+		}
+		if(int c = PeekChar(); c == 'e' || c == 'E') {
+			text.push_back('e');
+			++bufferPos;
+			if(int sign = PeekChar(); sign == '+' || sign == '-') {
+				text.push_back(static_cast<char>(sign));
+				++bufferPos;
+			}
+			if(digits() == 0) Fail("Expected digits in the exponent");
+			token.integral = false;
+		}
+	}
+
+	uint32_t JsonTokenizer::LexHexQuad() {
+		uint32_t value = 0;
+		for(int i = 0; i < 4; ++i) {
+			int c = PeekChar();
+			uint32_t digit;
+			if(c >= '0' && c <= '9') {
+				digit = c - '0';
+			} else if(c >= 'a' && c <= 'f') {
+				digit = c - 'a' + 10;
+			} else if(c >= 'A' && c <= 'F') {
+				digit = c - 'A' + 10;
+			} else {
+				Fail("Invalid \\u escape");
+			}
+			value = (value << 4) | digit;
+			++bufferPos;
+		}
+		return value;
+	}
+
+	void JsonTokenizer::LexString() {
+		token.type = JsonTokenType::String;
+		std::string& text = token.text;
+		while(true) {
+			if(PeekChar() == EOF) Fail("Unterminated string");
+
+			//Copy everything up to the next quote, escape, or control character in one go
+			const char* start = buffer.data() + bufferPos;
+			const char* end = buffer.data() + bufferEnd;
+			const char* p = start;
+			while(p != end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) ++p;
+			text.append(start, p);
+			bufferPos += p - start;
+			if(text.size() > maxJsonStringLength) Fail("String is longer than the Jaguar string size limit");
+			if(p == end) continue;
+
+			const char c = *p;
+			++bufferPos;
+			if(c == '"') return;
+			if(c != '\\') Fail("Unescaped control character in string");
+
+			//Escape sequences
+			int escape = PeekChar();
+			if(escape == EOF) Fail("Unterminated string");
+			++bufferPos;
+			switch(escape) {
+				case '"': text.push_back('"'); break;
+				case '\\': text.push_back('\\'); break;
+				case '/': text.push_back('/'); break;
+				case 'b': text.push_back('\b'); break;
+				case 'f': text.push_back('\f'); break;
+				case 'n': text.push_back('\n'); break;
+				case 'r': text.push_back('\r'); break;
+				case 't': text.push_back('\t'); break;
+				case 'u': {
+					uint32_t codepoint = LexHexQuad();
+
+					//Combine surrogate pairs
+					if(codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+						if(PeekChar() != '\\') Fail("Unpaired surrogate in \\u escape");
+						++bufferPos;
+						if(PeekChar() != 'u') Fail("Unpaired surrogate in \\u escape");
+						++bufferPos;
+						uint32_t low = LexHexQuad();
+						if(low < 0xDC00 || low > 0xDFFF) Fail("Unpaired surrogate in \\u escape");
+						codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					} else if(codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+						Fail("Unpaired surrogate in \\u escape");
+					}
+
+					//Encode as UTF-8
+					if(codepoint < 0x80) {
+						text.push_back(static_cast<char>(codepoint));
+					} else if(codepoint < 0x800) {
+						text.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+						text.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+					} else if(codepoint < 0x10000) {
+						text.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+						text.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+						text.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+					} else {
+						text.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+						text.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+						text.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+						text.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+					}
+					break;
+				}
+				default: Fail("Invalid escape sequence");
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Lexer.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace jaguartool {
+	enum class JsonTokenType {
+		BeginObject,
+		EndObject,
+		BeginArray,
+		EndArray,
+		Colon,
+		Comma,
+		String,//Escapes already resolved
+		Number,//Validated against the JSON number grammar, text kept as-is
+		True,
+		False,
+		Null,
+		End
+	};
+
+	struct JsonToken {
+		JsonTokenType type;
+		std::string text;//String contents or number text
+		bool integral;	 //For numbers, whether there is no fraction or exponent
+		uint64_t line;
+		uint64_t column;
+	};
+
+	/*
+	 * Streaming JSON tokenizer
+	 *
+	 * Input is pulled through a fixed-size buffer and tokens are decoded into a single reused token, so memory use is bounded by the largest string
+	 * (capped at the Jaguar string size limit). Runs of plain string characters are copied in bulk rather than one character at a time.
+	 */
+	class JsonTokenizer {
+	  public:
+		JsonTokenizer(std::istream& in, std::string sourceName);
+
+		//Look at the next token without consuming it
+		const JsonToken& Peek();
+
+		//Consume the next token (the reference stays valid until the next call to Peek or Next)
+		const JsonToken& Next();
+
+		//Consume the next token, failing if it is not of the expected type
+		const JsonToken& Expect(JsonTokenType type, const char* what);
+
+		//Throw a SyntaxError at a location
+		[[noreturn]] void Fail(const JsonToken& at, const std::string& message) const;
+		[[noreturn]] void Fail(const std::string& message) const;
+
+		//Current location formatted as "source:line:column"
+		std::string Location() const;
+
+	  private:
+		std::istream& in;
+		std::string sourceName;
+		std::vector<char> buffer;
+		std::size_t bufferPos;
+		std::size_t bufferEnd;
+		uint64_t consumed;	//Bytes consumed before the current buffer
+		uint64_t line;
+		uint64_t lineStart;//Offset of the first byte of the current line
+		bool hasPeeked;
+		JsonToken token;
+
+		uint64_t Offset() const {
+			return consumed + bufferPos;
+		}
+
+		int PeekChar();
+		bool Refill();
+		void LexToken();
+		void LexString();
+		void LexNumber();
+		void LexKeyword(const char* word, JsonTokenType type);
+		uint32_t LexHexQuad();
+	};
+}
\ No newline at end of file
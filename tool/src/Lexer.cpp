@@ -0,0 +1,263 @@
+#include "Lexer.hpp"
+
+#include <cctype>
+
+namespace jaguartool {
+	constexpr inline std::size_t lexerBufferSize = 64 * 1024;//64 KiB (one KiB is 1024 bytes)
+	constexpr inline std::size_t maxStringLength = (1 << 24) - 1;
+
+	Lexer::Lexer(std::istream& in, std::string sourceName)
+	  : in(in), sourceName(std::move(sourceName)), buffer(lexerBufferSize), bufferPos(0), bufferEnd(0), line(1), column(1), hasPeeked(false) {}
+
+	bool Lexer::Refill() {
+		in.read(buffer.data(), buffer.size());
+		bufferPos = 0;
+		bufferEnd = static_cast<std::size_t>(in.gcount());
+		if(bufferEnd == 0 && in.bad()) Fail("IO error while reading input");
+		return bufferEnd > 0;
+	}
+
+	int Lexer::PeekChar() {
+		if(bufferPos == bufferEnd && !Refill()) return EOF;
+		return static_cast<unsigned char>(buffer[bufferPos]);
+	}
+
+	int Lexer::GetChar() {
+		int c = PeekChar();
+		if(c == EOF) return EOF;
+		++bufferPos;
+		if(c == '\n') {
+			++line;
+			column = 1;
+		} else {
+			++column;
+		}
+		return c;
+	}
+
+	std::string Lexer::Location() const {
+		return sourceName + ":" + std::to_string(line) + ":" + std::to_string(column);
+	}
+
+	void Lexer::Fail(const Token& at, const std::string& message) const {
+		throw SyntaxError(sourceName + ":" + std::to_string(at.line) + ":" + std::to_string(at.column) + ": " + message);
+	}
+
+	void Lexer::Fail(const std::string& message) const {
+		throw SyntaxError(Location() + ": " + message);
+	}
+
+	const Token& Lexer::Peek() {
+		if(!hasPeeked) {
+			peeked = LexToken();
+			hasPeeked = true;
+		}
+		return peeked;
+	}
+
+	Token Lexer::Next() {
+		if(hasPeeked) {
+			hasPeeked = false;
+			return std::move(peeked);
+		}
+		return LexToken();
+	}
+
+	Token Lexer::Expect(TokenType type, const char* what) {
+		Token token = Next();
+		if(token.type != type) Fail(token, std::string("Expected ") + what);
+		return token;
+	}
+
+	bool Lexer::Accept(TokenType type) {
+		if(Peek().type != type) return false;
+		hasPeeked = false;
+		return true;
+	}
+
+	void Lexer::SkipWhitespaceAndComments() {
+		while(true) {
+			int c = PeekChar();
+			if(c == '#') {
+				//Comments run to the end of the line
+				while(c != EOF && c != '\n') {
+					GetChar();
+					c = PeekChar();
+				}
+			} else if(c != EOF && std::isspace(c)) {
+				GetChar();
+			} else {
+				return;
+			}
+		}
+	}
+
+	Token Lexer::LexToken() {
+		SkipWhitespaceAndComments();
+
+		Token token = {TokenType::End, "", line, column};
+		int c = GetChar();
+		switch(c) {
+			case EOF: return token;
+			case '{': token.type = TokenType::LBrace; return token;
+			case '}': token.type = TokenType::RBrace; return token;
+			case '[': token.type = TokenType::LBracket; return token;
+			case ']': token.type = TokenType::RBracket; return token;
+			case '(': token.type = TokenType::LParen; return token;
+			case ')': token.type = TokenType::RParen; return token;
+			case '<': token.type = TokenType::LAngle; return token;
+			case '>': token.type = TokenType::RAngle; return token;
+			case '=': token.type = TokenType::Equals; return token;
+			case ';': token.type = TokenType::Semicolon; return token;
+			case ',': token.type = TokenType::Comma; return token;
+			case '"':
+				token.type = TokenType::String;
+				LexString(token);
+				return token;
+			default: break;
+		}
+
+		//Numbers (with an optional sign)
+		if(std::isdigit(c) || c == '-' || c == '+' || c == '.') {
+			token.type = TokenType::Number;
+			token.text.push_back(static_cast<char>(c));
+			while(true) {
+				int n = PeekChar();
+				if(n == EOF) break;
+				bool exponentSign = (n == '-' || n == '+') && (token.text.back() == 'e' || token.text.back() == 'E') && token.text.find_first_of("xX") == std::string::npos;
+				if(!std::isalnum(n) && n != '.' && n != '_' && !exponentSign) break;
+				token.text.push_back(static_cast<char>(GetChar()));
+			}
+			return token;
+		}
+
+		//Identifiers and prefixed literals
+		if(std::isalpha(c) || c == '_') {
+			token.type = TokenType::Identifier;
+			token.text.push_back(static_cast<char>(c));
+			while(true) {
+				int n = PeekChar();
+				if(n == EOF || !(std::isalnum(n) || n == '_')) break;
+				token.text.push_back(static_cast<char>(GetChar()));
+			}
+
+			//x"..." and file"..." byte literals
+			if(PeekChar() == '"') {
+				if(token.text == "x") {
+					GetChar();
+					token.type = TokenType::HexBytes;
+					token.text.clear();
+				} else if(token.text == "file") {
+					GetChar();
+					token.type = TokenType::FilePath;
+					token.text.clear();
+					LexString(token);
+				}
+			}
+			return token;
+		}
+
+		Fail(token, std::string("Unexpected character '") + static_cast<char>(c) + "'");
+	}
+
+	void Lexer::LexString(Token& token) {
+		while(true) {
+			int c = GetChar();
+			if(c == EOF) Fail(token, "Unterminated string literal");
+			if(c == '"') return;
+			if(c == '\\')
+				AppendEscape(token.text);
+			else
+				token.text.push_back(static_cast<char>(c));
+			if(token.text.size() > maxStringLength) Fail(token, "String literal exceeds the maximum Jaguar string size");
+		}
+	}
+
+	static int HexDigitValue(int c) {
+		if(c >= '0' && c <= '9') return c - '0';
+		if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	void Lexer::AppendEscape(std::string& out) {
+		int c = GetChar();
+		switch(c) {
+			case 'n': out.push_back('\n'); return;
+			case 't': out.push_back('\t'); return;
+			case 'r': out.push_back('\r'); return;
+			case '0': out.push_back('\0'); return;
+			case '"': out.push_back('"'); return;
+			case '\\': out.push_back('\\'); return;
+			case 'x': {
+				//Raw byte
+				int hi = HexDigitValue(GetChar());
+				int lo = HexDigitValue(GetChar());
+				if(hi < 0 || lo < 0) Fail("Invalid \\x escape");
+				out.push_back(static_cast<char>((hi << 4) | lo));
+				return;
+			}
+			case 'u': {
+				//Unicode code point as \u{XXXX}
+				if(GetChar() != '{') Fail("Invalid \\u escape");
+				uint32_t cp = 0;
+				int digits = 0;
+				for(int d = GetChar(); d != '}'; d = GetChar()) {
+					int v = HexDigitValue(d);
+					if(v < 0 || ++digits > 6) Fail("Invalid \\u escape");
+					cp = (cp << 4) | v;
+				}
+				if(digits == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) Fail("Invalid \\u escape");
+
+				//Encode as UTF-8
+				if(cp < 0x80) {
+					out.push_back(static_cast<char>(cp));
+				} else if(cp < 0x800) {
+					out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+					out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+				} else if(cp < 0x10000) {
+					out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+					out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+					out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+				} else {
+					out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+					out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+					out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+					out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+				}
+				return;
+			}
+			default: Fail("Invalid escape sequence");
+		}
+	}
+
+	uint64_t Lexer::ReadHexBody(const std::function<void(const unsigned char*, std::size_t)>& sink) {
+		//Decode into a small staging buffer so the sink sees large blocks
+		std::vector<unsigned char> staging;
+		staging.reserve(lexerBufferSize);
+		uint64_t total = 0;
+		int pendingNibble = -1;
+		while(true) {
+			int c = GetChar();
+			if(c == EOF) Fail("Unterminated byte literal");
+			if(c == '"') break;
+			if(std::isspace(c) || c == '_') continue;
+			int v = HexDigitValue(c);
+			if(v < 0) Fail("Invalid character in byte literal");
+			if(pendingNibble < 0) {
+				pendingNibble = v;
+				continue;
+			}
+			staging.push_back(static_cast<unsigned char>((pendingNibble << 4) | v));
+			pendingNibble = -1;
+			if(staging.size() == lexerBufferSize) {
+				sink(staging.data(), staging.size());
+				total += staging.size();
+				staging.clear();
+			}
+		}
+		if(pendingNibble >= 0) Fail("Byte literal has an odd number of hex digits");
+		if(!staging.empty()) sink(staging.data(), staging.size());
+		return total + staging.size();
+	}
+}
\ No newline at end of file
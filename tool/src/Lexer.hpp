@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace jaguartool {
+	//Error in the input text, with the location prepended to the message
+	class SyntaxError : public std::runtime_error {
+	  public:
+		using std::runtime_error::runtime_error;
+	};
+
+	enum class TokenType {
+		Identifier,//Bare word (type keywords, names, true/false, inf/nan, etc.)
+		Number,	   //Numeric literal, including its sign
+		String,	   //Quoted string literal with escapes already resolved
+		HexBytes,  //Start of a x"..." byte literal; the body must be consumed with ReadHexBody
+		FilePath,  //A file"..." byte literal naming a file to embed
+		LBrace,
+		RBrace,
+		LBracket,
+		RBracket,
+		LParen,
+		RParen,
+		LAngle,
+		RAngle,
+		Equals,
+		Semicolon,
+		Comma,
+		End
+	};
+
+	struct Token {
+		TokenType type;
+		std::string text;
+		uint32_t line;
+		uint32_t column;
+	};
+
+	/*
+	 * Streaming tokenizer for the Jaguar text format
+	 *
+	 * Input is pulled through a fixed-size buffer, so memory use is bounded by the largest single token (strings are capped at the Jaguar string size limit).
+	 * Byte literals are never materialized; their bodies are decoded straight into a sink.
+	 */
+	class Lexer {
+	  public:
+		Lexer(std::istream& in, std::string sourceName);
+
+		//Look at the next token without consuming it
+		const Token& Peek();
+
+		//Consume the next token
+		Token Next();
+
+		//Consume the next token, failing if it is not of the expected type
+		Token Expect(TokenType type, const char* what);
+
+		//Consume the next token if it is of the given type
+		bool Accept(TokenType type);
+
+		//Decode the body of a byte literal whose HexBytes token was just consumed, returning the number of bytes produced
+		uint64_t ReadHexBody(const std::function<void(const unsigned char*, std::size_t)>& sink);
+
+		//Throw a SyntaxError at a location
+		[[noreturn]] void Fail(const Token& at, const std::string& message) const;
+		[[noreturn]] void Fail(const std::string& message) const;
+
+		//Current location formatted as "source:line:column"
+		std::string Location() const;
+
+	  private:
+		std::istream& in;
+		std::string sourceName;
+		std::vector<char> buffer;
+		std::size_t bufferPos;
+		std::size_t bufferEnd;
+		uint32_t line;
+		uint32_t column;
+		bool hasPeeked;
+		Token peeked;
+
+		int PeekChar();
+		int GetChar();
+		bool Refill();
+		void SkipWhitespaceAndComments();
+		Token LexToken();
+		void LexString(Token& token);
+		void AppendEscape(std::string& out);
+	};
+}
\ No newline at end of file
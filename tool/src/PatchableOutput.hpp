@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+namespace jaguartool {
+	constexpr inline std::size_t patchableBufferSize = 4 * 1024 * 1024;//4 MiB
+
+	/*
+	 * Output buffer that allows already-written bytes to be overwritten
+	 *
+	 * Counts, sizes, and other header fields that are only known after their body has been written are patched in place. Patches that land in the
+	 * still-buffered tail are plain memory writes; only patches into data that was already flushed need the sink to be seekable.
+	 */
+	class PatchableStreambuf : public std::streambuf {
+	  public:
+		PatchableStreambuf(std::ostream& sink) : sink(sink), buffer(patchableBufferSize), flushed(0) {
+			setp(buffer.data(), buffer.data() + buffer.size());
+		}
+
+		//Absolute position of the next byte to be written
+		uint64_t Position() const {
+			return flushed + (pptr() - pbase());
+		}
+
+		//Overwrite previously-written bytes
+		void Patch(uint64_t pos, const unsigned char* bytes, std::size_t count) {
+			if(pos + count > Position()) throw std::runtime_error("Cannot patch bytes that have not been written yet!");
+
+			//Part (or all) of the patch may already have been flushed
+			if(pos < flushed) {
+				std::size_t flushedPart = std::min<uint64_t>(count, flushed - pos);
+				const std::streampos end = sink.tellp();
+				if(end == std::streampos(-1)) throw std::runtime_error("Output is not seekable and a value grew too large to patch in memory; write to a file instead");
+				sink.seekp(pos);
+				sink.write(reinterpret_cast<const char*>(bytes), flushedPart);
+				sink.seekp(end);
+				if(!sink.good()) throw std::runtime_error("IO error while patching output!");
+				pos += flushedPart;
+				bytes += flushedPart;
+				count -= flushedPart;
+			}
+
+			//The rest is still in the buffer
+			if(count > 0) std::memcpy(pbase() + (pos - flushed), bytes, count);
+		}
+
+	  protected:
+		int overflow(int c) override {
+			if(!FlushBuffer()) return traits_type::eof();
+			if(c != traits_type::eof()) {
+				*pptr() = static_cast<char>(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+
+		std::streamsize xsputn(const char* data, std::streamsize count) override {
+			std::streamsize written = 0;
+			while(written < count) {
+				if(pptr() == epptr() && !FlushBuffer()) break;
+				std::streamsize chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+				std::memcpy(pptr(), data + written, chunk);
+				pbump(static_cast<int>(chunk));
+				written += chunk;
+			}
+			return written;
+		}
+
+		int sync() override {
+			if(!FlushBuffer()) return -1;
+			sink.flush();
+			return sink.good() ? 0 : -1;
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			//Only position queries are supported; patching goes through Patch
+			if(off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out)) return pos_type(off_type(-1));
+			return pos_type(static_cast<off_type>(Position()));
+		}
+
+	  private:
+		std::ostream& sink;
+		std::vector<char> buffer;
+		uint64_t flushed;
+
+		bool FlushBuffer() {
+			const std::ptrdiff_t pending = pptr() - pbase();
+			if(pending > 0) {
+				sink.write(pbase(), pending);
+				if(!sink.good()) return false;
+				flushed += pending;
+			}
+			setp(buffer.data(), buffer.data() + buffer.size());
+			return true;
+		}
+	};
+
+	class PatchableOstream : public std::ostream {
+	  public:
+		PatchableOstream(std::ostream& sink) : std::ostream(nullptr), buf(sink) {
+			init(&buf);
+		}
+
+		PatchableOstream(std::unique_ptr<std::ostream>&& ownedSink) : std::ostream(nullptr), owned(std::move(ownedSink)), buf(*owned) {
+			init(&buf);
+		}
+
+		uint64_t Position() const {
+			return buf.Position();
+		}
+
+		//Overwrite a previously-written little-endian integer
+		void PatchInteger(uint64_t pos, uint64_t value, uint8_t bytes) {
+			unsigned char encoded[8];
+			for(uint8_t i = 0; i < bytes; ++i) encoded[i] = static_cast<unsigned char>((value >> (i * 8)) & 0xFF);
+			buf.Patch(pos, encoded, bytes);
+		}
+
+	  private:
+		std::unique_ptr<std::ostream> owned;
+		PatchableStreambuf buf;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "libjaguar/TypeTags.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace jaguartool {
+	//Deepest nesting of objects and lists the format allows
+	constexpr inline uint8_t maxNestingDepth = 64;
+
+	//Keywords naming the types that need no further parameters
+	struct ScalarKeyword {
+		std::string_view keyword;
+		libjaguar::TypeTag type;
+	};
+
+	inline constexpr std::array<ScalarKeyword, 14> scalarKeywords = {{{"string", libjaguar::TypeTag::String},
+		{"bytes", libjaguar::TypeTag::ByteBuffer},
+		{"substream", libjaguar::TypeTag::Substream},
+		{"bool", libjaguar::TypeTag::Boolean},
+		{"f32", libjaguar::TypeTag::Float32},
+		{"f64", libjaguar::TypeTag::Float64},
+		{"i8", libjaguar::TypeTag::SInt8},
+		{"i16", libjaguar::TypeTag::SInt16},
+		{"i32", libjaguar::TypeTag::SInt32},
+		{"i64", libjaguar::TypeTag::SInt64},
+		{"u8", libjaguar::TypeTag::UInt8},
+		{"u16", libjaguar::TypeTag::UInt16},
+		{"u32", libjaguar::TypeTag::UInt32},
+		{"u64", libjaguar::TypeTag::UInt64}}};
+
+	inline std::optional<libjaguar::TypeTag> LookupScalarKeyword(std::string_view keyword) {
+		for(const ScalarKeyword& entry : scalarKeywords) {
+			if(entry.keyword == keyword) return entry.type;
+		}
+		return std::nullopt;
+	}
+
+	inline std::string_view ScalarKeywordOf(libjaguar::TypeTag type) {
+		for(const ScalarKeyword& entry : scalarKeywords) {
+			if(entry.type == type) return entry.keyword;
+		}
+		return {};
+	}
+
+	//Check if a type can be used as the element type of a vector or matrix
+	inline bool IsMathElementType(libjaguar::TypeTag type) {
+		const libjaguar::TypeCategory category = libjaguar::GetTypeTagInfo(type).category;
+		return category == libjaguar::TypeCategory::SignedInteger || category == libjaguar::TypeCategory::UnsignedInteger || category == libjaguar::TypeCategory::FloatingPoint;
+	}
+
+	//Check if a name can be written without quotes
+	inline bool IsBareName(std::string_view name) {
+		if(name.empty() || !(std::isalpha(static_cast<unsigned char>(name[0])) || name[0] == '_')) return false;
+		for(char c : name) {
+			if(!(std::isalnum(static_cast<unsigned char>(c)) || c == '_')) return false;
+		}
+		return true;
+	}
+
+	//Quote and escape a string so that the lexer reads back the same bytes
+	inline std::string QuoteString(std::string_view text) {
+		static constexpr char hexDigits[] = "0123456789ABCDEF";
+		std::string quoted;
+		quoted.reserve(text.size() + 2);
+		quoted.push_back('"');
+		for(char c : text) {
+			switch(c) {
+				case '"': quoted += "\\\""; break;
+				case '\\': quoted += "\\\\"; break;
+				case '\n': quoted += "\\n"; break;
+				case '\t': quoted += "\\t"; break;
+				case '\r': quoted += "\\r"; break;
+				default:
+					if(static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+						quoted += "\\x";
+						quoted.push_back(hexDigits[(static_cast<unsigned char>(c) >> 4) & 0xF]);
+						quoted.push_back(hexDigits[static_cast<unsigned char>(c) & 0xF]);
+					} else {
+						quoted.push_back(c);
+					}
+					break;
+			}
+		}
+		quoted.push_back('"');
+		return quoted;
+	}
+
+	//Format a value name or type ID, quoting it only if needed
+	inline std::string FormatName(std::string_view name) {
+		return IsBareName(name) ? std::string(name) : QuoteString(name);
+	}
+
+	/*
+	 * Full description of a type as written in the text format:
+	 *   string, bytes, substream, bool, f32, f64, i8-i64, u8-u64
+	 *   vec2<f32> through vec4<...>
+	 *   mat2x2<f32> through mat4x4<...> (columns x rows)
+	 *   list<element type>
+	 *   object (unstructured) or object<TypeID> (structured)
+	 */
+	struct TypeSpec {
+		libjaguar::TypeTag type;
+		libjaguar::TypeTag elementType;	 //Number type of a vector or matrix, or the element type of a list
+		uint8_t width;					 //Vector component count or matrix column count
+		uint8_t height;					 //Matrix row count
+		std::string typeID;				 //Structured object type ID (empty for unstructured objects)
+		std::unique_ptr<TypeSpec> element;//Element description of a list
+	};
+}
\ No newline at end of file
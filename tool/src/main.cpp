@@ -0,0 +1,51 @@
+#include "Commands.hpp"
+
+#include <iostream>
+#include <string_view>
+
+namespace {
+	struct Command {
+		std::string_view name;
+		std::string_view description;
+		int (*run)(const std::vector<std::string>&);
+	};
+
+	constexpr Command commands[] = {
+		{"compile", "Compile Jaguar text files into Jaguar streams", jaguartool::RunCompile},
+		{"dump", "Render a Jaguar stream as Jaguar text", jaguartool::RunDump},
+		{"from-json", "Convert JSON into a Jaguar stream", jaguartool::RunFromJson},
+		{"to-json", "Convert a Jaguar stream into JSON", jaguartool::RunToJson}};
+
+	void PrintUsage() {
+		std::cerr << "Usage: jaguartool <command> [arguments]\n\nCommands:\n";
+		for(const Command& command : commands) std::cerr << "  " << command.name << "\t" << command.description << "\n";
+		std::cerr << "\nRun 'jaguartool <command> --help' for details on a command.\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	if(argc < 2) {
+		PrintUsage();
+		return 2;
+	}
+
+	//Commands stream large amounts of data through the standard streams
+	std::ios::sync_with_stdio(false);
+
+	//Find and run the command
+	std::string_view name = argv[1];
+	for(const Command& command : commands) {
+		if(command.name != name) continue;
+		std::vector<std::string> args(argv + 2, argv + argc);
+		try {
+			return command.run(args);
+		} catch(const std::exception& e) {
+			std::cerr << "error: " << e.what() << "\n";
+			return 1;
+		}
+	}
+
+	if(name != "-h" && name != "--help") std::cerr << "Unknown command '" << name << "'\n\n";
+	PrintUsage();
+	return 2;
+}
\ No newline at end of file